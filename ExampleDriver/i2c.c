@@ -6,60 +6,95 @@
  *
  *  This is an embedded linux I2C wrapper
  */
+#include <errno.h>
 #include "i2c.h"
 
-static int file;
+/**
+ * the kernel side transfer timeout in units of 10ms
+ */
+#define I2C_ADAPTER_TIMEOUT 10
+
+static int file = -1;
 
 static uint8_t SlaveAddress;
 
+/**
+ * the errno of the last failed operation. 0 if there wasn't one
+ */
+static int LastError;
+
+
+static void Close(void) {
+	if(file >= 0) {
+		close(file);
+		file = -1;
+	}
+}
 
 static void Open(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
 	  char filename[20];
 
 	  SlaveAddress = slaveAddress;
 
+	  Close();
+
 	  snprintf(filename, 19, "/dev/i2c-%d", i2cPortNumber);
 
 	  file = open(filename, O_RDWR);
 	  if (file < 0) {
-	    /* ERROR HANDLING; you can check error to see what went wrong */
-	    exit(1);
+	    // leave the interface closed. Writes will report the error
+	    LastError = errno;
+	    return;
 	  }
 
 	  if (ioctl(file, I2C_SLAVE, SlaveAddress) < 0) {
-	    /* ERROR HANDLING; you can check error to see what went wrong */
-	    exit(1);
+	    LastError = errno;
+	    Close();
+	    return;
 	  }
-}
 
-static void Close(void) {
-	if(file) {
-		close(file);
-	}
+	  // bound how long the adapter may hold a transfer. Not all adapters support this
+	  ioctl(file, I2C_TIMEOUT, I2C_ADAPTER_TIMEOUT);
+
+	  LastError = 0;
 }
 
+static int32_t TryWrite(uint8_t * source, uint32_t length) {
+	ssize_t Written;
 
-static void Write(uint8_t * source, uint32_t length) {
-	if(!file || !source) {
+	if(!source) {
+		return -EINVAL;
+	}
+
+	if(file < 0) {
 		// invalid file
-		return;
+		return LastError ? -LastError : -ENODEV;
 	}
 
-	if (write(file, source, length) != length) {
-	/* ERROR HANDLING: i2c transaction failed */
+	Written = write(file, source, length);
+
+	if (Written < 0) {
+		LastError = errno;
+		return -LastError;
 	}
+
+	return (int32_t)Written;
+}
+
+static void Write(uint8_t * source, uint32_t length) {
+	TryWrite(source, length);
 }
 
 static void Read(uint8_t * destination, uint32_t length) {
-	if(!file) {
+	if(file < 0 || !destination) {
 		// invalid file
 		return;
 	}
 
 	/* Using I2C Read, equivalent of i2c_smbus_read_byte(file) */
 	if (read(file, destination, length) != length) {
-	/* ERROR HANDLING: i2c transaction failed */
-	return;
+		LastError = errno;
+		return;
 	}
 }
 
@@ -67,4 +102,4 @@ static void Read(uint8_t * destination, uint32_t length) {
 /**
  * this is the I2C interface instance
  */
-I2CInterface I2C0 = {Open, Close, Write, Read };
+I2CInterface I2C0 = {Open, Close, Write, Read, TryWrite };
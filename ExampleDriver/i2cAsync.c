@@ -0,0 +1,622 @@
+/*
+ * i2cAsync.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Non blocking I2C transport.
+ *
+ *  Transfers are copied into a bounded lock free ring (a Vyukov style sequence ring, so any
+ *  number of threads can submit) and a single worker thread writes them to the target interface.
+ *  A failed write is retried with a growing back off until the retry count or the timeout runs
+ *  out, and the outcome is reported through the transfer's callback.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "i2cAsync.h"
+
+/**
+ * the ring index mask
+ */
+#define QUEUE_MASK (I2C_ASYNC_QUEUE_SIZE - 1)
+
+/**
+ * macro for setting the D/C# portion of the to data type
+ */
+#define SET_DC_TO_DATA 0x40
+
+/**
+ * macro for setting the D/C# portion of the to command type
+ */
+#define SET_DC_TO_COMMAND 0X00
+
+/**
+ * the continuation bit Co of the control byte
+ */
+#define SET_CONTINUATION_BIT 0x80
+
+/**
+ * the set column address command, which starts the window commands sent ahead of display data
+ */
+#define CMD_SET_COLUMN_ADDRESS 0x21
+
+/**
+ * the longest command transfer kept to set the window again, control byte included
+ */
+#define WINDOW_COMMAND_SIZE 16
+
+/**
+ * defines a ring slot
+ */
+typedef struct {
+	atomic_size_t Sequence;		///< the slot's turn. See Submit and the worker
+	uint32_t Length;			///< bytes used in Storage
+	uint32_t CommandLength;		///< leading bytes of Storage that are a window command sent ahead of the rest, 0 if none
+	I2CAsyncCallbackType Callback;
+	void * Context;
+	uint8_t Storage[I2C_ASYNC_MAX_TRANSFER];
+} QueueSlotType;
+
+/**
+ * the transfer ring
+ */
+static QueueSlotType Queue[I2C_ASYNC_QUEUE_SIZE];
+
+/**
+ * the next position to submit to
+ */
+static atomic_size_t SubmitPosition;
+
+/**
+ * the next position the worker takes. Only the worker touches this
+ */
+static size_t TakePosition;
+
+/**
+ * the number of transfers that are queued or in progress
+ */
+static atomic_uint Outstanding;
+
+/**
+ * counts the queued transfers so the worker can sleep while the ring is empty
+ */
+static sem_t Pending;
+
+/**
+ * the worker thread
+ */
+static pthread_t Worker;
+
+/**
+ * true while the worker should keep running
+ */
+static atomic_bool Running;
+
+/**
+ * true while transfers are taken. Stop clears it and then waits for the submitters that are
+ * already past the check to leave
+ */
+static atomic_bool Accepting;
+static atomic_uint Submitters;
+
+/**
+ * the interface the transfers are written to
+ */
+static I2CInterface * Target;
+
+/**
+ * the worker configuration
+ */
+static I2CAsyncConfigType Config;
+
+/**
+ * the last window command the worker wrote, sent again before a failed data transfer is retried.
+ * Only the worker touches this
+ */
+static uint8_t LastCommand[WINDOW_COMMAND_SIZE];
+static uint32_t LastCommandLength;
+
+/**
+ * the window command I2CAsyncInterface is holding back until its data arrives
+ */
+static uint8_t HeldCommand[WINDOW_COMMAND_SIZE];
+static uint32_t HeldCommandLength;
+
+/**
+ * the transport counters
+ */
+static atomic_uint Submitted;
+static atomic_uint Rejected;
+static atomic_uint Completed;
+static atomic_uint Failed;
+static atomic_uint Retries;
+static atomic_int LastError;
+
+/**
+ * @return the monotonic time in milliseconds
+ */
+static uint64_t GetMilliseconds(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000u) + ((uint64_t)Now.tv_nsec / 1000000u);
+}
+
+/**
+ * sleeps for the given number of milliseconds
+ */
+static void SleepMilliseconds(uint32_t milliseconds) {
+	struct timespec Delay;
+
+	Delay.tv_sec = milliseconds / 1000u;
+	Delay.tv_nsec = (long)(milliseconds % 1000u) * 1000000L;
+
+	while(nanosleep(&Delay, &Delay) == -1 && errno == EINTR) {
+	}
+}
+
+/**
+ * writes a single transaction
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t WriteOnce(uint8_t * buffer, uint32_t length) {
+	int32_t Result;
+
+	if(Target->TryWrite) {
+		Result = Target->TryWrite(buffer, length);
+	} else {
+		// the target can't tell us, so assume that it worked
+		Target->Write(buffer, length);
+		Result = (int32_t)length;
+	}
+
+	if(Result == (int32_t)length) {
+		return 0;
+	}
+
+	// a short write is a failed transaction
+	return Result < 0 ? Result : -EIO;
+}
+
+/**
+ * writes a queued transfer, retrying until it goes through or we run out of retries or time.
+ * A data transfer that failed part way has moved the controller on through its window, so the
+ * window command goes out again before each retry
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t WriteTransfer(QueueSlotType * slot) {
+	uint64_t Deadline = GetMilliseconds() + Config.TimeoutMilliseconds;
+	uint8_t * Data = &slot->Storage[slot->CommandLength];
+	uint32_t DataLength = slot->Length - slot->CommandLength;
+	uint_fast8_t IsData = (Data[0] & SET_DC_TO_DATA) && !(Data[0] & SET_CONTINUATION_BIT);
+	uint32_t Attempt = 0;
+	uint32_t Backoff = 1;
+	int32_t Result;
+	uint64_t Now;
+
+	for(;;) {
+		Result = 0;
+
+		if(slot->CommandLength) {
+			Result = WriteOnce(&slot->Storage[0], slot->CommandLength);
+		} else if(Attempt && IsData && LastCommandLength) {
+			Result = WriteOnce(&LastCommand[0], LastCommandLength);
+		}
+
+		if(!Result) {
+			Result = WriteOnce(Data, DataLength);
+		}
+
+		if(!Result) {
+			if(slot->CommandLength) {
+				memcpy(&LastCommand[0], &slot->Storage[0], slot->CommandLength);
+				LastCommandLength = slot->CommandLength;
+			} else if(Data[0] == SET_DC_TO_COMMAND && DataLength > 1 && Data[1] == CMD_SET_COLUMN_ADDRESS) {
+				LastCommandLength = DataLength <= sizeof(LastCommand) ? DataLength : 0;
+				memcpy(&LastCommand[0], Data, LastCommandLength);
+			}
+
+			return 0;
+		}
+
+		Now = GetMilliseconds();
+
+		if(Attempt >= Config.Retries) {
+			return Result;
+		}
+
+		if(Now >= Deadline) {
+			return -ETIMEDOUT;
+		}
+
+		if(Backoff > (Deadline - Now)) {
+			Backoff = (uint32_t)(Deadline - Now);
+		}
+
+		SleepMilliseconds(Backoff);
+		Backoff <<= 1;
+
+		Attempt++;
+		atomic_fetch_add(&Retries, 1);
+	}
+}
+
+/**
+ * the worker thread. Drains the ring into the target interface
+ */
+static void * WorkerThread(void * argument) {
+	QueueSlotType * Slot;
+	I2CAsyncCallbackType Callback;
+	int32_t Status;
+
+	(void)argument;
+
+	for(;;) {
+		while(sem_wait(&Pending) == -1 && errno == EINTR) {
+		}
+
+		Slot = &Queue[TakePosition & QUEUE_MASK];
+
+		// every post is for a published slot, but a later one can be published before the head.
+		// Its submitter is about to publish it, so wait for it rather than lose the wake up
+		while(atomic_load_explicit(&Slot->Sequence, memory_order_acquire) != (TakePosition + 1) && atomic_load(&Running)) {
+			sched_yield();
+		}
+
+		if(atomic_load_explicit(&Slot->Sequence, memory_order_acquire) != (TakePosition + 1)) {
+			// woken up without work, we are being stopped
+			break;
+		}
+
+		Status = WriteTransfer(Slot);
+
+		if(Status) {
+			atomic_fetch_add(&Failed, 1);
+			atomic_store(&LastError, Status);
+		} else {
+			atomic_fetch_add(&Completed, 1);
+		}
+
+		Callback = Slot->Callback;
+		if(!Callback && Status) {
+			Callback = Config.ErrorCallback;
+		}
+
+		if(Callback) {
+			Callback(Status, Slot->Context);
+		}
+
+		// hand the slot back to the submitters
+		atomic_store_explicit(&Slot->Sequence, TakePosition + I2C_ASYNC_QUEUE_SIZE, memory_order_release);
+		TakePosition++;
+
+		atomic_fetch_sub(&Outstanding, 1);
+	}
+
+	return NULL;
+}
+
+/**
+ * claims a slot and publishes the transfer to the worker. See Enqueue
+ */
+static int32_t EnqueueSlot(const uint8_t * command, uint32_t commandLength, const I2CAsyncTransferType * transfer) {
+	QueueSlotType * Slot;
+	size_t Position;
+	size_t Sequence;
+	intptr_t Difference;
+	uint32_t Prefix;
+
+	// the worker reads the first byte of the transfer to tell data from commands
+	if(!transfer || !transfer->Buffer || !transfer->Length) {
+		return -EINVAL;
+	}
+
+	Prefix = commandLength + ((transfer->Kind == I2CAsync_Raw) ? 0 : 1);
+
+	if((transfer->Length + Prefix) > I2C_ASYNC_MAX_TRANSFER) {
+		atomic_fetch_add(&Rejected, 1);
+		return -EMSGSIZE;
+	}
+
+	// claim a free slot
+	Position = atomic_load_explicit(&SubmitPosition, memory_order_relaxed);
+	for(;;) {
+		Slot = &Queue[Position & QUEUE_MASK];
+		Sequence = atomic_load_explicit(&Slot->Sequence, memory_order_acquire);
+		Difference = (intptr_t)Sequence - (intptr_t)Position;
+
+		if(!Difference) {
+			if(atomic_compare_exchange_weak_explicit(&SubmitPosition, &Position, Position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if(Difference < 0) {
+			atomic_fetch_add(&Rejected, 1);
+			return -EAGAIN;
+		} else {
+			Position = atomic_load_explicit(&SubmitPosition, memory_order_relaxed);
+		}
+	}
+
+	if(commandLength) {
+		memcpy(&Slot->Storage[0], command, commandLength);
+	}
+
+	if(Prefix > commandLength) {
+		Slot->Storage[commandLength] = (transfer->Kind == I2CAsync_Data) ? SET_DC_TO_DATA : SET_DC_TO_COMMAND;
+	}
+
+	memcpy(&Slot->Storage[Prefix], transfer->Buffer, transfer->Length);
+	Slot->Length = transfer->Length + Prefix;
+	Slot->CommandLength = commandLength;
+	Slot->Callback = transfer->Callback;
+	Slot->Context = transfer->Context;
+
+	atomic_fetch_add(&Outstanding, 1);
+	atomic_fetch_add(&Submitted, 1);
+
+	// publish the slot to the worker
+	atomic_store_explicit(&Slot->Sequence, Position + 1, memory_order_release);
+	sem_post(&Pending);
+
+	return 0;
+}
+
+/**
+ * queues a transfer, optionally with a window command that goes out ahead of it in the same slot
+ * so that they are queued or refused together
+ *
+ * @return 0 if the transfer was queued, -EAGAIN if the queue is full, -EMSGSIZE if it is too long
+ * or -EINVAL if it is empty or we are stopped
+ */
+static int32_t Enqueue(const uint8_t * command, uint32_t commandLength, const I2CAsyncTransferType * transfer) {
+	int32_t Result = -EINVAL;
+
+	// counted before Accepting is checked, so Stop either sees us or we see it stopping
+	atomic_fetch_add(&Submitters, 1);
+
+	if(atomic_load(&Accepting)) {
+		Result = EnqueueSlot(command, commandLength, transfer);
+	}
+
+	atomic_fetch_sub(&Submitters, 1);
+
+	return Result;
+}
+
+/**
+ * Queues a transfer. This never blocks.
+ *
+ * @return 0 if the transfer was queued, -EAGAIN if the queue is full, -EMSGSIZE if it is too long
+ */
+static int32_t Submit(const I2CAsyncTransferType * transfer) {
+	return Enqueue(NULL, 0, transfer);
+}
+
+/**
+ * Waits for all queued transfers to finish.
+ *
+ * @return 0 once the queue is empty or -ETIMEDOUT
+ */
+static int32_t WaitIdle(uint32_t timeoutMilliseconds) {
+	uint64_t Deadline = GetMilliseconds() + timeoutMilliseconds;
+
+	while(atomic_load(&Outstanding)) {
+		if(GetMilliseconds() >= Deadline) {
+			return -ETIMEDOUT;
+		}
+		SleepMilliseconds(1);
+	}
+
+	return 0;
+}
+
+/**
+ * Stops the worker once the queued transfers have been written
+ */
+static void Stop(void) {
+	if(!atomic_load(&Running)) {
+		return;
+	}
+
+	// let the submitters that got in finish publishing before the queue is drained
+	atomic_store(&Accepting, false);
+	while(atomic_load(&Submitters)) {
+		sched_yield();
+	}
+
+	WaitIdle(Config.TimeoutMilliseconds * I2C_ASYNC_QUEUE_SIZE);
+
+	atomic_store(&Running, false);
+	sem_post(&Pending);
+	pthread_join(Worker, NULL);
+	sem_destroy(&Pending);
+}
+
+/**
+ * Starts the worker thread.
+ *
+ * @param target the interface the transfers are written to. It must already be open
+ * @param config retry and timeout settings
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t Start(I2CInterface * target, const I2CAsyncConfigType * config) {
+	uint32_t Index;
+	int Result;
+
+	if(!target || !config || (!target->TryWrite && !target->Write)) {
+		return -EINVAL;
+	}
+
+	Stop();
+
+	Target = target;
+	Config = *config;
+
+	for(Index = 0; Index < I2C_ASYNC_QUEUE_SIZE; Index++) {
+		atomic_store(&Queue[Index].Sequence, Index);
+	}
+
+	atomic_store(&SubmitPosition, 0);
+	TakePosition = 0;
+	atomic_store(&Outstanding, 0);
+	atomic_store(&Submitted, 0);
+	atomic_store(&Rejected, 0);
+	atomic_store(&Completed, 0);
+	atomic_store(&Failed, 0);
+	atomic_store(&Retries, 0);
+	atomic_store(&LastError, 0);
+	LastCommandLength = 0;
+	HeldCommandLength = 0;
+
+	if(sem_init(&Pending, 0, 0)) {
+		return -errno;
+	}
+
+	atomic_store(&Running, true);
+
+	Result = pthread_create(&Worker, NULL, WorkerThread, NULL);
+	if(Result) {
+		atomic_store(&Running, false);
+		sem_destroy(&Pending);
+		return -Result;
+	}
+
+	atomic_store(&Accepting, true);
+
+	return 0;
+}
+
+/**
+ * returns a snapshot of the transport counters
+ */
+static void GetStatistics(I2CAsyncStatisticsType * statistics) {
+	if(!statistics) {
+		return;
+	}
+
+	statistics->Submitted = atomic_load(&Submitted);
+	statistics->Rejected = atomic_load(&Rejected);
+	statistics->Completed = atomic_load(&Completed);
+	statistics->Failed = atomic_load(&Failed);
+	statistics->Retries = atomic_load(&Retries);
+	statistics->LastError = atomic_load(&LastError);
+}
+
+/**
+ * This is our asynchronous transport instance
+ */
+I2CAsyncType I2CAsync = {
+	Start: Start,
+	Stop: Stop,
+	Submit: Submit,
+	WaitIdle: WaitIdle,
+	GetStatistics: GetStatistics
+};
+
+static void InterfaceOpen(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
+	if(Target && Target->Open) {
+		Target->Open(i2cPortNumber, slaveAddress);
+	}
+}
+
+/**
+ * queues a transfer written to I2CAsyncInterface, reporting a failure to the error callback
+ */
+static int32_t InterfaceSubmit(const uint8_t * command, uint32_t commandLength, uint8_t * source, uint32_t length) {
+	I2CAsyncTransferType Transfer = {
+		Kind: I2CAsync_Raw,
+		Buffer: source,
+		Length: length,
+		Callback: NULL,
+		Context: NULL
+	};
+	int32_t Result = Enqueue(command, commandLength, &Transfer);
+
+	if(Result && Config.ErrorCallback) {
+		Config.ErrorCallback(Result, NULL);
+	}
+
+	return Result;
+}
+
+/**
+ * queues a held window command on its own
+ */
+static void InterfaceFlushHeld(void) {
+	uint32_t Length = HeldCommandLength;
+
+	if(Length) {
+		HeldCommandLength = 0;
+		InterfaceSubmit(NULL, 0, &HeldCommand[0], Length);
+	}
+}
+
+static void InterfaceClose(void) {
+	InterfaceFlushHeld();
+	Stop();
+
+	if(Target && Target->Close) {
+		Target->Close();
+	}
+}
+
+/**
+ * A window command is held back and queued in the same slot as the data that follows it, so a
+ * full queue refuses both rather than letting the data land in the wrong window
+ */
+static int32_t InterfaceTryWrite(uint8_t * source, uint32_t length) {
+	int32_t Result;
+
+	if(!source || !length) {
+		return -EINVAL;
+	}
+
+	if(source[0] == SET_DC_TO_COMMAND && length > 1 && source[1] == CMD_SET_COLUMN_ADDRESS && length <= sizeof(HeldCommand)) {
+		InterfaceFlushHeld();
+
+		memcpy(&HeldCommand[0], source, length);
+		HeldCommandLength = length;
+
+		return (int32_t)length;
+	}
+
+	if(source[0] == SET_DC_TO_DATA && HeldCommandLength) {
+		Result = InterfaceSubmit(&HeldCommand[0], HeldCommandLength, source, length);
+		HeldCommandLength = 0;
+	} else {
+		InterfaceFlushHeld();
+		Result = InterfaceSubmit(NULL, 0, source, length);
+	}
+
+	return Result ? Result : (int32_t)length;
+}
+
+static void InterfaceWrite(uint8_t * source, uint32_t length) {
+	InterfaceTryWrite(source, length);
+}
+
+static void InterfaceRead(uint8_t * destination, uint32_t length) {
+	InterfaceFlushHeld();
+
+	// reads have to wait for the bus anyway, so let the queue drain first
+	WaitIdle(Config.TimeoutMilliseconds * I2C_ASYNC_QUEUE_SIZE);
+
+	if(Target && Target->Read) {
+		Target->Read(destination, length);
+	}
+}
+
+/**
+ * this is the queued I2C interface instance
+ */
+I2CInterface I2CAsyncInterface = {InterfaceOpen, InterfaceClose, InterfaceWrite, InterfaceRead, InterfaceTryWrite };
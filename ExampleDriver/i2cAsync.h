@@ -0,0 +1,93 @@
+/*
+ * i2cAsync.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __I2C_ASYNC_H__
+#define __I2C_ASYNC_H__
+
+	#include "i2cInterface.h"
+
+	/**
+	 * defines how many transfers can be queued. Must be a power of 2
+	 */
+	#define I2C_ASYNC_QUEUE_SIZE 16
+
+	/**
+	 * defines the largest transfer that can be queued, control byte included.
+	 * This fits a full 128x64 frame.
+	 */
+	#define I2C_ASYNC_MAX_TRANSFER 1040
+
+	/**
+	 * defines what the transfer buffer holds
+	 */
+	typedef enum {
+		I2CAsync_Raw = 0,	///< the buffer is sent as is. It already starts with the control byte
+		I2CAsync_Command,	///< the buffer holds commands. The command control byte is added
+		I2CAsync_Data		///< the buffer holds display data. The data control byte is added
+	} I2CAsyncTransferKind;
+
+	/**
+	 * defines the transfer completion callback.
+	 *
+	 * @param status 0 on success else a negative errno
+	 * @param context the context given with the transfer
+	 */
+	typedef void (*I2CAsyncCallbackType)(int32_t status, void * context);
+
+	/**
+	 * defines a transfer descriptor. The buffer is copied when the transfer is queued
+	 */
+	typedef struct I2CAsyncTransferType {
+		I2CAsyncTransferKind Kind;
+		const uint8_t * Buffer;
+		uint32_t Length;
+		I2CAsyncCallbackType Callback;	///< called from the worker thread once the transfer is done. Can be NULL
+		void * Context;
+	} I2CAsyncTransferType;
+
+	/**
+	 * defines the worker configuration
+	 */
+	typedef struct I2CAsyncConfigType {
+		uint32_t Retries;					///< how many times a failed transfer is retried
+		uint32_t TimeoutMilliseconds;		///< a transfer is given up after this long, retries included
+		I2CAsyncCallbackType ErrorCallback;	///< called for failed transfers that have no callback of their own
+	} I2CAsyncConfigType;
+
+	/**
+	 * defines the transport counters
+	 */
+	typedef struct I2CAsyncStatisticsType {
+		uint32_t Submitted;		///< transfers accepted into the queue
+		uint32_t Rejected;		///< transfers refused because the queue was full or they were too long
+		uint32_t Completed;		///< transfers that were written successfully
+		uint32_t Failed;		///< transfers that failed after all retries
+		uint32_t Retries;		///< total retries
+		int32_t LastError;		///< the status of the last failed transfer
+	} I2CAsyncStatisticsType;
+
+	/**
+	 * defines the asynchronous transport interface
+	 */
+	typedef struct I2CAsyncType {
+		int32_t (*Start)(I2CInterface * target, const I2CAsyncConfigType * config);
+		void (*Stop)(void);
+		int32_t (*Submit)(const I2CAsyncTransferType * transfer);
+		int32_t (*WaitIdle)(uint32_t timeoutMilliseconds);
+		void (*GetStatistics)(I2CAsyncStatisticsType * statistics);
+	} I2CAsyncType;
+
+	extern I2CAsyncType I2CAsync;
+
+	/**
+	 * An I2C interface whose writes are queued on I2CAsync. Pass this to the display driver so
+	 * that Sync never blocks on the bus. Open and Close are forwarded to the target interface.
+	 * A window command is queued together with the display data written after it.
+	 */
+	extern I2CInterface I2CAsyncInterface;
+
+#endif /* __I2C_ASYNC_H__ */
@@ -0,0 +1,447 @@
+/*
+ * i2cBus.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Shares one embedded linux I2C adapter between several devices.
+ *
+ *  Each device gets a port (an I2CInterface). A Write on a port blocks its caller, but the
+ *  transfer is sent in chunks and between chunks the bus is handed to whichever port the policy
+ *  picks next. A full frame on one display therefore can't starve a small update on another.
+ *  There is no bus thread; the caller that finds the bus free sends the next chunk on behalf of
+ *  whichever port is due.
+ *
+ *  Only data transfers (control byte 0x40) are split, and every chunk after the first starts
+ *  with a copy of the control byte so the controller carries on where it stopped. Command
+ *  transfers are always sent whole.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <linux/i2c.h>
+#include "i2c.h"
+#include "i2cBus.h"
+
+/**
+ * the continuation bit Co of the control byte
+ */
+#define CONTROL_CONTINUATION_BIT 0x80
+
+/**
+ * the D/C# bit of the control byte
+ */
+#define CONTROL_DATA_BIT 0x40
+
+/**
+ * defines the state of a single port
+ */
+typedef struct {
+	uint8_t SlaveAddress;
+	uint8_t Priority;
+	uint_fast8_t Opened;
+
+	uint8_t * Source;			///< the transfer in progress
+	uint32_t Length;
+	uint32_t Offset;			///< how much of the transfer has been sent
+	uint_fast8_t Pending;		///< true while the transfer is waiting to be completed
+	int32_t Status;				///< 0 or the negative errno of the failed chunk
+
+	I2CBusPortStatisticsType Statistics;
+} PortType;
+
+/**
+ * the adapter file
+ */
+static int File = -1;
+
+/**
+ * the bus configuration
+ */
+static I2CBusConfigType Config;
+
+/**
+ * the ports
+ */
+static PortType Ports[I2C_BUS_MAX_PORTS];
+
+/**
+ * the last port that was given the bus
+ */
+static uint_fast8_t LastPort;
+
+/**
+ * true while a caller is sending a chunk
+ */
+static uint_fast8_t Busy;
+
+/**
+ * guards all the state above
+ */
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * signalled every time a chunk completes
+ */
+static pthread_cond_t ChunkDone = PTHREAD_COND_INITIALIZER;
+
+/**
+ * the chunk being sent. Only the caller holding Busy uses it
+ */
+static uint8_t Chunk[I2C_BUS_MAX_CHUNK];
+
+/**
+ * @return the monotonic time in nanoseconds
+ */
+static uint64_t GetNanoseconds(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000000000u) + (uint64_t)Now.tv_nsec;
+}
+
+/**
+ * sends or receives a single message
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t Transfer(uint8_t slaveAddress, uint8_t * buffer, uint32_t length, uint16_t flags) {
+	struct i2c_msg Message;
+	struct i2c_rdwr_ioctl_data Messages;
+
+	if(File < 0) {
+		return -ENODEV;
+	}
+
+	Message.addr = slaveAddress;
+	Message.flags = flags;
+	Message.len = (uint16_t)length;
+	Message.buf = buffer;
+
+	Messages.msgs = &Message;
+	Messages.nmsgs = 1;
+
+	if(ioctl(File, I2C_RDWR, &Messages) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+/**
+ * picks the next port with a pending transfer based on the policy
+ *
+ * @return the port index or I2C_BUS_MAX_PORTS if nothing is waiting
+ */
+static uint_fast8_t PickNextPort(void) {
+	uint_fast8_t Selected = I2C_BUS_MAX_PORTS;
+	uint_fast8_t Count;
+	uint_fast8_t Index;
+
+	// walk the ports in round robin order starting after the last one served
+	for(Count = 1; Count <= I2C_BUS_MAX_PORTS; Count++) {
+		Index = (LastPort + Count) % I2C_BUS_MAX_PORTS;
+
+		if(!Ports[Index].Pending) {
+			continue;
+		}
+
+		if(Config.Policy != I2CBus_Priority) {
+			return Index;
+		}
+
+		if(Selected == I2C_BUS_MAX_PORTS || Ports[Index].Priority > Ports[Selected].Priority) {
+			Selected = Index;
+		}
+	}
+
+	return Selected;
+}
+
+/**
+ * sends the next chunk of the given port's transfer. Called with the lock held and returns with it held
+ */
+static void SendChunk(uint_fast8_t portIndex) {
+	PortType * Port = &Ports[portIndex];
+	uint8_t * Source = Port->Source;
+	uint32_t Length;
+	uint32_t Payload;
+	uint64_t Start;
+	int32_t Result;
+	uint_fast8_t Splittable = (Source[0] & CONTROL_DATA_BIT) && !(Source[0] & CONTROL_CONTINUATION_BIT);
+
+	if(!Splittable || (Port->Length - Port->Offset) <= Config.ChunkSize) {
+		// whole or last part of the transfer
+		Payload = Port->Length - Port->Offset;
+	} else {
+		Payload = Config.ChunkSize - (Port->Offset ? 1 : 0);
+	}
+
+	if(!Port->Offset) {
+		Source = &Port->Source[0];
+		Length = Payload;
+	} else {
+		// the continuation chunks start with a copy of the control byte
+		Chunk[0] = Port->Source[0];
+		memcpy(&Chunk[1], &Port->Source[Port->Offset], Payload);
+		Source = &Chunk[0];
+		Length = Payload + 1;
+	}
+
+	Busy = true;
+	LastPort = portIndex;
+	pthread_mutex_unlock(&Lock);
+
+	Start = GetNanoseconds();
+	Result = Transfer(Port->SlaveAddress, Source, Length, 0);
+
+	pthread_mutex_lock(&Lock);
+	Busy = false;
+
+	Port->Statistics.BusyNanoseconds += GetNanoseconds() - Start;
+	Port->Statistics.Chunks++;
+
+	if(Result) {
+		Port->Statistics.Errors++;
+		Port->Status = Result;
+		Port->Pending = false;
+	} else {
+		Port->Statistics.Bytes += Length;
+		Port->Offset += Payload;
+		if(Port->Offset >= Port->Length) {
+			Port->Pending = false;
+		}
+	}
+
+	pthread_cond_broadcast(&ChunkDone);
+}
+
+/**
+ * writes a transfer on the given port. Blocks until it has been sent
+ *
+ * @return the number of bytes written or a negative errno
+ */
+static int32_t PortTryWrite(uint_fast8_t portIndex, uint8_t * source, uint32_t length) {
+	PortType * Port = &Ports[portIndex];
+	uint_fast8_t Next;
+	uint64_t Start = GetNanoseconds();
+	int32_t Result;
+
+	if(!source || !length) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&Lock);
+
+	if(!Port->Opened || File < 0) {
+		pthread_mutex_unlock(&Lock);
+		return -ENODEV;
+	}
+
+	Port->Source = source;
+	Port->Length = length;
+	Port->Offset = 0;
+	Port->Status = 0;
+	Port->Pending = true;
+	Port->Statistics.Transfers++;
+
+	while(Port->Pending) {
+		if(Busy) {
+			pthread_cond_wait(&ChunkDone, &Lock);
+			continue;
+		}
+
+		Next = PickNextPort();
+		if(Next < I2C_BUS_MAX_PORTS) {
+			SendChunk(Next);
+		}
+	}
+
+	Port->Statistics.WaitNanoseconds += GetNanoseconds() - Start;
+	Result = Port->Status ? Port->Status : (int32_t)length;
+
+	pthread_mutex_unlock(&Lock);
+
+	return Result;
+}
+
+static void PortOpen(uint_fast8_t portIndex, uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
+	(void)i2cPortNumber;
+
+	pthread_mutex_lock(&Lock);
+	Ports[portIndex].SlaveAddress = slaveAddress;
+	Ports[portIndex].Statistics.SlaveAddress = slaveAddress;
+	Ports[portIndex].Opened = true;
+	pthread_mutex_unlock(&Lock);
+}
+
+static void PortClose(uint_fast8_t portIndex) {
+	pthread_mutex_lock(&Lock);
+	Ports[portIndex].Opened = false;
+	pthread_mutex_unlock(&Lock);
+}
+
+static void PortWrite(uint_fast8_t portIndex, uint8_t * source, uint32_t length) {
+	PortTryWrite(portIndex, source, length);
+}
+
+static void PortRead(uint_fast8_t portIndex, uint8_t * destination, uint32_t length) {
+	if(!destination) {
+		return;
+	}
+
+	// reads are short so they are done as a single message once the bus is free
+	pthread_mutex_lock(&Lock);
+	while(Busy) {
+		pthread_cond_wait(&ChunkDone, &Lock);
+	}
+	Busy = true;
+	pthread_mutex_unlock(&Lock);
+
+	Transfer(Ports[portIndex].SlaveAddress, destination, length, I2C_M_RD);
+
+	pthread_mutex_lock(&Lock);
+	Busy = false;
+	pthread_cond_broadcast(&ChunkDone);
+	pthread_mutex_unlock(&Lock);
+}
+
+/**
+ * Opens the adapter that the ports share.
+ *
+ * @param i2cPortNumber the adapter number, /dev/i2c-N
+ * @param config the scheduling policy and chunk size
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t Open(uint_fast8_t i2cPortNumber, const I2CBusConfigType * config) {
+	char Filename[20];
+	int32_t Result = 0;
+
+	if(!config) {
+		return -EINVAL;
+	}
+
+	// a chunk may still be going out on the old descriptor
+	pthread_mutex_lock(&Lock);
+	while(Busy) {
+		pthread_cond_wait(&ChunkDone, &Lock);
+	}
+
+	if(File >= 0) {
+		close(File);
+	}
+
+	Config = *config;
+	if(Config.ChunkSize < 2) {
+		Config.ChunkSize = 2;
+	}
+	if(Config.ChunkSize > I2C_BUS_MAX_CHUNK) {
+		Config.ChunkSize = I2C_BUS_MAX_CHUNK;
+	}
+
+	snprintf(Filename, sizeof(Filename), "/dev/i2c-%d", i2cPortNumber);
+	File = open(Filename, O_RDWR);
+	if(File < 0) {
+		Result = -errno;
+	}
+
+	pthread_mutex_unlock(&Lock);
+
+	return Result;
+}
+
+/**
+ * closes the adapter. The ports stay bound to their addresses
+ */
+static void Close(void) {
+	pthread_mutex_lock(&Lock);
+	while(Busy) {
+		pthread_cond_wait(&ChunkDone, &Lock);
+	}
+
+	if(File >= 0) {
+		close(File);
+		File = -1;
+	}
+	pthread_mutex_unlock(&Lock);
+}
+
+/**
+ * sets the port's priority for the priority policy. Higher goes first
+ */
+static void SetPriority(uint_fast8_t port, uint8_t priority) {
+	if(port >= I2C_BUS_MAX_PORTS) {
+		return;
+	}
+
+	pthread_mutex_lock(&Lock);
+	Ports[port].Priority = priority;
+	pthread_mutex_unlock(&Lock);
+}
+
+/**
+ * returns the port's bus usage and its share of the total bus time
+ */
+static void GetPortStatistics(uint_fast8_t port, I2CBusPortStatisticsType * statistics) {
+	uint64_t TotalBusy = 0;
+	uint_fast8_t Index;
+
+	if(port >= I2C_BUS_MAX_PORTS || !statistics) {
+		return;
+	}
+
+	pthread_mutex_lock(&Lock);
+
+	for(Index = 0; Index < I2C_BUS_MAX_PORTS; Index++) {
+		TotalBusy += Ports[Index].Statistics.BusyNanoseconds;
+	}
+
+	*statistics = Ports[port].Statistics;
+	statistics->BusSharePerMille = TotalBusy ? (uint32_t)((statistics->BusyNanoseconds * 1000u) / TotalBusy) : 0;
+
+	pthread_mutex_unlock(&Lock);
+}
+
+/**
+ * This is our bus manager instance
+ */
+I2CBusType I2CBus = {
+	Open: Open,
+	Close: Close,
+	SetPriority: SetPriority,
+	GetPortStatistics: GetPortStatistics
+};
+
+/**
+ * creates the I2CInterface functions for a port
+ */
+#define I2C_BUS_PORT_FUNCTIONS(n) \
+	static void PortOpen##n(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) { PortOpen(n, i2cPortNumber, slaveAddress); } \
+	static void PortClose##n(void) { PortClose(n); } \
+	static void PortWrite##n(uint8_t * source, uint32_t length) { PortWrite(n, source, length); } \
+	static void PortRead##n(uint8_t * destination, uint32_t length) { PortRead(n, destination, length); } \
+	static int32_t PortTryWrite##n(uint8_t * source, uint32_t length) { return PortTryWrite(n, source, length); }
+
+/**
+ * the I2CInterface initialiser for a port
+ */
+#define I2C_BUS_PORT(n) {PortOpen##n, PortClose##n, PortWrite##n, PortRead##n, PortTryWrite##n }
+
+I2C_BUS_PORT_FUNCTIONS(0)
+I2C_BUS_PORT_FUNCTIONS(1)
+I2C_BUS_PORT_FUNCTIONS(2)
+I2C_BUS_PORT_FUNCTIONS(3)
+
+/**
+ * these are the bus port instances
+ */
+I2CInterface I2CBusPorts[I2C_BUS_MAX_PORTS] = {
+	I2C_BUS_PORT(0),
+	I2C_BUS_PORT(1),
+	I2C_BUS_PORT(2),
+	I2C_BUS_PORT(3)
+};
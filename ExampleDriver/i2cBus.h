@@ -0,0 +1,71 @@
+/*
+ * i2cBus.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __I2C_BUS_H__
+#define __I2C_BUS_H__
+
+	#include "i2cInterface.h"
+
+	/**
+	 * defines how many devices can share the bus
+	 */
+	#define I2C_BUS_MAX_PORTS 4
+
+	/**
+	 * defines the largest chunk that is sent in one go, control byte included
+	 */
+	#define I2C_BUS_MAX_CHUNK 1040
+
+	/**
+	 * defines how the next port to use the bus is picked
+	 */
+	typedef enum {
+		I2CBus_RoundRobin = 0,	///< every waiting port gets a chunk in turn
+		I2CBus_Priority			///< the waiting port with the highest priority goes first. Round robin between equals
+	} I2CBusPolicyType;
+
+	/**
+	 * defines the bus configuration
+	 */
+	typedef struct I2CBusConfigType {
+		I2CBusPolicyType Policy;
+		uint32_t ChunkSize;			///< data transfers are split into chunks of this size, control byte included
+	} I2CBusConfigType;
+
+	/**
+	 * defines the per port bus usage
+	 */
+	typedef struct I2CBusPortStatisticsType {
+		uint8_t SlaveAddress;
+		uint32_t Transfers;			///< Write calls
+		uint32_t Chunks;			///< bus transactions
+		uint32_t Bytes;				///< bytes sent, repeated control bytes included
+		uint32_t Errors;			///< failed transactions
+		uint64_t BusyNanoseconds;	///< time this port held the bus
+		uint64_t WaitNanoseconds;	///< time from Write until the transfer completed
+		uint32_t BusSharePerMille;	///< this port's share of the total bus time in 1/1000
+	} I2CBusPortStatisticsType;
+
+	/**
+	 * defines the bus manager interface
+	 */
+	typedef struct I2CBusType {
+		int32_t (*Open)(uint_fast8_t i2cPortNumber, const I2CBusConfigType * config);
+		void (*Close)(void);
+		void (*SetPriority)(uint_fast8_t port, uint8_t priority);
+		void (*GetPortStatistics)(uint_fast8_t port, I2CBusPortStatisticsType * statistics);
+	} I2CBusType;
+
+	extern I2CBusType I2CBus;
+
+	/**
+	 * The devices on the bus. Each port is an I2C interface whose Open binds it to a slave address.
+	 * Give each display its own port.
+	 */
+	extern I2CInterface I2CBusPorts[I2C_BUS_MAX_PORTS];
+
+#endif /* __I2C_BUS_H__ */
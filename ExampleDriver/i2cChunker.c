@@ -0,0 +1,452 @@
+/*
+ * i2cChunker.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Splits display data transfers into chunks sized for the adapter underneath.
+ *
+ *  Some adapters only take short messages or slow down on long ones, others do best with one
+ *  message per frame. Rather than tuning this by hand, a tuning round sends the real traffic at
+ *  each candidate size in turn, times it and keeps the size with the best throughput. Nothing
+ *  extra goes on the bus to measure it.
+ *
+ *  As with i2cBus.c, only data transfers (control byte 0x40) are split and every chunk after the
+ *  first starts with a copy of the control byte. When a chunk fails the sizes from it up are
+ *  dropped, the last command transfer is sent again to set the controller's window back to its
+ *  start and the whole transfer is sent again in smaller chunks.
+ */
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include "i2cChunker.h"
+
+/**
+ * the continuation bit Co of the control byte
+ */
+#define CONTROL_CONTINUATION_BIT 0x80
+
+/**
+ * the D/C# bit of the control byte
+ */
+#define CONTROL_DATA_BIT 0x40
+
+/**
+ * the longest command transfer kept to be sent again, control byte included
+ */
+#define LAST_COMMAND_SIZE 16
+
+/**
+ * a smaller size is picked over the fastest one when it is within this many percent of it,
+ * as shorter transactions hold the bus for less time
+ */
+#define TOLERANCE_PERCENT 3
+
+/**
+ * the interface the chunks are written to
+ */
+static I2CInterface * Target;
+
+/**
+ * the chunker configuration
+ */
+static I2CChunkerConfigType Config;
+
+/**
+ * the counters and measurements handed out by GetStatistics
+ */
+static I2CChunkerStatisticsType Statistics;
+
+/**
+ * what each size has taken since the tuning round started
+ */
+static uint64_t SizeBytes[I2C_CHUNKER_MAX_SIZES];
+static uint64_t SizeNanoseconds[I2C_CHUNKER_MAX_SIZES];
+
+/**
+ * data transfers measured in this tuning round, and since the last round ended
+ */
+static uint32_t RoundTransfers;
+static uint32_t SinceRound;
+
+/**
+ * the last command transfer, which sets the controller's window before the data
+ */
+static uint8_t LastCommand[LAST_COMMAND_SIZE];
+static uint32_t LastCommandLength;
+
+/**
+ * the chunk being sent
+ */
+static uint8_t Chunk[I2C_CHUNKER_MAX_CHUNK];
+
+/**
+ * @return the monotonic time in nanoseconds
+ */
+static uint64_t GetNanoseconds(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000000000u) + (uint64_t)Now.tv_nsec;
+}
+
+/**
+ * writes a single transaction
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t WriteTransfer(uint8_t * buffer, uint32_t length) {
+	int32_t Result;
+
+	if(Target->TryWrite) {
+		Result = Target->TryWrite(buffer, length);
+	} else {
+		// the target can't tell us, so assume that it worked
+		Target->Write(buffer, length);
+		Result = (int32_t)length;
+	}
+
+	if(Result == (int32_t)length) {
+		return 0;
+	}
+
+	// a short write is a failed transaction
+	return Result < 0 ? Result : -EIO;
+}
+
+/**
+ * sends a data transfer in chunks of the given size
+ *
+ * @param chunks receives the number of transactions used
+ * @return 0 on success else the negative errno of the chunk that failed
+ */
+static int32_t SendChunks(uint8_t * source, uint32_t length, uint32_t size, uint32_t * chunks) {
+	uint32_t Offset = 0;
+	uint32_t Payload;
+	int32_t Result;
+
+	*chunks = 0;
+
+	while(Offset < length) {
+		if(!Offset) {
+			Payload = length < size ? length : size;
+			Result = WriteTransfer(source, Payload);
+		} else {
+			// the continuation chunks start with a copy of the control byte
+			Payload = (length - Offset) < (size - 1) ? (length - Offset) : (size - 1);
+			Chunk[0] = source[0];
+			memcpy(&Chunk[1], &source[Offset], Payload);
+			Result = WriteTransfer(&Chunk[0], Payload + 1);
+		}
+
+		(*chunks)++;
+
+		if(Result) {
+			return Result;
+		}
+
+		Offset += Payload;
+	}
+
+	return 0;
+}
+
+/**
+ * @return the number of sizes, smallest first, that aren't above the ceiling
+ */
+static uint32_t TunableSizes(void) {
+	uint32_t Count = 0;
+
+	while(Count < Statistics.SizeCount && Statistics.Sizes[Count].ChunkSize <= Statistics.Ceiling) {
+		Count++;
+	}
+
+	return Count;
+}
+
+/**
+ * @return the index of a size in the measurements or -1
+ */
+static int32_t FindSize(uint32_t size) {
+	uint32_t Index;
+
+	for(Index = 0; Index < Statistics.SizeCount; Index++) {
+		if(Statistics.Sizes[Index].ChunkSize == size) {
+			return (int32_t)Index;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * clears the measurements and, unless the size is fixed, starts tuning
+ */
+static void StartRound(void) {
+	uint32_t Index;
+
+	for(Index = 0; Index < Statistics.SizeCount; Index++) {
+		Statistics.Sizes[Index].Transfers = 0;
+		Statistics.Sizes[Index].Chunks = 0;
+		Statistics.Sizes[Index].BytesPerSecond = 0;
+		Statistics.Sizes[Index].ChunkMicroseconds = 0;
+		SizeBytes[Index] = 0;
+		SizeNanoseconds[Index] = 0;
+	}
+
+	RoundTransfers = 0;
+	SinceRound = 0;
+	Statistics.Tuning = !Config.ChunkSize;
+}
+
+/**
+ * ends the tuning round with the fastest size
+ */
+static void ChooseSize(void) {
+	uint32_t Count = TunableSizes();
+	uint32_t Best = 0;
+	uint32_t Index;
+
+	for(Index = 0; Index < Count; Index++) {
+		if(Statistics.Sizes[Index].BytesPerSecond > Best) {
+			Best = Statistics.Sizes[Index].BytesPerSecond;
+		}
+	}
+
+	for(Index = 0; Index < Count; Index++) {
+		if((uint64_t)Statistics.Sizes[Index].BytesPerSecond * 100 >= (uint64_t)Best * (100 - TOLERANCE_PERCENT)) {
+			Statistics.ChunkSize = Statistics.Sizes[Index].ChunkSize;
+			break;
+		}
+	}
+
+	Statistics.Tuning = 0;
+	Statistics.Rounds++;
+	SinceRound = 0;
+}
+
+/**
+ * adds a data transfer that went through to the measurements of its size
+ */
+static void Measure(uint32_t size, uint32_t length, uint32_t chunks, uint64_t nanoseconds) {
+	I2CChunkerSizeType * Size;
+	int32_t Index = FindSize(size);
+
+	if(Index >= 0) {
+		Size = &Statistics.Sizes[Index];
+		Size->Transfers++;
+		Size->Chunks += chunks;
+		SizeBytes[Index] += length - 1;
+		SizeNanoseconds[Index] += nanoseconds ? nanoseconds : 1;
+
+		Size->BytesPerSecond = (uint32_t)((SizeBytes[Index] * 1000000000u) / SizeNanoseconds[Index]);
+		Size->ChunkMicroseconds = (uint32_t)(SizeNanoseconds[Index] / 1000u / Size->Chunks);
+	}
+
+	if(Statistics.Tuning) {
+		if(++RoundTransfers >= Config.SamplesPerSize * TunableSizes()) {
+			ChooseSize();
+		}
+	} else if(Config.RetuneTransfers && !Config.ChunkSize && ++SinceRound >= Config.RetuneTransfers) {
+		StartRound();
+	}
+}
+
+/**
+ * drops the sizes from a failed one up
+ */
+static void FallBack(uint32_t size) {
+	uint32_t Ceiling = size / 2;
+
+	if(Ceiling < Config.MinimumChunk) {
+		Ceiling = Config.MinimumChunk;
+	}
+	if(Ceiling < Statistics.Ceiling) {
+		Statistics.Ceiling = Ceiling;
+	}
+	if(Statistics.ChunkSize > Statistics.Ceiling) {
+		Statistics.ChunkSize = Statistics.Ceiling;
+	}
+
+	Statistics.Fallbacks++;
+}
+
+static int32_t TryWrite(uint8_t * source, uint32_t length) {
+	uint64_t Start;
+	uint32_t Size;
+	uint32_t Chunks;
+	int32_t Index;
+	int32_t Result;
+
+	if(!source || !length) {
+		return -EINVAL;
+	}
+
+	if(!Target) {
+		return -ENODEV;
+	}
+
+	if(!(source[0] & CONTROL_DATA_BIT) || (source[0] & CONTROL_CONTINUATION_BIT) || length < 2) {
+		// a command we can't keep may have moved the window, so don't resend an older one
+		if(!source[0] && length <= sizeof(LastCommand)) {
+			memcpy(&LastCommand[0], source, length);
+			LastCommandLength = length;
+		} else {
+			LastCommandLength = 0;
+		}
+
+		Result = WriteTransfer(source, length);
+
+		return Result ? Result : (int32_t)length;
+	}
+
+	for(;;) {
+		if(Statistics.Tuning) {
+			// the candidates take turns so that they all see the same mix of transfers
+			Size = Statistics.Sizes[RoundTransfers % TunableSizes()].ChunkSize;
+		} else {
+			Size = Statistics.ChunkSize;
+		}
+
+		Start = GetNanoseconds();
+		Result = SendChunks(source, length, Size, &Chunks);
+
+		if(!Result) {
+			break;
+		}
+
+		Index = FindSize(Size);
+		if(Index >= 0) {
+			Statistics.Sizes[Index].Failures++;
+		}
+
+		if(Size <= Config.MinimumChunk) {
+			Statistics.Errors++;
+			return Result;
+		}
+
+		FallBack(Size);
+
+		// the controller stopped somewhere in its window, so set the window again
+		if(LastCommandLength) {
+			WriteTransfer(&LastCommand[0], LastCommandLength);
+		}
+	}
+
+	Measure(Size, length, Chunks, GetNanoseconds() - Start);
+
+	return (int32_t)length;
+}
+
+static void Write(uint8_t * source, uint32_t length) {
+	TryWrite(source, length);
+}
+
+static void Read(uint8_t * destination, uint32_t length) {
+	if(Target && Target->Read) {
+		Target->Read(destination, length);
+	}
+}
+
+static void Open(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
+	if(Target && Target->Open) {
+		Target->Open(i2cPortNumber, slaveAddress);
+	}
+}
+
+static void Close(void) {
+	if(Target && Target->Close) {
+		Target->Close();
+	}
+}
+
+static void Tune(void) {
+	Statistics.Ceiling = Config.ChunkSize ? Config.ChunkSize : Config.MaximumChunk;
+
+	if(Config.ChunkSize) {
+		Statistics.ChunkSize = Config.ChunkSize;
+	}
+
+	StartRound();
+}
+
+/**
+ * @param target the interface the chunks are written to
+ * @param config the chunk sizes and how they are tuned
+ *
+ * @return 0 on success else a negative errno
+ */
+static int32_t Start(I2CInterface * target, const I2CChunkerConfigType * config) {
+	uint32_t Size;
+
+	if(!target || !config || (!target->TryWrite && !target->Write)) {
+		return -EINVAL;
+	}
+
+	Target = target;
+	Config = *config;
+
+	if(Config.MinimumChunk < 2) {
+		Config.MinimumChunk = 2;
+	}
+	if(!Config.MaximumChunk || Config.MaximumChunk > I2C_CHUNKER_MAX_CHUNK) {
+		Config.MaximumChunk = I2C_CHUNKER_MAX_CHUNK;
+	}
+	if(Config.MaximumChunk < Config.MinimumChunk) {
+		Config.MaximumChunk = Config.MinimumChunk;
+	}
+	if(Config.ChunkSize > I2C_CHUNKER_MAX_CHUNK) {
+		Config.ChunkSize = I2C_CHUNKER_MAX_CHUNK;
+	}
+	if(Config.ChunkSize && Config.ChunkSize < Config.MinimumChunk) {
+		Config.ChunkSize = Config.MinimumChunk;
+	}
+	if(!Config.SamplesPerSize) {
+		Config.SamplesPerSize = 1;
+	}
+
+	memset(&Statistics, 0, sizeof(Statistics));
+	LastCommandLength = 0;
+
+	if(Config.ChunkSize) {
+		Statistics.Sizes[Statistics.SizeCount++].ChunkSize = Config.ChunkSize;
+	} else {
+		// double up from the smallest size, always ending with the largest
+		for(Size = Config.MinimumChunk; Size < Config.MaximumChunk && Statistics.SizeCount < (I2C_CHUNKER_MAX_SIZES - 1); Size *= 2) {
+			Statistics.Sizes[Statistics.SizeCount++].ChunkSize = Size;
+		}
+		Statistics.Sizes[Statistics.SizeCount++].ChunkSize = Config.MaximumChunk;
+	}
+
+	Statistics.ChunkSize = Config.ChunkSize ? Config.ChunkSize : Config.MaximumChunk;
+
+	Tune();
+
+	return 0;
+}
+
+/**
+ * returns a snapshot of the counters and measurements
+ */
+static void GetStatistics(I2CChunkerStatisticsType * statistics) {
+	if(!statistics) {
+		return;
+	}
+
+	*statistics = Statistics;
+}
+
+/**
+ * This is our chunker instance
+ */
+I2CChunkerType I2CChunker = {
+	Start: Start,
+	Tune: Tune,
+	GetStatistics: GetStatistics
+};
+
+/**
+ * this is the chunking I2C interface instance
+ */
+I2CInterface I2CChunkerInterface = {Open, Close, Write, Read, TryWrite };
@@ -0,0 +1,81 @@
+/*
+ * i2cChunker.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __I2C_CHUNKER_H__
+#define __I2C_CHUNKER_H__
+
+	#include "i2cInterface.h"
+
+	/**
+	 * defines the largest chunk that is sent in one go, control byte included.
+	 * This fits a full 128x64 frame.
+	 */
+	#define I2C_CHUNKER_MAX_CHUNK 1040
+
+	/**
+	 * defines how many chunk sizes are measured while tuning
+	 */
+	#define I2C_CHUNKER_MAX_SIZES 8
+
+	/**
+	 * defines the chunker configuration
+	 */
+	typedef struct I2CChunkerConfigType {
+		uint32_t ChunkSize;				///< fixed chunk size, control byte included. 0 tunes it
+		uint32_t MinimumChunk;			///< smallest size tuned and fallen back to. At least 2
+		uint32_t MaximumChunk;			///< largest size tuned. At most I2C_CHUNKER_MAX_CHUNK
+		uint32_t SamplesPerSize;		///< data transfers measured at each size while tuning
+		uint32_t RetuneTransfers;		///< data transfers between tuning rounds. 0 only tunes on Start and Tune
+	} I2CChunkerConfigType;
+
+	/**
+	 * defines what was measured at one chunk size since the last tuning round started
+	 */
+	typedef struct I2CChunkerSizeType {
+		uint32_t ChunkSize;
+		uint32_t Transfers;				///< data transfers measured
+		uint32_t Chunks;				///< bus transactions they took
+		uint32_t BytesPerSecond;		///< display data throughput, repeated control bytes not included
+		uint32_t ChunkMicroseconds;		///< average time per transaction
+		uint32_t Failures;				///< chunks of this size that failed, since Start
+	} I2CChunkerSizeType;
+
+	/**
+	 * defines the chunker counters
+	 */
+	typedef struct I2CChunkerStatisticsType {
+		uint32_t ChunkSize;				///< the size in use
+		uint32_t Ceiling;				///< the largest size that is tried, lowered when a chunk fails
+		uint8_t Tuning;					///< true while a tuning round is running
+		uint32_t Rounds;				///< tuning rounds completed
+		uint32_t Fallbacks;				///< transfers resent in smaller chunks after a chunk failed
+		uint32_t Errors;				///< transfers that failed at the smallest size
+		uint32_t SizeCount;
+		I2CChunkerSizeType Sizes[I2C_CHUNKER_MAX_SIZES];
+	} I2CChunkerStatisticsType;
+
+	/**
+	 * defines the chunker interface
+	 */
+	typedef struct I2CChunkerType {
+		/** target is the bus the chunks are written to. Starts a tuning round unless the size is fixed. Returns 0 or a negative errno **/
+		int32_t (*Start)(I2CInterface * target, const I2CChunkerConfigType * config);
+		/** starts a tuning round. Sizes that failed before are tried again **/
+		void (*Tune)(void);
+		void (*GetStatistics)(I2CChunkerStatisticsType * statistics);
+	} I2CChunkerType;
+
+	extern I2CChunkerType I2CChunker;
+
+	/**
+	 * An I2C interface that splits display data transfers into chunks on the way to the target.
+	 * Pass this to the display driver, or put it under I2CAsync, so that it measures the bus
+	 * itself. Open and Close are forwarded to the target interface. It is not thread safe.
+	 */
+	extern I2CInterface I2CChunkerInterface;
+
+#endif /* __I2C_CHUNKER_H__ */
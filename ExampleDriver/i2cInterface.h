@@ -18,6 +18,8 @@
 		void (*Close) (void);
 		void (*Write) (uint8_t * source, uint32_t length);
 		void (*Read) (uint8_t * destination, uint32_t length);
+		/** same as Write but returns the number of bytes written or a negative errno on failure **/
+		int32_t (*TryWrite) (uint8_t * source, uint32_t length);
 	} I2CInterface;
 
 #endif /* __I2C_INTERFACE_H__ */
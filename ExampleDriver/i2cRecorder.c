@@ -0,0 +1,166 @@
+/*
+ * i2cRecorder.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  This is an I2C interface that logs every transaction to a binary trace file (see i2cTrace.h)
+ *  so that the display traffic can be replayed and inspected offline.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "i2cRecorder.h"
+
+/**
+ * the trace file we are writing to
+ */
+static FILE * TraceFile;
+
+/**
+ * the path of the trace file to create on Open
+ */
+static const char * TracePath;
+
+/**
+ * the interface that the traffic is forwarded to
+ */
+static I2CInterface * Target;
+
+/**
+ * the slave address given to Open
+ */
+static uint8_t SlaveAddress;
+
+/**
+ * the time stamp of the last record in microseconds
+ */
+static uint64_t LastTimestamp;
+
+/**
+ * returns a monotonic time stamp in microseconds
+ */
+static uint64_t GetTimestamp(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000000u) + ((uint64_t)Now.tv_nsec / 1000u);
+}
+
+/**
+ * stores the given value as little endian
+ */
+static void PutLittleEndian(uint8_t * destination, uint32_t value, uint_fast8_t size) {
+	for( ; size; size--) {
+		*destination++ = value & 0xFF;
+		value >>= 8;
+	}
+}
+
+/**
+ * writes a single record to the trace file
+ */
+static void WriteRecord(uint8_t * payload, uint32_t length, uint8_t flags) {
+	uint8_t Header[I2C_TRACE_RECORD_HEADER_SIZE];
+	uint64_t Timestamp;
+
+	if(!TraceFile) {
+		return;
+	}
+
+	Timestamp = GetTimestamp();
+
+	PutLittleEndian(&Header[0], (uint32_t)(Timestamp - LastTimestamp), 4);
+	PutLittleEndian(&Header[4], length, 4);
+	Header[8] = SlaveAddress;
+	Header[9] = flags;
+
+	LastTimestamp = Timestamp;
+
+	fwrite(&Header[0], 1, sizeof(Header), TraceFile);
+
+	if(payload && length) {
+		fwrite(payload, 1, length, TraceFile);
+	}
+}
+
+void I2CRecorderSetup(const char * tracePath, I2CInterface * target) {
+	TracePath = tracePath;
+	Target = target;
+}
+
+static void Open(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
+	uint8_t Header[I2C_TRACE_HEADER_SIZE] = I2C_TRACE_MAGIC;
+
+	SlaveAddress = slaveAddress;
+
+	if(TracePath) {
+		TraceFile = fopen(TracePath, "wb");
+	}
+
+	if(TraceFile) {
+		PutLittleEndian(&Header[4], I2C_TRACE_VERSION, 2);
+		PutLittleEndian(&Header[6], I2C_TRACE_HEADER_SIZE, 2);
+		fwrite(&Header[0], 1, sizeof(Header), TraceFile);
+	}
+
+	LastTimestamp = GetTimestamp();
+
+	if(Target && Target->Open) {
+		Target->Open(i2cPortNumber, slaveAddress);
+	}
+}
+
+static void Close(void) {
+	if(TraceFile) {
+		fclose(TraceFile);
+		TraceFile = NULL;
+	}
+
+	if(Target && Target->Close) {
+		Target->Close();
+	}
+}
+
+static int32_t TryWrite(uint8_t * source, uint32_t length) {
+	if(!source) {
+		return -EINVAL;
+	}
+
+	WriteRecord(source, length, 0);
+
+	if(Target && Target->TryWrite) {
+		return Target->TryWrite(source, length);
+	}
+
+	if(Target && Target->Write) {
+		Target->Write(source, length);
+	}
+
+	return (int32_t)length;
+}
+
+static void Write(uint8_t * source, uint32_t length) {
+	TryWrite(source, length);
+}
+
+static void Read(uint8_t * destination, uint32_t length) {
+	if(!destination) {
+		return;
+	}
+
+	if(Target && Target->Read) {
+		Target->Read(destination, length);
+	} else {
+		memset(destination, 0, length);
+	}
+
+	WriteRecord(destination, length, I2C_TRACE_FLAG_READ);
+}
+
+/**
+ * this is the recording I2C interface instance
+ */
+I2CInterface I2CRecorder = {Open, Close, Write, Read, TryWrite };
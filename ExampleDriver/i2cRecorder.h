@@ -0,0 +1,25 @@
+/*
+ * i2cRecorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __I2C_RECORDER_H__
+#define __I2C_RECORDER_H__
+
+	#include "i2cInterface.h"
+	#include "i2cTrace.h"
+
+	/**
+	 * Sets where the recorder writes its trace and which interface, if any, the traffic is passed on to.
+	 * This must be called before Open.
+	 *
+	 * @param tracePath the trace file to create
+	 * @param target the real bus to forward the traffic to. Pass NULL to record only.
+	 */
+	void I2CRecorderSetup(const char * tracePath, I2CInterface * target);
+
+	extern I2CInterface I2CRecorder;
+
+#endif /* __I2C_RECORDER_H__ */
@@ -0,0 +1,137 @@
+/*
+ * i2cSimulator.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  This is an I2C interface that doesn't talk to any hardware. It works out how long each
+ *  transaction would hold the bus so that frame times can be predicted without a panel.
+ *
+ *  Each transaction is modelled as:
+ *      START + address byte + payload bytes + STOP + bus free time + software gap
+ *  where every byte takes 9 clocks (8 data bits and the ACK) plus the slave's clock stretching.
+ */
+#include <errno.h>
+#include <string.h>
+#include "i2cSimulator.h"
+
+/**
+ * the default timing is a standard mode bus with no stretching
+ */
+static I2CSimulatorConfigType Config = {
+	ClockHz: 100000,
+	StretchNanoseconds: 0,
+	GapNanoseconds: 0
+};
+
+/**
+ * the accumulated bus usage
+ */
+static I2CSimulatorStatisticsType Statistics;
+
+/**
+ * the bus time at the last frame mark
+ */
+static uint64_t FrameStart;
+
+/**
+ * @return the minimum bus free time between a STOP and the next START for the current speed mode
+ */
+static uint32_t BusFreeNanoseconds(void) {
+	if(Config.ClockHz > 400000) {
+		return 500;		// fast mode plus
+	}
+
+	if(Config.ClockHz > 100000) {
+		return 1300;	// fast mode
+	}
+
+	return 4700;		// standard mode
+}
+
+/**
+ * adds a single transaction to the bus time
+ *
+ * @param length payload length excluding the address byte
+ */
+static void AddTransaction(uint32_t length) {
+	uint64_t BitNanoseconds;
+	uint64_t Time;
+
+	if(!Config.ClockHz) {
+		return;
+	}
+
+	BitNanoseconds = 1000000000u / Config.ClockHz;
+
+	// START and STOP take roughly one bit time each
+	Time = BitNanoseconds * 2;
+
+	// address byte plus the payload, 9 clocks per byte
+	Time += ((uint64_t)length + 1) * ((BitNanoseconds * 9) + Config.StretchNanoseconds);
+
+	Time += BusFreeNanoseconds() + Config.GapNanoseconds;
+
+	Statistics.BusNanoseconds += Time;
+	Statistics.Transactions++;
+	Statistics.Bytes += length;
+}
+
+void I2CSimulatorSetup(const I2CSimulatorConfigType * config) {
+	if(config) {
+		Config = *config;
+	}
+
+	memset(&Statistics, 0, sizeof(Statistics));
+	FrameStart = 0;
+}
+
+uint64_t I2CSimulatorTakeFrameTime(void) {
+	uint64_t FrameTime = Statistics.BusNanoseconds - FrameStart;
+
+	FrameStart = Statistics.BusNanoseconds;
+
+	return FrameTime;
+}
+
+void I2CSimulatorGetStatistics(I2CSimulatorStatisticsType * statistics) {
+	if(statistics) {
+		*statistics = Statistics;
+	}
+}
+
+static void Open(uint_fast8_t i2cPortNumber, uint8_t slaveAddress) {
+	(void)i2cPortNumber;
+	(void)slaveAddress;
+}
+
+static void Close(void) {
+}
+
+static int32_t TryWrite(uint8_t * source, uint32_t length) {
+	if(!source) {
+		return -EINVAL;
+	}
+
+	AddTransaction(length);
+
+	return (int32_t)length;
+}
+
+static void Write(uint8_t * source, uint32_t length) {
+	TryWrite(source, length);
+}
+
+static void Read(uint8_t * destination, uint32_t length) {
+	if(!destination) {
+		return;
+	}
+
+	memset(destination, 0, length);
+	AddTransaction(length);
+}
+
+/**
+ * this is the simulated I2C interface instance
+ */
+I2CInterface I2CSimulator = {Open, Close, Write, Read, TryWrite };
@@ -0,0 +1,49 @@
+/*
+ * i2cSimulator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __I2C_SIMULATOR_H__
+#define __I2C_SIMULATOR_H__
+
+	#include "i2cInterface.h"
+
+	/**
+	 * defines the simulated bus timing
+	 */
+	typedef struct I2CSimulatorConfigType {
+		uint32_t ClockHz;				///< SCL frequency. 100000, 400000 or 1000000
+		uint32_t StretchNanoseconds;	///< time the slave holds SCL low after each byte
+		uint32_t GapNanoseconds;		///< software gap between two transactions, on top of the bus free time
+	} I2CSimulatorConfigType;
+
+	/**
+	 * defines the accumulated bus usage
+	 */
+	typedef struct I2CSimulatorStatisticsType {
+		uint64_t BusNanoseconds;	///< total virtual bus time
+		uint32_t Transactions;		///< number of START to STOP transactions
+		uint32_t Bytes;				///< payload bytes, excluding the address byte
+	} I2CSimulatorStatisticsType;
+
+	/**
+	 * Sets the simulated bus timing and clears the statistics.
+	 */
+	void I2CSimulatorSetup(const I2CSimulatorConfigType * config);
+
+	/**
+	 * Returns the virtual bus time used since the last call and starts a new frame.
+	 * Call this after every Sync to get the frame's bus time.
+	 */
+	uint64_t I2CSimulatorTakeFrameTime(void);
+
+	/**
+	 * returns the bus usage since I2CSimulatorSetup was called
+	 */
+	void I2CSimulatorGetStatistics(I2CSimulatorStatisticsType * statistics);
+
+	extern I2CInterface I2CSimulator;
+
+#endif /* __I2C_SIMULATOR_H__ */
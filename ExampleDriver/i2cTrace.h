@@ -0,0 +1,57 @@
+/*
+ * i2cTrace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Describes the binary I2C trace file written by the recorder (i2cRecorder.c) and
+ *  read back by the host side tools.
+ *
+ *  All values are little endian. The file starts with a header followed by one record per bus
+ *  transaction:
+ *
+ *  header: magic "I2CT" (4), version (2), header size (2)
+ *  record: microseconds since the previous record (4), payload length (4), slave address (1), flags (1), payload
+ */
+
+#ifndef __I2C_TRACE_H__
+#define __I2C_TRACE_H__
+
+	#include <stdint.h>
+
+	/**
+	 * trace file magic number
+	 */
+	#define I2C_TRACE_MAGIC "I2CT"
+
+	/**
+	 * current trace file version
+	 */
+	#define I2C_TRACE_VERSION 1
+
+	/**
+	 * size in bytes of the file header
+	 */
+	#define I2C_TRACE_HEADER_SIZE 8
+
+	/**
+	 * size in bytes of each record header
+	 */
+	#define I2C_TRACE_RECORD_HEADER_SIZE 10
+
+	/**
+	 * the record was a read transaction. The payload holds the data that was read
+	 */
+	#define I2C_TRACE_FLAG_READ 0x01
+
+	/**
+	 * defines a decoded trace record header
+	 */
+	typedef struct I2CTraceRecordType {
+		uint32_t DeltaMicroseconds;	///< time since the previous record
+		uint32_t Length;			///< payload length in bytes
+		uint8_t SlaveAddress;		///< the 7 bit slave address
+		uint8_t Flags;				///< see I2C_TRACE_FLAG_*
+	} I2CTraceRecordType;
+
+#endif /* __I2C_TRACE_H__ */
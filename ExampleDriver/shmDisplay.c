@@ -0,0 +1,566 @@
+/*
+ * shmDisplay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  This is a virtual display with no panel behind it. Sync publishes the frame buffer into a POSIX
+ *  shared memory segment (see shmDisplayFormat.h) where another process, e.g. Tools/shmViewer, can
+ *  look at it without stopping the producer.
+ *
+ *  Drawing goes into a private buffer, just like a real panel, so a viewer only ever sees frames
+ *  that were synced. Publishing is a copy of the synced pages inside a sequence lock.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "shmDisplay.h"
+
+/*
+ * defines the screen data size. This is how many pixels are grouped
+ */
+#define SCREEN_DATA_SIZE 8
+
+/**
+ * the mapped segment
+ */
+static ShmDisplayHeaderType * Segment;
+
+/**
+ * the size of the mapped segment
+ */
+static size_t SegmentSize;
+
+/**
+ * the segment name, needed to unlink it on Close
+ */
+static char SegmentName[64];
+
+/**
+ * the frame buffer we draw into
+ */
+static uint8_t * Buffer;
+
+/**
+ * frame buffer size in bytes
+ */
+static uint32_t BufferSize;
+
+/**
+ * number of 8 pixel pages
+ */
+static uint32_t Pages;
+
+/**
+ * true when the buffer has changed since the last sync
+ */
+static uint_fast8_t Dirty;
+
+/**
+ * returns a monotonic time stamp in microseconds
+ */
+static uint64_t GetTimestamp(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000000u) + ((uint64_t)Now.tv_nsec / 1000u);
+}
+
+/**
+ * starts a write to the segment. Readers that overlap with it will retry
+ */
+static void BeginPublish(void) {
+	unsigned int Sequence = atomic_load_explicit(&Segment->Sequence, memory_order_relaxed);
+
+	atomic_store_explicit(&Segment->Sequence, Sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * ends a write to the segment
+ */
+static void EndPublish(void) {
+	unsigned int Sequence = atomic_load_explicit(&Segment->Sequence, memory_order_relaxed);
+
+	Segment->TimestampMicroseconds = GetTimestamp();
+	atomic_store_explicit(&Segment->Sequence, Sequence + 1, memory_order_release);
+}
+
+/**
+ * copies a window of the buffer into the segment
+ */
+static void Publish(uint32_t firstColumn, uint32_t lastColumn, uint32_t firstPage, uint32_t lastPage) {
+	uint8_t * Destination = (uint8_t *)Segment + Segment->HeaderSize;
+	uint32_t Columns = (lastColumn - firstColumn) + 1;
+	uint32_t Offset;
+	uint32_t Page;
+
+	BeginPublish();
+
+	for(Page = firstPage; Page <= lastPage; Page++) {
+		Offset = (Page * ShmDisplay.Width) + firstColumn;
+		memcpy(&Destination[Offset], &Buffer[Offset], Columns);
+	}
+
+	Segment->Frames++;
+	Segment->BytesPublished += Columns * ((lastPage - firstPage) + 1);
+
+	EndPublish();
+}
+
+/**
+ * publishes the whole buffer
+ */
+static void Sync(void) {
+
+	if(!Segment) {
+		return;
+	}
+
+	Publish(0, ShmDisplay.Width - 1, 0, Pages - 1);
+
+	Dirty = 0;
+}
+
+/**
+ * publishes only the pages and columns that cover a rectangle. The rectangle is clipped to the display.
+ *
+ * @note the buffer stays dirty unless the rectangle covers the whole display, since other parts may still be pending
+ */
+static void SyncRegion(int32_t x, int32_t y, int32_t width, int32_t height) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+
+	if(!Segment) {
+		return;
+	}
+
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < 0) {
+		y = 0;
+	}
+	if(XEnd > (int32_t)ShmDisplay.Width) {
+		XEnd = ShmDisplay.Width;
+	}
+	if(YEnd > (int32_t)ShmDisplay.Height) {
+		YEnd = ShmDisplay.Height;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	if(!x && !y && XEnd == (int32_t)ShmDisplay.Width && YEnd == (int32_t)ShmDisplay.Height) {
+		Sync();
+		return;
+	}
+
+	Segment->RegionSyncs++;
+	Publish(x, XEnd - 1, y / SCREEN_DATA_SIZE, (YEnd - 1) / SCREEN_DATA_SIZE);
+}
+
+/**
+ * @return true if the buffer has changed since the last sync
+ */
+static uint_fast8_t IsDirty(void) {
+	return Dirty;
+}
+
+/**
+ * this will fill the buffer content.
+ *
+ * @param value if true = all pixel on, else all pixel off
+ */
+static void Fill(uint8_t value) {
+	if(!Buffer) {
+		return;
+	}
+
+	memset(Buffer, value ? 0xFF : 0x00, BufferSize);
+	Dirty = 1;
+}
+
+/**
+ * this will clear the buffer content.
+ */
+static void Clear(void) {
+	Fill(0);
+}
+
+/**
+ * copies a complete frame into the buffer. The source uses the buffer's page layout
+ */
+static void DirectWriteToBuffer(uint8_t * source) {
+	if(!Buffer || !source) {
+		return;
+	}
+
+	memcpy(Buffer, source, BufferSize);
+	Dirty = 1;
+}
+
+/**
+ * copies the buffer, synced or not, to destinationPointer
+ *
+ * @return the number of bytes copied
+ */
+static uint32_t GetDisplayBuffer(uint8_t * destinationPointer) {
+	if(!Buffer || !destinationPointer) {
+		return 0;
+	}
+
+	memcpy(destinationPointer, Buffer, BufferSize);
+
+	return BufferSize;
+}
+
+/**
+ * there is no panel, the value is only published for the viewer
+ */
+static void SetBrightness(uint8_t value) {
+	if(!Segment) {
+		return;
+	}
+
+	BeginPublish();
+	Segment->Brightness = value;
+	EndPublish();
+}
+
+/**
+ * this function handle drawing a pixel to the buffer. Pixels outside of the display are ignored
+ */
+static void SetPixel(uint32_t x, uint32_t y, uint8_t value) {
+	uint8_t Mask;
+
+	if(x >= ShmDisplay.Width || y >= ShmDisplay.Height || !Buffer) {
+		return;
+	}
+
+	Mask = 0x01 << (y & (SCREEN_DATA_SIZE - 1));
+
+	if(value) {
+		Buffer[x + ((y / SCREEN_DATA_SIZE) * ShmDisplay.Width)] |= Mask;
+	} else {
+		Buffer[x + ((y / SCREEN_DATA_SIZE) * ShmDisplay.Width)] &= ~Mask;
+	}
+
+	Dirty = 1;
+}
+
+/**
+ * @return the pixel in the buffer, 0 outside of the display
+ */
+static uint_fast8_t GetPixel(uint32_t x, uint32_t y) {
+	if(x >= ShmDisplay.Width || y >= ShmDisplay.Height || !Buffer) {
+		return 0;
+	}
+
+	return (Buffer[x + ((y / SCREEN_DATA_SIZE) * ShmDisplay.Width)] >> (y & (SCREEN_DATA_SIZE - 1))) & 0x01;
+}
+
+/**
+ * copies a run of page bytes out of the buffer
+ *
+ * @return the number of bytes copied
+ */
+static uint32_t ReadPage(int32_t x, int32_t page, uint8_t * destination, uint32_t length) {
+	if(!Buffer || !destination || x < 0 || page < 0 || x >= (int32_t)ShmDisplay.Width || page >= (int32_t)Pages) {
+		return 0;
+	}
+
+	if(length > (ShmDisplay.Width - x)) {
+		length = ShmDisplay.Width - x;
+	}
+
+	memcpy(destination, &Buffer[(page * ShmDisplay.Width) + x], length);
+
+	return length;
+}
+
+/**
+ * sets or clears a rectangle in the buffer. Each page is handled with one mask per column
+ */
+static void FillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+	uint32_t Page;
+	uint32_t LastPage;
+	uint8_t Mask;
+	uint8_t * Destination;
+	int32_t Column;
+
+	if(!Buffer) {
+		return;
+	}
+
+	// clip to the display
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < 0) {
+		y = 0;
+	}
+	if(XEnd > (int32_t)ShmDisplay.Width) {
+		XEnd = ShmDisplay.Width;
+	}
+	if(YEnd > (int32_t)ShmDisplay.Height) {
+		YEnd = ShmDisplay.Height;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	LastPage = (YEnd - 1) / SCREEN_DATA_SIZE;
+
+	for(Page = y / SCREEN_DATA_SIZE; Page <= LastPage; Page++) {
+		Mask = 0xFF;
+
+		if(Page == (uint32_t)(y / SCREEN_DATA_SIZE)) {
+			Mask &= 0xFF << (y & (SCREEN_DATA_SIZE - 1));
+		}
+		if(Page == LastPage) {
+			Mask &= 0xFF >> ((SCREEN_DATA_SIZE - 1) - ((YEnd - 1) & (SCREEN_DATA_SIZE - 1)));
+		}
+
+		Destination = &Buffer[(Page * ShmDisplay.Width) + x];
+
+		for(Column = x; Column < XEnd; Column++) {
+			*Destination = value ? (*Destination | Mask) : (*Destination & ~Mask);
+			Destination++;
+		}
+	}
+
+	Dirty = 1;
+}
+
+/**
+ * combines a run of page bytes into the buffer
+ *
+ * @param x the first column
+ * @param page the page to write to
+ * @param source one byte per column
+ * @param length number of columns
+ * @param mask only these bits of each byte are changed
+ * @param operation DisplayRasterOpType
+ */
+static void BlitPage(int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	int32_t XEnd = x + (int32_t)length;
+	uint8_t * Destination;
+	uint8_t Value;
+
+	if(!Buffer || !source || page < 0 || page >= (int32_t)Pages) {
+		return;
+	}
+
+	// clip to the display
+	if(x < 0) {
+		source -= x;
+		x = 0;
+	}
+	if(XEnd > (int32_t)ShmDisplay.Width) {
+		XEnd = ShmDisplay.Width;
+	}
+	if(x >= XEnd) {
+		return;
+	}
+
+	Destination = &Buffer[(page * ShmDisplay.Width) + x];
+
+	for( ; x < XEnd; x++) {
+		Value = *source++ & mask;
+
+		switch(operation) {
+			case Raster_Or:
+				*Destination |= Value;
+			break;
+
+			case Raster_AndNot:
+				*Destination &= ~Value;
+			break;
+
+			case Raster_Xor:
+				*Destination ^= Value;
+			break;
+
+			case Raster_Copy:
+			default:
+				*Destination = (*Destination & ~mask) | Value;
+			break;
+		}
+
+		Destination++;
+	}
+
+	Dirty = 1;
+}
+
+/**
+ * marks the display as open and optionally clears it
+ *
+ * @param resetBuffer if true the buffer is cleared and published
+ */
+static void Reset(uint_fast8_t resetBuffer) {
+	if(!Segment) {
+		return;
+	}
+
+	if(resetBuffer) {
+		Clear();
+	}
+
+	Sync();
+}
+
+/**
+ * releases the segment and the buffer
+ */
+static void Release(void) {
+	if(Segment) {
+		munmap(Segment, SegmentSize);
+		shm_unlink(SegmentName);
+		Segment = NULL;
+	}
+
+	free(Buffer);
+	Buffer = NULL;
+}
+
+/**
+ * the display has no bus, the interface is ignored and may be NULL
+ */
+static void Open(GenericComInterface * interface) {
+	(void)interface;
+
+	if(!Segment) {
+		return;
+	}
+
+	BeginPublish();
+	Segment->Open = 1;
+	EndPublish();
+
+	Reset(1);
+}
+
+/**
+ * marks the display as closed and removes the segment. Viewers that still have it mapped keep the last frame
+ *
+ * @param cleanScreenFlag clear the display before closing
+ */
+static void Close(uint_fast8_t cleanScreenFlag) {
+	if(!Segment) {
+		return;
+	}
+
+	if(cleanScreenFlag) {
+		Clear();
+		Sync();
+	}
+
+	BeginPublish();
+	Segment->Open = 0;
+	EndPublish();
+
+	Release();
+}
+
+int32_t ShmDisplaySetup(const char * name, uint32_t width, uint32_t height) {
+	uint32_t HeaderSize = (sizeof(ShmDisplayHeaderType) + 63) & ~63u;
+	int32_t Error;
+	int Handle;
+
+	if(!width || !height || width > 0xFFFF || height > (0xFF * SCREEN_DATA_SIZE) ||
+			(name && strlen(name) >= sizeof(SegmentName))) {
+		return -EINVAL;
+	}
+
+	Release();
+
+	snprintf(SegmentName, sizeof(SegmentName), "%s", name ? name : SHM_DISPLAY_DEFAULT_NAME);
+
+	Pages = (height + (SCREEN_DATA_SIZE - 1)) / SCREEN_DATA_SIZE;
+	BufferSize = width * Pages;
+	SegmentSize = HeaderSize + BufferSize;
+
+	Buffer = calloc(1, BufferSize);
+	if(!Buffer) {
+		return -ENOMEM;
+	}
+
+	// start from a new segment so a viewer still mapping an old one keeps a valid mapping
+	shm_unlink(SegmentName);
+	Handle = shm_open(SegmentName, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(Handle < 0) {
+		Error = -errno;
+		Release();
+		return Error;
+	}
+
+	if(ftruncate(Handle, SegmentSize)) {
+		Error = -errno;
+		close(Handle);
+		shm_unlink(SegmentName);
+		Release();
+		return Error;
+	}
+
+	Segment = mmap(NULL, SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, Handle, 0);
+	close(Handle);
+
+	if(Segment == MAP_FAILED) {
+		Error = -errno;
+		Segment = NULL;
+		shm_unlink(SegmentName);
+		Release();
+		return Error;
+	}
+
+	// the segment is new and zeroed, so Sequence starts even
+	Segment->HeaderSize = HeaderSize;
+	Segment->Width = width;
+	Segment->Height = height;
+	Segment->BufferSize = BufferSize;
+	Segment->ProducerPid = getpid();
+	Segment->Brightness = 0xFF;
+	Segment->Version = SHM_DISPLAY_VERSION;
+	atomic_thread_fence(memory_order_release);
+	Segment->Magic = SHM_DISPLAY_MAGIC;
+
+	ShmDisplay.Width = width;
+	ShmDisplay.Height = height;
+	Dirty = 0;
+
+	return 0;
+}
+
+/**
+ * This is our virtual display instance
+ */
+struct DisplayInterfaceType ShmDisplay = {
+	Width: 0,
+	Height: 0,
+	Open: Open,
+	Reset: Reset,
+	Close: Close,
+	Sync: Sync,
+	SetPixel: SetPixel,
+	directWriteToBuffer: DirectWriteToBuffer,
+	Clear: Clear,
+	Fill: Fill,
+	GetDisplayBuffer: GetDisplayBuffer,
+	setBrightness: SetBrightness,
+	IsDirty: IsDirty,
+	FillRect: FillRect,
+	BlitPage: BlitPage,
+	SyncRegion: SyncRegion,
+	GetPixel: GetPixel,
+	ReadPage: ReadPage
+};
@@ -0,0 +1,28 @@
+/*
+ * shmDisplay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __SHM_DISPLAY_H__
+#define __SHM_DISPLAY_H__
+
+	#include "../displayDriver.h"
+	#include "shmDisplayFormat.h"
+
+	/**
+	 * Creates the shared memory segment and sets the display size. This must be called before Open.
+	 * Calling it again replaces the previous segment.
+	 *
+	 * @param name the POSIX shared memory name, e.g. "/panel0". Pass NULL for SHM_DISPLAY_DEFAULT_NAME
+	 * @param width number of columns, up to 65535
+	 * @param height number of rows, up to 2040
+	 *
+	 * @return 0 on success or a negative errno
+	 */
+	int32_t ShmDisplaySetup(const char * name, uint32_t width, uint32_t height);
+
+	extern struct DisplayInterfaceType ShmDisplay;
+
+#endif /* __SHM_DISPLAY_H__ */
@@ -0,0 +1,60 @@
+/*
+ * shmDisplayFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Describes the shared memory segment published by the virtual display (shmDisplay.c) and
+ *  mapped read only by the viewer (Tools/shmViewer.c).
+ *
+ *  The segment is a header followed by the frame buffer in the display's page layout. Both sides
+ *  run on the same machine so the header uses native byte order.
+ *
+ *  The header and the frame buffer are guarded by a sequence lock. The producer makes Sequence odd,
+ *  writes and then makes it even again; it never waits for a reader. A reader copies what it
+ *  needs and retries if Sequence was odd or changed while it was copying.
+ */
+
+#ifndef __SHM_DISPLAY_FORMAT_H__
+#define __SHM_DISPLAY_FORMAT_H__
+
+	#include <stdint.h>
+	#include <stdatomic.h>
+
+	/**
+	 * segment magic number, "SHMD"
+	 */
+	#define SHM_DISPLAY_MAGIC 0x444D4853u
+
+	/**
+	 * current segment layout version
+	 */
+	#define SHM_DISPLAY_VERSION 1
+
+	/**
+	 * the segment name used when none is given
+	 */
+	#define SHM_DISPLAY_DEFAULT_NAME "/basicGraphicsDisplay"
+
+	/**
+	 * defines the segment header. The frame buffer starts HeaderSize bytes into the segment
+	 */
+	typedef struct ShmDisplayHeaderType {
+		uint32_t Magic;					///< SHM_DISPLAY_MAGIC
+		uint16_t Version;				///< SHM_DISPLAY_VERSION
+		uint16_t HeaderSize;			///< offset of the frame buffer
+		uint16_t Width;					///< columns
+		uint16_t Height;				///< rows
+		uint32_t BufferSize;			///< Width * ((Height + 7) / 8)
+		uint32_t ProducerPid;			///< the process that owns the display
+		atomic_uint Sequence;			///< odd while the producer is writing
+		uint32_t Frames;				///< number of syncs published, full or region
+		uint32_t RegionSyncs;			///< how many of those were region syncs
+		uint8_t Brightness;				///< the last value given to setBrightness
+		uint8_t Open;					///< false once the display has been closed
+		uint16_t Reserved;
+		uint64_t BytesPublished;		///< frame buffer bytes copied into the segment
+		uint64_t TimestampMicroseconds;	///< CLOCK_MONOTONIC time of the last publish
+	} ShmDisplayHeaderType;
+
+#endif /* __SHM_DISPLAY_FORMAT_H__ */
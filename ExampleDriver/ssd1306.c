@@ -4,47 +4,82 @@
  *  Created on: Dec 14, 2018
  *      Author: Ronald Sousa https://hashdefineelectronics.com
  */
+#include <errno.h>
 #include "ssd1306.h"
 
 /*
  * defines the screen data size. This is how many pixels are grouped
  */
 #define SCREEN_DATA_SIZE 8
+
 /**
- * Defines the screen height.
+ * defines the number of RAM columns on the SH1106
  */
-#define SCREEN_HEIGHT 32
+#define SH1106_COLUMNS 132
+
 /**
- * Defines the screen Width.
+ * defines the largest frame buffer size
  */
-#define SCREEN_WIDTH 128
+#define MAX_DISPLAY_BUFFER_SIZE ((SSD1306_MAX_WIDTH * SSD1306_MAX_HEIGHT) / SCREEN_DATA_SIZE)
+
 /**
- * Defines how many pages this screen hase.
+ * true when the orientation turns the panel on its side
  */
-#define PAGES (SCREEN_HEIGHT / SCREEN_DATA_SIZE)
+#define IS_TRANSPOSED(orientation) ((orientation) & 0x01)
+
 /**
- * defines the screen data buffer size
+ * bytes a SyncStep window costs on top of its data. The column and page window commands and the
+ * data control byte, or the address commands of each page in page mode
  */
-#define DISPLAY_BUFFER_SIZE ((SCREEN_HEIGHT * SCREEN_WIDTH) / SCREEN_DATA_SIZE)
+#define SYNC_WINDOW_OVERHEAD 8
+#define SYNC_PAGE_OVERHEAD 7
 
 /**
- * this is the screen display buffer
+ * defines the state of one display
  */
-static uint8_t DisplayBuffer[DISPLAY_BUFFER_SIZE];
+typedef struct {
+	SSD1306ConfigType Config;
+	uint32_t Width;				///< width as drawn on, the panel height when it is on its side
+	uint32_t Height;			///< height as drawn on
+	uint32_t Pages;				///< number of 8 pixel pages in the frame buffer
+	uint32_t BufferSize;		///< frame buffer size in bytes
+	uint8_t * Buffer;			///< the frame buffer, page after page
+	uint8_t * PoolBuffer;		///< the buffer this display took from the pool, if any
+	uint32_t PoolBufferSize;
+	I2CInterface * Interface;	///< this screen COM instance
+	uint_fast8_t Dirty;			///< true when the buffer has changed since the last sync
+	uint8_t Brightness;			///< the last value given to setBrightness. 0 turns the panel off
+	uint8_t BrightnessSet;		///< true once setBrightness has been called, so Configure keeps the value
+	uint8_t DriveDim;			///< true when the dim pre-charge period and VCOMH level were the last sent
+	uint_fast8_t SyncPending;	///< true while SyncStep has more of the buffer to send
+	uint32_t SyncPage;			///< the panel page and column SyncStep carries on from
+	uint32_t SyncColumn;
+} SSD1306InstanceType;
 
 /**
- * this screen COM instance
+ * this is the frame buffer pool shared by the displays that aren't given a buffer
  */
-static I2CInterface * Interface;
+static uint8_t BufferPool[SSD1306_POOL_SIZE];
 
 /**
- * defines the various address mode.
+ * how much of the pool has been handed out
  */
-typedef enum {
-	MODE_HorizontalMode = 0x00,
-	MODE_VerticalMode = 0x01,
-	MODE_PageMode = 0x02
-} AddressMode;
+static uint32_t BufferPoolUsed;
+
+/**
+ * the display instances
+ */
+static SSD1306InstanceType Instances[SSD1306_MAX_INSTANCES];
+
+/**
+ * maps the display interfaces to their instance
+ */
+static struct DisplayInterfaceType * const Displays[SSD1306_MAX_INSTANCES] = {
+	&SSD1306,
+	&SSD1306_1,
+	&SSD1306_2,
+	&SSD1306_3
+};
 
 /**
  * Defines the supported driver commands
@@ -83,102 +118,161 @@ typedef enum {
 	CMD_SetVComHDeselect = 0xDB,
 	CMD_NOP = 0xE3,
 
+	// SH1106 only
+	CMD_SetDCDC = 0xAD, ///< SH1106 DC-DC control. 0x8B = on, 0x8A = off
+
 } SSD1306CommandType;
 
 /**
- * this holds the configuration data for the Oled
+ * set the continuation bit Co
+ */
+#define SET_CONTINUATION_BIT 0x80
+
+/**
+ * macro for setting the D/C# portion of the to data type
+ */
+#define SET_DC_TO_DATA 0x40
+
+/**
+ * macro for setting the D/C# portion of the to command type
  */
-static uint8_t DisplayInit[] = {
-		CMD_SetDisplayOnOrOff, // set display to off
+#define SET_DC_TO_COMMAND 0X00
 
-		CMD_SetDisplayClockDived,
-		0x80,
-		CMD_SetMultiplexRatio,
-		0x1F, // SCREEN_HEIGHT -1
+/**
+ * builds the segment remap and COM scan direction commands for the orientation. The panel's
+ * natural orientation has column 127 on SEG0 and scans from COM[n-1]. On its side the frame buffer
+ * is sent transposed, which on its own is a turn of 90 degrees plus a mirror, so one of the two
+ * flips is taken away again.
+ *
+ * @param destination receives the 2 command bytes
+ */
+static void BuildOrientation(uint_fast8_t orientation, uint8_t * destination) {
+	uint_fast8_t Mirror = (orientation & SSD1306_Mirror) != 0;
+	uint_fast8_t FlipColumns;
+	uint_fast8_t FlipRows;
+
+	switch(orientation & 0x03) {
+		case SSD1306_Rotate90:
+			FlipColumns = 1;
+			FlipRows = Mirror;
+		break;
+
+		case SSD1306_Rotate180:
+			FlipColumns = !Mirror;
+			FlipRows = 1;
+		break;
+
+		case SSD1306_Rotate270:
+			FlipColumns = 0;
+			FlipRows = !Mirror;
+		break;
+
+		default:
+			FlipColumns = Mirror;
+			FlipRows = 0;
+		break;
+	}
 
-		CMD_SetDisplayOffset,
-		0x00,
+	destination[0] = CMD_SetSegmentRemap | (FlipColumns ? 0x00 : 0x01);
+	destination[1] = CMD_SetComOutputScanDirection | (FlipRows ? 0x00 : 0x08);
+}
 
-		CMD_SetDisplayStartLine,
+/**
+ * builds the contrast, pre-charge period and VCOMH level commands for the brightness. Below
+ * SSD1306_DIM_LEVEL the pre-charge period and VCOMH level are lowered too, which takes the
+ * panel dimmer than the contrast alone can. The drive level built is kept as the one the panel has.
+ *
+ * @param destination receives the 6 command bytes
+ */
+static void BuildBrightness(SSD1306InstanceType * instance, uint8_t * destination) {
+	uint_fast8_t SH1106 = (instance->Config.Controller == SH1106_Controller);
+	uint_fast8_t Dim = (instance->Brightness < SSD1306_DIM_LEVEL);
 
-		CMD_ChargePump,
-		0x14,
+	destination[0] = CMD_SetContrasControl;
+	destination[1] = instance->Brightness;
 
-		CMD_SetMemoryAddressMode,
-		MODE_HorizontalMode,
+	destination[2] = CMD_SetPreChargePeriod;
+	if(Dim) {
+		destination[3] = SH1106 ? 0x11 : 0x22;
+	} else {
+		destination[3] = SH1106 ? 0x22 : 0xF1;
+	}
 
-		CMD_SetColumnAddress,
-		0x00,
-		0x7F,
-		CMD_SetPageAddress,
-		0x00,
-		PAGES - 1,
+	destination[4] = CMD_SetVComHDeselect;
+	destination[5] = Dim ? 0x00 : 0x40;
 
-		CMD_SetSegmentRemap | 0x01,
+	instance->DriveDim = Dim;
+}
 
-		CMD_SetComOutputScanDirection | 0x08,
+/**
+ * builds the configuration commands for the Oled
+ *
+ * @param destination buffer that receives the commands. It must be at least 40 bytes
+ *
+ * @return the number of command bytes
+ */
+static uint8_t BuildDisplayInit(SSD1306InstanceType * instance, uint8_t * destination) {
+	uint8_t * Command = destination;
+	uint_fast8_t SH1106 = (instance->Config.Controller == SH1106_Controller);
 
-		CMD_SetComPinsHardwareConfiguration | 0x02,
+	*Command++ = CMD_SetDisplayOnOrOff; // set display to off
 
-		CMD_SetContrasControl,
-		0xFF,
+	*Command++ = CMD_SetDisplayClockDived;
+	*Command++ = 0x80;
+	*Command++ = CMD_SetMultiplexRatio;
+	*Command++ = instance->Config.Height - 1;
 
-		CMD_SetPreChargePeriod,
-		0xF1,
+	*Command++ = CMD_SetDisplayOffset;
+	*Command++ = 0x00;
 
-		CMD_SetVComHDeselect,
-		0x40,
+	*Command++ = CMD_SetDisplayStartLine;
 
-		CMD_SetEntireDisplay,
+	if(SH1106) {
+		*Command++ = CMD_SetDCDC;
+		*Command++ = 0x8B;
+	} else {
+		*Command++ = CMD_ChargePump;
+		*Command++ = 0x14;
 
-		CMD_SetNormalDisplay,
+		// the SH1106 only has page mode
+		*Command++ = CMD_SetMemoryAddressMode;
+		*Command++ = instance->Config.AddressMode;
+	}
 
-		CMD_DeactiavateScroll,
+	BuildOrientation(instance->Config.Orientation, Command);
+	Command += 2;
 
-		CMD_SetDisplayOnOrOff | 0x01,
-		CMD_SetPageStartAddressForPageMode
+	*Command++ = CMD_SetComPinsHardwareConfiguration;
+	*Command++ = instance->Config.ComPins;
 
+	BuildBrightness(instance, Command);
+	Command += 6;
 
-};
+	*Command++ = CMD_SetEntireDisplay;
 
-/**
- * this is the commands needed to reset the screen pointer
- */
-static uint8_t ResetPointer[] = {
-		CMD_SetColumnAddress,
-		0x00,
-		0x7F,
-		CMD_SetPageAddress,
-		0x00,
-		(PAGES - 1)
-};
+	*Command++ = CMD_SetNormalDisplay;
 
-/**
- * set the continuation bit Co
- */
-#define SET_CONTINUATION_BIT 0x80
+	if(!SH1106) {
+		*Command++ = CMD_DeactiavateScroll;
+	}
 
-/**
- * macro for setting the D/C# portion of the to data type
- */
-#define SET_DC_TO_DATA 0x40
+	*Command++ = CMD_SetDisplayOnOrOff | (instance->Brightness ? 0x01 : 0x00);
+	*Command++ = CMD_SetPageStartAddressForPageMode;
 
-/**
- * macro for setting the D/C# portion of the to command type
- */
-#define SET_DC_TO_COMMAND 0X00
+	return (uint8_t)(Command - destination);
+}
 
 /**
  * handles sending commands to the Oled display
  *
  * @param command this is the command to send
  */
-static void SendGroupOfCommand(uint8_t *data, uint8_t length) {
+static void SendGroupOfCommand(SSD1306InstanceType * instance, uint8_t *data, uint8_t length) {
 	uint8_t Buffer[100];
 	uint8_t *BufferPointer;
 	uint8_t LengthToSend = 1; // at least one command and a DC byte
 
-	if(!Interface) {
+	if(!instance->Interface || length >= sizeof(Buffer)) {
 		// error. no interface found
 		return;
 	}
@@ -196,52 +290,291 @@ static void SendGroupOfCommand(uint8_t *data, uint8_t length) {
 		}
 	}
 
-	Interface->Write(&Buffer[0], LengthToSend);
+	instance->Interface->Write(&Buffer[0], LengthToSend);
 
 }
 
 /**
- * handles sending commands to the Oled display
- *
- * @param command this is the command to send
+ * transposes an 8x8 block of pixels. Byte n bit m moves to byte m bit n
  */
-static void SendDisplay(uint8_t *data, uint32_t length) {
-	uint8_t Buffer[DISPLAY_BUFFER_SIZE + 10];
-	uint8_t *BufferPointer;
-	uint32_t LengthToSend = 1; // at least one command and a DC byte
+static uint64_t Transpose8x8(uint64_t block) {
+	uint64_t Swap;
 
-	if(!Interface) {
-		// error. no interface found
+	Swap = (block ^ (block >> 7)) & 0x00AA00AA00AA00AAULL;
+	block ^= Swap ^ (Swap << 7);
+	Swap = (block ^ (block >> 14)) & 0x0000CCCC0000CCCCULL;
+	block ^= Swap ^ (Swap << 14);
+	Swap = (block ^ (block >> 28)) & 0x00000000F0F0F0F0ULL;
+	block ^= Swap ^ (Swap << 28);
+
+	return block;
+}
+
+/**
+ * copies columns of one panel page out of the frame buffer. When the panel is on its side the panel
+ * page is a band of 8 frame buffer columns, so it is put together 8x8 pixels at a time.
+ */
+static void GetPanelPage(SSD1306InstanceType * instance, uint32_t page, uint32_t firstColumn, uint32_t columns, uint8_t * destination) {
+	const uint8_t * Source;
+	uint64_t Block;
+	uint32_t Column = firstColumn;
+	uint32_t End = firstColumn + columns;
+	uint32_t BlockColumn;
+	int_fast8_t Index;
+
+	if(!IS_TRANSPOSED(instance->Config.Orientation)) {
+		memcpy(destination, &instance->Buffer[(page * instance->Config.Width) + firstColumn], columns);
 		return;
 	}
+
+	while(Column < End) {
+		BlockColumn = Column & ~(SCREEN_DATA_SIZE - 1);
+
+		// panel columns are frame buffer rows, so 8 of them are one frame buffer page
+		Source = &instance->Buffer[((BlockColumn / SCREEN_DATA_SIZE) * instance->Width) + (page * SCREEN_DATA_SIZE)];
+
+		Block = 0;
+		for(Index = SCREEN_DATA_SIZE - 1; Index >= 0; Index--) {
+			Block = (Block << 8) | Source[Index];
+		}
+
+		Block = Transpose8x8(Block);
+
+		for( ; Column < End && Column < BlockColumn + SCREEN_DATA_SIZE; Column++) {
+			*destination++ = (uint8_t)(Block >> ((Column - BlockColumn) * 8));
+		}
+	}
+}
+
+/**
+ * handles sending a window of the frame buffer in horizontal or vertical address mode. The window
+ * goes out as one data transfer after the column and page window has been set.
+ */
+static void SendDisplay(SSD1306InstanceType * instance, uint32_t firstColumn, uint32_t lastColumn, uint32_t firstPage, uint32_t lastPage) {
+	uint8_t Buffer[MAX_DISPLAY_BUFFER_SIZE + 10];
+	uint8_t PageData[SSD1306_MAX_WIDTH];
+	uint8_t ResetPointer[6];
+	uint8_t *BufferPointer;
+	uint32_t Columns = lastColumn - firstColumn + 1;
+	uint32_t PagesInWindow = lastPage - firstPage + 1;
+	uint32_t Column;
+	uint32_t Page;
+
 	Buffer[0] = (SET_DC_TO_DATA);
 	BufferPointer = &Buffer[1];
 
-	if(data && length) {
-
-		for( ; length ; length--) {
+	if(instance->Config.AddressMode == SSD1306_VerticalMode) {
+		// the controller fills a column at a time
+		for(Page = firstPage; Page <= lastPage; Page++) {
+			GetPanelPage(instance, Page, firstColumn, Columns, &PageData[0]);
 
-			*BufferPointer =  *data;
-			BufferPointer++;
-			data++;
-			LengthToSend++;
+			for(Column = 0; Column < Columns; Column++) {
+				BufferPointer[(Column * PagesInWindow) + (Page - firstPage)] = PageData[Column];
+			}
+		}
+		BufferPointer += Columns * PagesInWindow;
+	} else {
+		for(Page = firstPage; Page <= lastPage; Page++) {
+			GetPanelPage(instance, Page, firstColumn, Columns, BufferPointer);
+			BufferPointer += Columns;
 		}
 	}
 
 	// reset the pointer
-	SendGroupOfCommand(&ResetPointer[0], sizeof(ResetPointer));
+	ResetPointer[0] = CMD_SetColumnAddress;
+	ResetPointer[1] = instance->Config.ColumnOffset + firstColumn;
+	ResetPointer[2] = instance->Config.ColumnOffset + lastColumn;
+	ResetPointer[3] = CMD_SetPageAddress;
+	ResetPointer[4] = firstPage;
+	ResetPointer[5] = lastPage;
 
-	Interface->Write(&Buffer[0], LengthToSend);
+	SendGroupOfCommand(instance, &ResetPointer[0], sizeof(ResetPointer));
+
+	instance->Interface->Write(&Buffer[0], (uint32_t)(BufferPointer - &Buffer[0]));
+}
 
+/**
+ * handles sending a window of the frame buffer in page mode. Each page is a single transfer that
+ * sets the page and column address using continuation control bytes followed by the page data.
+ */
+static void SendDisplayPages(SSD1306InstanceType * instance, uint32_t firstColumn, uint32_t lastColumn, uint32_t firstPage, uint32_t lastPage) {
+	uint8_t Buffer[SSD1306_MAX_WIDTH + 10];
+	uint32_t Columns = lastColumn - firstColumn + 1;
+	uint8_t Column = instance->Config.ColumnOffset + firstColumn;
+	uint32_t Page;
+
+	for(Page = firstPage; Page <= lastPage; Page++) {
+		Buffer[0] = SET_CONTINUATION_BIT | SET_DC_TO_COMMAND;
+		Buffer[1] = CMD_SetPageStartAddressForPageMode | Page;
+		Buffer[2] = SET_CONTINUATION_BIT | SET_DC_TO_COMMAND;
+		Buffer[3] = CMD_SetLowerStartColumn | (Column & 0x0F);
+		Buffer[4] = SET_CONTINUATION_BIT | SET_DC_TO_COMMAND;
+		Buffer[5] = CMD_SetHigherStartColumn | (Column >> 4);
+		Buffer[6] = SET_DC_TO_DATA;
+
+		GetPanelPage(instance, Page, firstColumn, Columns, &Buffer[7]);
+
+		instance->Interface->Write(&Buffer[0], Columns + 7);
+	}
 }
 
+/**
+ * sends a window of the frame buffer using the configured address mode
+ */
+static void SendWindow(SSD1306InstanceType * instance, uint32_t firstColumn, uint32_t lastColumn, uint32_t firstPage, uint32_t lastPage) {
+	if(instance->Config.AddressMode == SSD1306_PageMode) {
+		SendDisplayPages(instance, firstColumn, lastColumn, firstPage, lastPage);
+	} else {
+		SendDisplay(instance, firstColumn, lastColumn, firstPage, lastPage);
+	}
+}
 
 /**
  * this function handle flushing out the Buffer content in to the screen
  */
-static void Sync(void) {
+static void Sync(SSD1306InstanceType * instance) {
+
+	if(!instance->Interface || !instance->Buffer) {
+		// error. no interface found
+		return;
+	}
+
+	SendWindow(instance, 0, instance->Config.Width - 1, 0, ((instance->Config.Height + SCREEN_DATA_SIZE - 1) / SCREEN_DATA_SIZE) - 1);
+
+	instance->Dirty = 0;
+	instance->SyncPending = 0;
+}
+
+/**
+ * starts sending the buffer a piece at a time. The dirty flag is taken now, so anything drawn
+ * from here on marks the buffer dirty again. Parts that SyncStep hasn't reached yet go out with
+ * the new drawing and parts it has already sent go out with the next sync.
+ */
+static void SyncBegin(SSD1306InstanceType * instance) {
+	if(!instance->Interface || !instance->Buffer || !instance->Dirty) {
+		return;
+	}
+
+	instance->Dirty = 0;
+	instance->SyncPending = 1;
+	instance->SyncPage = 0;
+	instance->SyncColumn = 0;
+}
+
+/**
+ * sends the next part of a sync started by SyncBegin, a page or part of a page per window. The
+ * window commands go out again with every window, so the transfer carries on exactly where the
+ * last call stopped whatever else was sent in between.
+ *
+ * @param budget bytes to send, commands and control bytes included. At least one column is sent
+ *
+ * @return true while more is left to send
+ */
+static uint_fast8_t SyncStep(SSD1306InstanceType * instance, uint32_t budget) {
+	uint32_t Columns = instance->Config.Width;
+	uint32_t Pages = (instance->Config.Height + SCREEN_DATA_SIZE - 1) / SCREEN_DATA_SIZE;
+	uint_fast8_t PageMode = instance->Config.AddressMode == SSD1306_PageMode;
+	uint32_t Overhead = PageMode ? SYNC_PAGE_OVERHEAD : SYNC_WINDOW_OVERHEAD;
+	uint_fast8_t Sent = 0;
+	uint32_t Count;
+	uint32_t Cost;
+
+	if(!instance->SyncPending || !instance->Interface || !instance->Buffer) {
+		instance->SyncPending = 0;
+		return 0;
+	}
+
+	while(instance->SyncPage < Pages) {
+		if(!instance->SyncColumn && budget >= (Overhead + Columns)) {
+			// as many whole pages as fit go out as one window
+			Count = PageMode ? budget / (Overhead + Columns) : (budget - Overhead) / Columns;
+			if(Count > (Pages - instance->SyncPage)) {
+				Count = Pages - instance->SyncPage;
+			}
+
+			SendWindow(instance, 0, Columns - 1, instance->SyncPage, instance->SyncPage + Count - 1);
+
+			Cost = PageMode ? Count * (Overhead + Columns) : Overhead + (Count * Columns);
+			instance->SyncPage += Count;
+		} else {
+			if(Sent && budget <= Overhead) {
+				break;
+			}
+
+			Count = budget > Overhead ? budget - Overhead : 1;
+			if(Count > (Columns - instance->SyncColumn)) {
+				Count = Columns - instance->SyncColumn;
+			}
+
+			SendWindow(instance, instance->SyncColumn, instance->SyncColumn + Count - 1, instance->SyncPage, instance->SyncPage);
+
+			Cost = Overhead + Count;
+			instance->SyncColumn += Count;
+
+			if(instance->SyncColumn >= Columns) {
+				instance->SyncColumn = 0;
+				instance->SyncPage++;
+			}
+		}
+
+		budget = budget > Cost ? budget - Cost : 0;
+		Sent = 1;
+	}
+
+	if(instance->SyncPage >= Pages) {
+		instance->SyncPending = 0;
+	}
+
+	return instance->SyncPending;
+}
+
+/**
+ * sends only the pages and columns that cover a rectangle. The rectangle is clipped to the panel.
+ *
+ * @note the buffer stays dirty unless the rectangle covers the whole panel, since other parts may still be pending
+ */
+static void SyncRegion(SSD1306InstanceType * instance, int32_t x, int32_t y, int32_t width, int32_t height) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+
+	if(!instance->Interface || !instance->Buffer) {
+		return;
+	}
+
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < 0) {
+		y = 0;
+	}
+	if(XEnd > (int32_t)instance->Width) {
+		XEnd = instance->Width;
+	}
+	if(YEnd > (int32_t)instance->Height) {
+		YEnd = instance->Height;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	if(!x && !y && XEnd == (int32_t)instance->Width && YEnd == (int32_t)instance->Height) {
+		Sync(instance);
+		return;
+	}
+
+	if(IS_TRANSPOSED(instance->Config.Orientation)) {
+		// rows are panel columns and columns are panel rows
+		SendWindow(instance, y, YEnd - 1, x / SCREEN_DATA_SIZE, (XEnd - 1) / SCREEN_DATA_SIZE);
+	} else {
+		SendWindow(instance, x, XEnd - 1, y / SCREEN_DATA_SIZE, (YEnd - 1) / SCREEN_DATA_SIZE);
+	}
+}
 
-	SendDisplay(&DisplayBuffer[0], DISPLAY_BUFFER_SIZE);
+/**
+ * @return true if the buffer has changed since the last sync
+ */
+static uint_fast8_t IsDirty(SSD1306InstanceType * instance) {
+	return instance->Dirty;
 }
 
 /**
@@ -251,12 +584,17 @@ static void Sync(void) {
  *
  * @note you will need to call ssd1306_Sync() to push the changes to the screen
  */
-static void Fill(monotoneColour value) {
+static void Fill(SSD1306InstanceType * instance, monotoneColour value) {
+	if(!instance->Buffer) {
+		return;
+	}
+
 	// select to either fill all of clear all
 	value = value ? 0xFF : 0x00;
 
 	// clear the buffer
-	memset(&DisplayBuffer[0], value, DISPLAY_BUFFER_SIZE);
+	memset(instance->Buffer, value, instance->BufferSize);
+	instance->Dirty = 1;
 }
 
 /**
@@ -264,8 +602,20 @@ static void Fill(monotoneColour value) {
  *
  * @note you will need to call ssd1306_Sync() to push the changes to the screen
  */
-static void Clear(void) {
-	Fill(ColourOff);
+static void Clear(SSD1306InstanceType * instance) {
+	Fill(instance, ColourOff);
+}
+
+/**
+ * copies a complete frame into the buffer. The source uses the buffer's page layout
+ */
+static void DirectWriteToBuffer(SSD1306InstanceType * instance, uint8_t * source) {
+	if(!instance->Buffer || !source) {
+		return;
+	}
+
+	memcpy(instance->Buffer, source, instance->BufferSize);
+	instance->Dirty = 1;
 }
 
 /**
@@ -273,85 +623,491 @@ static void Clear(void) {
  *
  * @param cleanScreenFlag
  */
-static void Close(uint_fast8_t cleanScreenFlag) {
-	if(!Interface) {
+static void Close(SSD1306InstanceType * instance, uint_fast8_t cleanScreenFlag) {
+	if(!instance->Interface) {
 		// error this is an invalid pointer
 		return;
 	}
 	if(cleanScreenFlag) {
-		Clear();
-		Sync();
+		Clear(instance);
+		Sync(instance);
 	}
 
-	Interface->Close();
+	instance->Interface->Close();
 }
 
 /**
- * this function handle drawing a pixel to the buffer
+ * this function handle drawing a pixel to the buffer. Pixels outside of the panel are ignored
  */
-static void SetPixel(uint32_t y, uint32_t x, uint8_t value) {
+static void SetPixel(SSD1306InstanceType * instance, uint32_t x, uint32_t y, uint8_t value) {
 	uint32_t PageOffset;
+	uint8_t Mask;
 
-	if(y > (SCREEN_WIDTH - 1)) {
-		y = (SCREEN_WIDTH - 1);
-	}
-
-	if(x > (SCREEN_HEIGHT - 1)) {
-		x = (SCREEN_WIDTH - 1);
+	if(x >= instance->Width || y >= instance->Height || !instance->Buffer) {
+		return;
 	}
 
 	// this operation is meant to discard the decimal points
-	PageOffset = (x / SCREEN_DATA_SIZE);
+	PageOffset = (y / SCREEN_DATA_SIZE) * instance->Width;
 
 	// before we work out the final page offset, lets calculate the bit fields offset
-	x = (x - (PageOffset * SCREEN_DATA_SIZE)) & 0xFF;
+	Mask = 0x01 << (y & (SCREEN_DATA_SIZE - 1));
+
+	instance->Dirty = 1;
 
-	// calculate the offset
-	PageOffset *= SCREEN_WIDTH;
+	if(value) {
+		instance->Buffer[x + PageOffset] |= Mask;
+	} else {
+		instance->Buffer[x + PageOffset] &= ~Mask;
+	}
 
+}
 
+/**
+ * @return the pixel in the buffer, 0 outside of the panel
+ */
+static uint_fast8_t GetPixel(SSD1306InstanceType * instance, uint32_t x, uint32_t y) {
+	if(x >= instance->Width || y >= instance->Height || !instance->Buffer) {
+		return 0;
+	}
 
+	return (instance->Buffer[x + ((y / SCREEN_DATA_SIZE) * instance->Width)] >> (y & (SCREEN_DATA_SIZE - 1))) & 0x01;
+}
 
-	if(value) {
-		DisplayBuffer[y + PageOffset] |= (0x01 << x);
+/**
+ * copies a run of page bytes out of the buffer
+ *
+ * @return the number of bytes copied
+ */
+static uint32_t ReadPage(SSD1306InstanceType * instance, int32_t x, int32_t page, uint8_t * destination, uint32_t length) {
+	if(!instance->Buffer || !destination || x < 0 || page < 0 ||
+			x >= (int32_t)instance->Width || page >= (int32_t)instance->Pages) {
+		return 0;
+	}
+
+	if(length > (instance->Width - x)) {
+		length = instance->Width - x;
+	}
+
+	memcpy(destination, &instance->Buffer[(page * instance->Width) + x], length);
+
+	return length;
+}
+
+/**
+ * sets or clears a rectangle in the buffer. Each page is handled with one mask per column
+ */
+static void FillRect(SSD1306InstanceType * instance, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+	uint32_t Page;
+	uint32_t LastPage;
+	uint8_t Mask;
+	uint8_t * Destination;
+	int32_t Column;
+
+	if(!instance->Buffer) {
+		return;
+	}
+
+	// clip to the panel
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < 0) {
+		y = 0;
+	}
+	if(XEnd > (int32_t)instance->Width) {
+		XEnd = instance->Width;
+	}
+	if(YEnd > (int32_t)instance->Height) {
+		YEnd = instance->Height;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	LastPage = (YEnd - 1) / SCREEN_DATA_SIZE;
+
+	for(Page = y / SCREEN_DATA_SIZE; Page <= LastPage; Page++) {
+		Mask = 0xFF;
+
+		if(Page == (uint32_t)(y / SCREEN_DATA_SIZE)) {
+			Mask &= 0xFF << (y & (SCREEN_DATA_SIZE - 1));
+		}
+		if(Page == LastPage) {
+			Mask &= 0xFF >> ((SCREEN_DATA_SIZE - 1) - ((YEnd - 1) & (SCREEN_DATA_SIZE - 1)));
+		}
+
+		Destination = &instance->Buffer[(Page * instance->Width) + x];
+
+		if(value) {
+			for(Column = x; Column < XEnd; Column++) {
+				*Destination++ |= Mask;
+			}
+		} else {
+			for(Column = x; Column < XEnd; Column++) {
+				*Destination++ &= ~Mask;
+			}
+		}
+	}
+
+	instance->Dirty = 1;
+}
+
+/**
+ * combines a run of page bytes into the buffer
+ *
+ * @param x the first column
+ * @param page the page to write to
+ * @param source one byte per column
+ * @param length number of columns
+ * @param mask only these bits of each byte are changed
+ * @param operation DisplayRasterOpType
+ */
+static void BlitPage(SSD1306InstanceType * instance, int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	int32_t XEnd = x + (int32_t)length;
+	uint8_t * Destination;
+	uint8_t Value;
+
+	if(!instance->Buffer || !source || page < 0 || page >= (int32_t)instance->Pages) {
+		return;
+	}
+
+	// clip to the panel
+	if(x < 0) {
+		source -= x;
+		x = 0;
+	}
+	if(XEnd > (int32_t)instance->Width) {
+		XEnd = instance->Width;
+	}
+	if(x >= XEnd) {
+		return;
+	}
+
+	Destination = &instance->Buffer[(page * instance->Width) + x];
+
+	switch(operation) {
+		case Raster_Or:
+			for( ; x < XEnd; x++) {
+				*Destination++ |= (*source++ & mask);
+			}
+		break;
+
+		case Raster_AndNot:
+			for( ; x < XEnd; x++) {
+				*Destination++ &= ~(*source++ & mask);
+			}
+		break;
+
+		case Raster_Xor:
+			for( ; x < XEnd; x++) {
+				*Destination++ ^= (*source++ & mask);
+			}
+		break;
+
+		case Raster_Copy:
+		default:
+			for( ; x < XEnd; x++) {
+				Value = *Destination;
+				*Destination++ = (Value & ~mask) | (*source++ & mask);
+			}
+		break;
+	}
+
+	instance->Dirty = 1;
+}
+
+/**
+ * sets the panel brightness. A step within the same drive level is a single 3 byte transfer, so it
+ * is cheap enough to fade with. 0 turns the panel off and anything else turns it back on.
+ *
+ * @note before Open the value is only kept and is sent with the configuration. Configure keeps it too
+ */
+static void SetBrightness(SSD1306InstanceType * instance, uint8_t value) {
+	uint8_t Commands[8];
+	uint8_t Length = 0;
+	uint8_t Last = instance->Brightness;
+
+	instance->BrightnessSet = 1;
+
+	if(value == Last) {
+		return;
+	}
+
+	instance->Brightness = value;
+
+	if(!instance->Interface) {
+		return;
+	}
+
+	if(!value) {
+		Commands[Length++] = CMD_SetDisplayOnOrOff;
 	} else {
-		DisplayBuffer[y + PageOffset] &= ~(0x01 << x);
+		// off leaves the drive level as it was, so compare against what was sent and not Last
+		if((value < SSD1306_DIM_LEVEL) != instance->DriveDim) {
+			BuildBrightness(instance, &Commands[Length]);
+			Length += 6;
+		} else {
+			Commands[Length++] = CMD_SetContrasControl;
+			Commands[Length++] = value;
+		}
+
+		if(!Last) {
+			Commands[Length++] = CMD_SetDisplayOnOrOff | 0x01;
+		}
 	}
 
+	SendGroupOfCommand(instance, &Commands[0], Length);
 }
 
+/**
+ * sends the configuration to the display and optionally clears it
+ *
+ * @param resetBuffer if true the buffer is cleared and sent
+ */
+static void Reset(SSD1306InstanceType * instance, uint_fast8_t resetBuffer) {
+	uint8_t DisplayInit[40];
+	uint8_t Length;
+
+	if(!instance->Interface) {
+		return;
+	}
+
+	Length = BuildDisplayInit(instance, &DisplayInit[0]);
+
+	// Configure the display
+	SendGroupOfCommand(instance, &DisplayInit[0], Length);
+
+	if(resetBuffer) {
+		Clear(instance);
+	}
+
+	Sync(instance);
+}
 
 /**
  * Configures the display
  */
-static void Open(GenericComInterface * interface) {
+static void Open(SSD1306InstanceType * instance, GenericComInterface * interface) {
 
 	if(!interface) {
 		// error this is an invalid pointer
 		return;
 	}
 
-	Interface = (I2CInterface*)interface;
+	// displays that weren't configured keep the original 128x32 panel
+	if(!instance->Buffer) {
+		SSD1306ConfigType Default = SSD1306_CONFIG_128X32;
 
-	// Configure the display
-	SendGroupOfCommand(&DisplayInit[0], sizeof(DisplayInit));
+		if(SSD1306Configure(Displays[instance - &Instances[0]], &Default)) {
+			return;
+		}
+	}
+
+	instance->Interface = (I2CInterface*)interface;
+
+	Reset(instance, 1);
+}
+
+/**
+ * @return the instance behind a display interface or NULL
+ */
+static SSD1306InstanceType * FindInstance(struct DisplayInterfaceType * display) {
+	uint_fast8_t Index;
+
+	for(Index = 0; Index < SSD1306_MAX_INSTANCES; Index++) {
+		if(Displays[Index] == display) {
+			return &Instances[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @return true if the panel can be used in the orientation
+ */
+static uint_fast8_t IsOrientationValid(const SSD1306ConfigType * config, uint_fast8_t orientation) {
+	if(orientation > (SSD1306_Rotate270 | SSD1306_Mirror)) {
+		return 0;
+	}
+
+	// on its side every frame buffer page must be a whole 8x8 block of panel pixels
+	if(IS_TRANSPOSED(orientation) && ((config->Width | config->Height) & (SCREEN_DATA_SIZE - 1))) {
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * sets the width and height that are drawn on from the panel and its orientation
+ */
+static void SetGeometry(SSD1306InstanceType * instance, struct DisplayInterfaceType * display) {
+	if(IS_TRANSPOSED(instance->Config.Orientation)) {
+		instance->Width = instance->Config.Height;
+		instance->Height = instance->Config.Width;
+	} else {
+		instance->Width = instance->Config.Width;
+		instance->Height = instance->Config.Height;
+	}
+
+	instance->Pages = (instance->Height + SCREEN_DATA_SIZE - 1) / SCREEN_DATA_SIZE;
+
+	display->Width = instance->Width;
+	display->Height = instance->Height;
+}
+
+int32_t SSD1306Configure(struct DisplayInterfaceType * display, const SSD1306ConfigType * config) {
+	SSD1306InstanceType * Instance = FindInstance(display);
+	uint32_t Pages;
+	uint32_t Size;
+
+	if(!Instance || !config || !config->Width || !config->Height ||
+			config->Width > SSD1306_MAX_WIDTH || config->Height > SSD1306_MAX_HEIGHT ||
+			!IsOrientationValid(config, config->Orientation)) {
+		return -EINVAL;
+	}
+
+	if(config->Controller == SH1106_Controller) {
+		if((config->ColumnOffset + config->Width) > SH1106_COLUMNS) {
+			return -EINVAL;
+		}
+	} else if((config->ColumnOffset + config->Width) > SSD1306_MAX_WIDTH) {
+		return -EINVAL;
+	}
+
+	Pages = (config->Height + SCREEN_DATA_SIZE - 1) / SCREEN_DATA_SIZE;
+	Size = Pages * config->Width;
+
+	Instance->Config = *config;
+
+	if(config->Controller == SH1106_Controller) {
+		Instance->Config.AddressMode = SSD1306_PageMode;
+	}
+
+	if(config->Buffer) {
+		Instance->Buffer = config->Buffer;
+	} else {
+		// reuse what we took from the pool before if it is big enough
+		if(!Instance->PoolBuffer || Instance->PoolBufferSize < Size) {
+			// the last part handed out can grow where it is
+			if(Instance->PoolBuffer && (Instance->PoolBuffer + Instance->PoolBufferSize) == &BufferPool[BufferPoolUsed]) {
+				BufferPoolUsed -= Instance->PoolBufferSize;
+				Instance->PoolBuffer = NULL;
+				Instance->PoolBufferSize = 0;
+			}
+
+			if((BufferPoolUsed + Size) > SSD1306_POOL_SIZE) {
+				Instance->Buffer = NULL;
+				return -ENOMEM;
+			}
+
+			Instance->PoolBuffer = &BufferPool[BufferPoolUsed];
+			Instance->PoolBufferSize = Size;
+			BufferPoolUsed += Size;
+		}
+
+		Instance->Buffer = Instance->PoolBuffer;
+	}
+
+	Instance->BufferSize = Size;
+	if(!Instance->BrightnessSet) {
+		Instance->Brightness = 0xFF;
+	}
+
+	SetGeometry(Instance, display);
+
+	memset(Instance->Buffer, 0, Size);
+	Instance->Dirty = 1;
+	Instance->SyncPending = 0;
+
+	return 0;
+}
+
+int32_t SSD1306SetOrientation(struct DisplayInterfaceType * display, uint8_t orientation) {
+	SSD1306InstanceType * Instance = FindInstance(display);
+	uint8_t Commands[2];
+
+	if(!Instance || !Instance->Buffer || !IsOrientationValid(&Instance->Config, orientation)) {
+		return -EINVAL;
+	}
+
+	if(IS_TRANSPOSED(orientation) != IS_TRANSPOSED(Instance->Config.Orientation)) {
+		// the buffer layout changes, what was drawn no longer makes sense
+		Instance->Config.Orientation = orientation;
+		SetGeometry(Instance, display);
+		Clear(Instance);
+	} else {
+		Instance->Config.Orientation = orientation;
+	}
+
+	if(Instance->Interface) {
+		BuildOrientation(orientation, &Commands[0]);
+		SendGroupOfCommand(Instance, &Commands[0], sizeof(Commands));
+	}
 
-	Clear();
-	Sync();
+	return 0;
 }
 
+/**
+ * creates the display interface functions for an instance
+ */
+#define SSD1306_INSTANCE_FUNCTIONS(n) \
+	static void Open##n(GenericComInterface * interface) { Open(&Instances[n], interface); } \
+	static void Reset##n(uint_fast8_t resetBuffer) { Reset(&Instances[n], resetBuffer); } \
+	static void Close##n(uint_fast8_t cleanScreenFlag) { Close(&Instances[n], cleanScreenFlag); } \
+	static void Sync##n(void) { Sync(&Instances[n]); } \
+	static void SyncRegion##n(int32_t x, int32_t y, int32_t width, int32_t height) { SyncRegion(&Instances[n], x, y, width, height); } \
+	static void SetPixel##n(uint32_t x, uint32_t y, uint8_t value) { SetPixel(&Instances[n], x, y, value); } \
+	static void DirectWriteToBuffer##n(uint8_t * source) { DirectWriteToBuffer(&Instances[n], source); } \
+	static void Clear##n(void) { Clear(&Instances[n]); } \
+	static void Fill##n(uint8_t value) { Fill(&Instances[n], value); } \
+	static uint_fast8_t IsDirty##n(void) { return IsDirty(&Instances[n]); } \
+	static void FillRect##n(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) { FillRect(&Instances[n], x, y, width, height, value); } \
+	static void BlitPage##n(int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) { BlitPage(&Instances[n], x, page, source, length, mask, operation); } \
+	static void SetBrightness##n(uint8_t value) { SetBrightness(&Instances[n], value); } \
+	static uint_fast8_t GetPixel##n(uint32_t x, uint32_t y) { return GetPixel(&Instances[n], x, y); } \
+	static uint32_t ReadPage##n(int32_t x, int32_t page, uint8_t * destination, uint32_t length) { return ReadPage(&Instances[n], x, page, destination, length); } \
+	static void SyncBegin##n(void) { SyncBegin(&Instances[n]); } \
+	static uint_fast8_t SyncStep##n(uint32_t budget) { return SyncStep(&Instances[n], budget); }
+
+/**
+ * the display interface initialiser for an instance
+ */
+#define SSD1306_INSTANCE(n) { \
+	Width: SSD1306_MAX_WIDTH, \
+	Height: 32, \
+	Open: Open##n, \
+	Reset: Reset##n, \
+	Close: Close##n, \
+	Sync: Sync##n, \
+	SetPixel: SetPixel##n, \
+	directWriteToBuffer: DirectWriteToBuffer##n, \
+	Clear: Clear##n, \
+	Fill: Fill##n, \
+	setBrightness: SetBrightness##n, \
+	IsDirty: IsDirty##n, \
+	FillRect: FillRect##n, \
+	BlitPage: BlitPage##n, \
+	SyncRegion: SyncRegion##n, \
+	GetPixel: GetPixel##n, \
+	ReadPage: ReadPage##n, \
+	SyncBegin: SyncBegin##n, \
+	SyncStep: SyncStep##n \
+}
 
+SSD1306_INSTANCE_FUNCTIONS(0)
+SSD1306_INSTANCE_FUNCTIONS(1)
+SSD1306_INSTANCE_FUNCTIONS(2)
+SSD1306_INSTANCE_FUNCTIONS(3)
 
 /**
  * defines the SSD1306 driver layer
  */
-struct DisplayInterfaceType SSD1306 = {
-	Width: SCREEN_WIDTH,
-	Height: SCREEN_HEIGHT,
-	Open: Open,
-	Close: Close,
-	Sync: Sync,
-	SetPixel: SetPixel,
-	Clear: Clear,
-	Fill: Fill
-};
+struct DisplayInterfaceType SSD1306 = SSD1306_INSTANCE(0);
+struct DisplayInterfaceType SSD1306_1 = SSD1306_INSTANCE(1);
+struct DisplayInterfaceType SSD1306_2 = SSD1306_INSTANCE(2);
+struct DisplayInterfaceType SSD1306_3 = SSD1306_INSTANCE(3);
@@ -11,6 +11,118 @@
 	#include "i2c.h"
 	#include "../displayDriver.h"
 
+	/**
+	 * defines how many displays the driver can run at the same time
+	 */
+	#define SSD1306_MAX_INSTANCES 4
+
+	/**
+	 * defines the largest panel the controllers support
+	 */
+	#define SSD1306_MAX_WIDTH 128
+	#define SSD1306_MAX_HEIGHT 64
+
+	/**
+	 * defines the brightness below which the pre-charge period and VCOMH level are lowered as well as
+	 * the contrast. Crossing it costs 7 command bytes instead of 3
+	 */
+	#ifndef SSD1306_DIM_LEVEL
+		#define SSD1306_DIM_LEVEL 0x20
+	#endif
+
+	/**
+	 * the SyncStep budget that takes about the given time on an I2C bus, at 9 clocks per byte
+	 */
+	#define SSD1306_SYNC_BUDGET(microseconds, clockHz) ((uint32_t)(((uint64_t)(microseconds) * (clockHz)) / 9000000u))
+
+	/**
+	 * defines the size of the frame buffer pool that is used by displays that aren't given a buffer.
+	 * By default every display can have the largest panel. A display that is configured again for a
+	 * larger panel grows its part of the pool in place when it was the last to take from it,
+	 * otherwise its old part is left unused
+	 */
+	#ifndef SSD1306_POOL_SIZE
+		#define SSD1306_POOL_SIZE (SSD1306_MAX_INSTANCES * ((SSD1306_MAX_WIDTH * SSD1306_MAX_HEIGHT) / 8))
+	#endif
+
+	/**
+	 * defines the supported controllers
+	 */
+	typedef enum {
+		SSD1306_Controller = 0,
+		SH1106_Controller		///< 132 column RAM, page addressing only
+	} SSD1306ControllerType;
+
+	/**
+	 * defines the controller addressing modes
+	 */
+	typedef enum {
+		SSD1306_HorizontalMode = 0x00,
+		SSD1306_VerticalMode = 0x01,
+		SSD1306_PageMode = 0x02
+	} SSD1306AddressModeType;
+
+	/**
+	 * defines how the picture is turned on the panel. 0 and 180 degrees and mirroring are done by the
+	 * controller's segment remap and COM scan direction, so they cost nothing. 90 and 270 degrees swap
+	 * the width and height and the frame buffer is transposed 8x8 pixels at a time as it is sent.
+	 */
+	typedef enum {
+		SSD1306_Rotate0 = 0,
+		SSD1306_Rotate90,			///< clockwise
+		SSD1306_Rotate180,
+		SSD1306_Rotate270,
+		SSD1306_Mirror = 0x04		///< add to any of the above to mirror the picture left to right
+	} SSD1306OrientationType;
+
+	/**
+	 * defines the panel configuration
+	 */
+	typedef struct SSD1306ConfigType {
+		SSD1306ControllerType Controller;
+		uint32_t Width;						///< visible columns
+		uint32_t Height;					///< visible rows
+		uint8_t ComPins;					///< COM pins hardware configuration. 0x02 sequential, 0x12 alternative
+		uint8_t ColumnOffset;				///< the RAM column of the first visible column
+		SSD1306AddressModeType AddressMode;	///< the mode used by Sync. SH1106 is always page mode
+		uint8_t Orientation;				///< SSD1306OrientationType. 90 and 270 need the width and height to be multiples of 8
+		uint8_t * Buffer;					///< frame buffer of Width * ((Height + 7) / 8) bytes, or NULL to take one from the pool
+	} SSD1306ConfigType;
+
+	/**
+	 * configuration for the common panels
+	 */
+	#define SSD1306_CONFIG_128X32 {Controller: SSD1306_Controller, Width: 128, Height: 32, ComPins: 0x02, ColumnOffset: 0, AddressMode: SSD1306_HorizontalMode, Orientation: SSD1306_Rotate0, Buffer: NULL}
+	#define SSD1306_CONFIG_128X64 {Controller: SSD1306_Controller, Width: 128, Height: 64, ComPins: 0x12, ColumnOffset: 0, AddressMode: SSD1306_HorizontalMode, Orientation: SSD1306_Rotate0, Buffer: NULL}
+	#define SSD1306_CONFIG_72X40 {Controller: SSD1306_Controller, Width: 72, Height: 40, ComPins: 0x12, ColumnOffset: 28, AddressMode: SSD1306_HorizontalMode, Orientation: SSD1306_Rotate0, Buffer: NULL}
+	#define SH1106_CONFIG_128X64 {Controller: SH1106_Controller, Width: 128, Height: 64, ComPins: 0x12, ColumnOffset: 2, AddressMode: SSD1306_PageMode, Orientation: SSD1306_Rotate0, Buffer: NULL}
+
+	/**
+	 * Configures a display's panel geometry. Call this before Open. A display that isn't
+	 * configured is a 128x32 SSD1306.
+	 *
+	 * @param display one of the SSD1306 display instances
+	 * @param config the panel configuration
+	 *
+	 * @return 0 on success, -EINVAL for an unsupported configuration or -ENOMEM if the pool is used up
+	 */
+	int32_t SSD1306Configure(struct DisplayInterfaceType * display, const SSD1306ConfigType * config);
+
+	/**
+	 * Changes the orientation of a display. Between 0 and 180 degrees and mirrored or not the picture
+	 * on the panel turns straight away without sending the frame buffer again. Going to or from 90
+	 * and 270 swaps the display width and height, clears the buffer and the picture must be redrawn.
+	 *
+	 * @param display one of the SSD1306 display instances
+	 * @param orientation SSD1306OrientationType
+	 *
+	 * @return 0 on success or -EINVAL for an unsupported orientation
+	 */
+	int32_t SSD1306SetOrientation(struct DisplayInterfaceType * display, uint8_t orientation);
+
 	extern struct DisplayInterfaceType SSD1306;
+	extern struct DisplayInterfaceType SSD1306_1;
+	extern struct DisplayInterfaceType SSD1306_2;
+	extern struct DisplayInterfaceType SSD1306_3;
 
 #endif /* __SSD1306_DIREVER_H__ */
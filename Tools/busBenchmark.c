@@ -0,0 +1,176 @@
+/*
+ * busBenchmark.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Renders a scripted screen sequence through the SSD1306 driver on top of the simulated I2C bus
+ *  (ExampleDriver/i2cSimulator.c) and reports the predicted frame time and frame rate for
+ *  standard, fast and fast plus mode buses.
+ *
+ *  build:
+ *      cc -O2 -include common.h -I. -o busBenchmark Tools/busBenchmark.c basicGraphics.c glyphCache.c \
+ *          ExampleDriver/ssd1306.c ExampleDriver/i2cSimulator.c Fonts/font_DejaVuSansMono.c
+ *
+ *  usage:
+ *      busBenchmark [-s stretch ns] [-g gap ns] [-r repeats] [-m minimum fps]
+ *
+ *  When a minimum frame rate is given the tool exits with 2 if the worst case frame on any bus
+ *  speed misses it, so it can gate a CI job.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "basicGraphics.h"
+#include "Fonts/font_DejaVuSansMono.h"
+#include "ExampleDriver/ssd1306.h"
+#include "ExampleDriver/i2cSimulator.h"
+
+/**
+ * the bus speeds that we report on
+ */
+static const uint32_t BusSpeeds[] = {100000, 400000, 1000000};
+
+/**
+ * draws the boot screen
+ */
+static void SceneBoot(uint32_t step) {
+	GraphicsInstance.Clear();
+	GraphicsInstance.WriteString((uint8_t *)"Booting", 30, 20, 1, NULL);
+	GraphicsInstance.drawRectagle(10, 24, 10 + (step % 100), 28, 1, 1);
+}
+
+/**
+ * draws a telemetry screen
+ */
+static void SceneTelemetry(uint32_t step) {
+	char Text[32];
+
+	GraphicsInstance.Clear();
+	snprintf(Text, sizeof(Text), "T %3u.%u C", 20 + (step % 10), step % 10);
+	GraphicsInstance.WriteString((uint8_t *)Text, 0, 12, 1, NULL);
+	snprintf(Text, sizeof(Text), "P %4u hPa", 1000 + (step % 30));
+	GraphicsInstance.WriteString((uint8_t *)Text, 0, 28, 1, NULL);
+}
+
+/**
+ * draws a trend plot
+ */
+static void SceneTrend(uint32_t step) {
+	int32_t X;
+
+	GraphicsInstance.Clear();
+	for(X = 0; X < 124; X += 4) {
+		GraphicsInstance.drawLine(X, 16 + ((X + step) % 12), X + 4, 16 + ((X + 4 + step) % 12), 1);
+	}
+}
+
+/**
+ * draws a gauge
+ */
+static void SceneGauge(uint32_t step) {
+	GraphicsInstance.Clear();
+	GraphicsInstance.drawCircle(64, 16, 15, 1, 0);
+	GraphicsInstance.drawLine(64, 16, 52 + (step % 24), 4, 1);
+}
+
+/**
+ * the screen sequence that we render
+ */
+static void (* const Scenes[])(uint32_t step) = {
+	SceneBoot,
+	SceneTelemetry,
+	SceneTrend,
+	SceneGauge
+};
+
+int main(int argc, char ** argv) {
+	I2CSimulatorConfigType Config = {ClockHz: 0, StretchNanoseconds: 0, GapNanoseconds: 0};
+	I2CSimulatorStatisticsType Statistics;
+	uint32_t Repeats = 10;
+	double MinimumFps = 0;
+	int Result = 0;
+	int Option;
+	uint32_t SpeedIndex;
+	uint32_t Step;
+	uint32_t SceneIndex;
+	uint32_t Frames;
+	uint64_t FrameTime;
+	uint64_t WorstTime;
+	uint64_t TotalTime;
+	double WorstFps;
+
+	while((Option = getopt(argc, argv, "s:g:r:m:")) != -1) {
+		switch(Option) {
+			case 's':
+				Config.StretchNanoseconds = strtoul(optarg, NULL, 0);
+			break;
+			case 'g':
+				Config.GapNanoseconds = strtoul(optarg, NULL, 0);
+			break;
+			case 'r':
+				Repeats = strtoul(optarg, NULL, 0);
+			break;
+			case 'm':
+				MinimumFps = strtod(optarg, NULL);
+			break;
+			default:
+				fprintf(stderr, "usage: %s [-s stretch ns] [-g gap ns] [-r repeats] [-m minimum fps]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	printf("bus_hz,frames,avg_frame_us,worst_frame_us,avg_fps,worst_fps,bytes,transactions\n");
+
+	for(SpeedIndex = 0; SpeedIndex < (sizeof(BusSpeeds) / sizeof(BusSpeeds[0])); SpeedIndex++) {
+		Config.ClockHz = BusSpeeds[SpeedIndex];
+		I2CSimulatorSetup(&Config);
+
+		I2CSimulator.Open(1, 0x3C);
+		SSD1306.Open((GenericComInterface *)&I2CSimulator);
+		GraphicsInstance.Init(&SSD1306, &DejaVuSansMono8pt7b);
+
+		// don't count the display configuration
+		I2CSimulatorSetup(&Config);
+
+		Frames = 0;
+		WorstTime = 0;
+		TotalTime = 0;
+
+		for(Step = 0; Step < Repeats; Step++) {
+			for(SceneIndex = 0; SceneIndex < (sizeof(Scenes) / sizeof(Scenes[0])); SceneIndex++) {
+				Scenes[SceneIndex](Step);
+				GraphicsInstance.Flush();
+
+				FrameTime = I2CSimulatorTakeFrameTime();
+				TotalTime += FrameTime;
+				if(FrameTime > WorstTime) {
+					WorstTime = FrameTime;
+				}
+				Frames++;
+			}
+		}
+
+		I2CSimulatorGetStatistics(&Statistics);
+
+		WorstFps = WorstTime ? (1e9 / (double)WorstTime) : 0;
+
+		printf("%u,%u,%.1f,%.1f,%.1f,%.1f,%u,%u\n",
+				Config.ClockHz,
+				Frames,
+				Frames ? ((double)TotalTime / Frames / 1000.0) : 0,
+				(double)WorstTime / 1000.0,
+				TotalTime ? (1e9 * Frames / (double)TotalTime) : 0,
+				WorstFps,
+				Statistics.Bytes,
+				Statistics.Transactions);
+
+		if(MinimumFps > 0 && WorstTime && WorstFps < MinimumFps) {
+			Result = 2;
+		}
+
+		GraphicsInstance.Destroy();
+	}
+
+	return Result;
+}
@@ -0,0 +1,148 @@
+/*
+ * fontFileBuilder.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Writes a compiled in font out as a font file (see fontFileFormat.h) for FontFile to load.
+ *
+ *  Fonts converted by fontconvert are added to Fonts, listed in the table below and built in
+ *  here, so new fonts and translations only need a font file on the target.
+ *
+ *  build:
+ *      cc -O2 -o fontFileBuilder Tools/fontFileBuilder.c Fonts/font_DejaVuSansMono.c
+ *
+ *  usage:
+ *      fontFileBuilder -l
+ *      fontFileBuilder font output.gfnt
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../fontFileFormat.h"
+#include "../Fonts/font_DejaVuSansMono.h"
+
+/**
+ * defines a font the tool can write
+ */
+typedef struct {
+	const char * Name;
+	const GFXfont * Font;
+} FontEntryType;
+
+/**
+ * the fonts built into the tool
+ */
+static const FontEntryType Fonts[] = {
+	{"DejaVuSansMono8pt7b", &DejaVuSansMono8pt7b}
+};
+
+/**
+ * writes a little endian value
+ */
+static void PutLittleEndian(uint8_t * destination, uint32_t value, uint_fast8_t size) {
+	while(size--) {
+		*destination++ = value & 0xFF;
+		value >>= 8;
+	}
+}
+
+static void Usage(const char * name) {
+	fprintf(stderr, "usage: %s -l | font output.gfnt\n", name);
+}
+
+int main(int argc, char ** argv) {
+	const GFXfont * Font = NULL;
+	const GFXglyph * Glyph;
+	uint8_t Header[FONT_FILE_HEADER_SIZE];
+	uint8_t * Table;
+	uint32_t GlyphCount;
+	uint32_t BitmapSize = 0;
+	uint32_t End;
+	uint32_t Index;
+	FILE * Output;
+	int Option;
+
+	while((Option = getopt(argc, argv, "l")) != -1) {
+		switch(Option) {
+			case 'l':
+				for(Index = 0; Index < sizeof(Fonts) / sizeof(Fonts[0]); Index++) {
+					printf("%s\n", Fonts[Index].Name);
+				}
+			return 0;
+
+			default:
+				Usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if(argc - optind != 2) {
+		Usage(argv[0]);
+		return 1;
+	}
+
+	for(Index = 0; Index < sizeof(Fonts) / sizeof(Fonts[0]); Index++) {
+		if(!strcmp(argv[optind], Fonts[Index].Name)) {
+			Font = Fonts[Index].Font;
+		}
+	}
+
+	if(!Font) {
+		fprintf(stderr, "unknown font %s, -l lists the fonts\n", argv[optind]);
+		return 1;
+	}
+
+	GlyphCount = Font->last - Font->first + 1;
+	Table = calloc(GlyphCount, FONT_FILE_GLYPH_SIZE);
+
+	for(Index = 0; Index < GlyphCount; Index++) {
+		Glyph = &Font->glyph[Index];
+
+		PutLittleEndian(&Table[(Index * FONT_FILE_GLYPH_SIZE) + 0], Glyph->bitmapOffset, 2);
+		Table[(Index * FONT_FILE_GLYPH_SIZE) + 2] = Glyph->width;
+		Table[(Index * FONT_FILE_GLYPH_SIZE) + 3] = Glyph->height;
+		Table[(Index * FONT_FILE_GLYPH_SIZE) + 4] = Glyph->xAdvance;
+		Table[(Index * FONT_FILE_GLYPH_SIZE) + 5] = (uint8_t)Glyph->xOffset;
+		Table[(Index * FONT_FILE_GLYPH_SIZE) + 6] = (uint8_t)Glyph->yOffset;
+
+		// the bitmaps end where the furthest glyph ends
+		End = Glyph->bitmapOffset + (((uint32_t)Glyph->width * Glyph->height) + 7) / 8;
+		if(End > BitmapSize) {
+			BitmapSize = End;
+		}
+	}
+
+	// the header size is a multiple of the alignment, so the table straight after it is aligned
+	memset(Header, 0, sizeof(Header));
+	memcpy(&Header[0], FONT_FILE_MAGIC, 4);
+	PutLittleEndian(&Header[4], FONT_FILE_VERSION, 2);
+	PutLittleEndian(&Header[6], FONT_FILE_HEADER_SIZE, 2);
+	Header[8] = Font->first;
+	Header[9] = Font->last;
+	Header[10] = Font->yAdvance;
+	Header[11] = Font->maxHeight;
+	PutLittleEndian(&Header[12], FONT_FILE_GLYPH_SIZE, 2);
+	PutLittleEndian(&Header[16], FONT_FILE_HEADER_SIZE, 4);
+	PutLittleEndian(&Header[20], GlyphCount, 4);
+	PutLittleEndian(&Header[24], FONT_FILE_HEADER_SIZE + (GlyphCount * FONT_FILE_GLYPH_SIZE), 4);
+	PutLittleEndian(&Header[28], BitmapSize, 4);
+
+	Output = fopen(argv[optind + 1], "wb");
+	if(!Output) {
+		fprintf(stderr, "failed to create %s\n", argv[optind + 1]);
+		return 1;
+	}
+
+	fwrite(Header, 1, sizeof(Header), Output);
+	fwrite(Table, 1, GlyphCount * FONT_FILE_GLYPH_SIZE, Output);
+	fwrite(Font->bitmap, 1, BitmapSize, Output);
+	fclose(Output);
+
+	fprintf(stderr, "%s: %u glyphs, %u bytes of bitmaps\n", argv[optind], GlyphCount, BitmapSize);
+
+	free(Table);
+
+	return 0;
+}
@@ -0,0 +1,292 @@
+/*
+ * frameSequenceBuilder.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Builds a frame sequence file (see frameSequenceFormat.h) from a list of PBM/PGM images.
+ *
+ *  Each frame after the first is stored as the windows that changed since the previous frame,
+ *  unless that would be no smaller than the full frame or a key frame is due.
+ *
+ *  build:
+ *      cc -O2 -o frameSequenceBuilder Tools/frameSequenceBuilder.c Tools/imageFile.c
+ *
+ *  usage:
+ *      frameSequenceBuilder [-d milliseconds] [-k key frame interval] output.fseq frame.pbm[:milliseconds] ...
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../frameSequenceFormat.h"
+#include "imageFile.h"
+
+/**
+ * defines a changed window
+ */
+typedef struct {
+	uint32_t FirstColumn;
+	uint32_t Columns;
+	uint32_t FirstPage;
+	uint32_t Pages;
+} WindowType;
+
+/**
+ * writes a little endian value
+ */
+static void PutLittleEndian(uint8_t * destination, uint32_t value, uint_fast8_t size) {
+	while(size--) {
+		*destination++ = value & 0xFF;
+		value >>= 8;
+	}
+}
+
+/**
+ * converts row major pixels into the page layout
+ */
+static void ToPages(const uint8_t * pixels, uint32_t width, uint32_t height, uint8_t * pages) {
+	uint32_t X;
+	uint32_t Y;
+
+	memset(pages, 0, width * ((height + 7) / 8));
+
+	for(Y = 0; Y < height; Y++) {
+		for(X = 0; X < width; X++) {
+			if(pixels[(Y * width) + X]) {
+				pages[((Y / 8) * width) + X] |= 1 << (Y & 7);
+			}
+		}
+	}
+}
+
+/**
+ * works out the changed windows between two frames. Neighbouring pages are joined into one
+ * window when that costs no more than sending them apart
+ *
+ * @return the number of windows
+ */
+static uint32_t FindWindows(const uint8_t * previous, const uint8_t * current, uint32_t width, uint32_t pages, WindowType * windows) {
+	uint32_t Count = 0;
+	uint32_t Page;
+	uint32_t First;
+	uint32_t Last;
+	uint32_t Joined;
+	uint32_t End;
+	WindowType * Window;
+
+	for(Page = 0; Page < pages; Page++) {
+		const uint8_t * A = &previous[Page * width];
+		const uint8_t * B = &current[Page * width];
+
+		for(First = 0; First < width && A[First] == B[First]; First++);
+
+		if(First == width) {
+			continue;
+		}
+
+		for(Last = width - 1; A[Last] == B[Last]; Last--);
+
+		Window = Count ? &windows[Count - 1] : NULL;
+
+		if(Window && Window->FirstPage + Window->Pages == Page) {
+			End = Window->FirstColumn + Window->Columns;
+			Joined = (First < Window->FirstColumn ? First : Window->FirstColumn);
+			End = (Last + 1 > End ? Last + 1 : End);
+
+			if(((End - Joined) * (Window->Pages + 1)) <=
+					(Window->Columns * Window->Pages) + (Last - First + 1) + FRAME_SEQUENCE_WINDOW_HEADER_SIZE) {
+				Window->FirstColumn = Joined;
+				Window->Columns = End - Joined;
+				Window->Pages++;
+				continue;
+			}
+		}
+
+		Window = &windows[Count++];
+		Window->FirstColumn = First;
+		Window->Columns = Last - First + 1;
+		Window->FirstPage = Page;
+		Window->Pages = 1;
+	}
+
+	return Count;
+}
+
+int main(int argc, char ** argv) {
+	uint32_t DefaultDuration = 100;
+	uint32_t KeyInterval = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t Pages = 0;
+	uint32_t FrameSize;
+	uint32_t FrameCount;
+	uint32_t Index;
+	uint32_t Window;
+	uint32_t Windows;
+	uint32_t DeltaSize;
+	uint32_t Page;
+	uint32_t DeltaFrames = 0;
+	uint8_t * Previous = NULL;
+	uint8_t * Current = NULL;
+	uint8_t * Data = NULL;
+	uint8_t * Table = NULL;
+	uint8_t * Pointer;
+	uint8_t Header[FRAME_SEQUENCE_HEADER_SIZE];
+	size_t DataSize = 0;
+	WindowType * WindowList = NULL;
+	FILE * Output;
+	int Option;
+
+	while((Option = getopt(argc, argv, "d:k:")) != -1) {
+		switch(Option) {
+			case 'd':
+				DefaultDuration = strtoul(optarg, NULL, 0);
+			break;
+
+			case 'k':
+				KeyInterval = strtoul(optarg, NULL, 0);
+			break;
+
+			default:
+				fprintf(stderr, "usage: %s [-d milliseconds] [-k key frame interval] output.fseq frame.pbm[:milliseconds] ...\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if(argc - optind < 2) {
+		fprintf(stderr, "usage: %s [-d milliseconds] [-k key frame interval] output.fseq frame.pbm[:milliseconds] ...\n", argv[0]);
+		return 1;
+	}
+
+	FrameCount = argc - optind - 1;
+	Table = calloc(FrameCount, FRAME_SEQUENCE_ENTRY_SIZE);
+
+	for(Index = 0; Index < FrameCount; Index++) {
+		char Path[1024];
+		char * Colon;
+		uint32_t Duration = DefaultDuration;
+		uint32_t ImageWidth;
+		uint32_t ImageHeight;
+		uint8_t * Pixels;
+		uint_fast8_t Delta;
+
+		snprintf(Path, sizeof(Path), "%s", argv[optind + 1 + Index]);
+		Colon = strrchr(Path, ':');
+		if(Colon) {
+			*Colon = 0;
+			Duration = strtoul(Colon + 1, NULL, 0);
+		}
+
+		if(Duration > 0xFFFF) {
+			Duration = 0xFFFF;
+		}
+
+		Pixels = ImageFileRead(Path, &ImageWidth, &ImageHeight);
+		if(!Pixels) {
+			fprintf(stderr, "failed to read %s\n", Path);
+			return 1;
+		}
+
+		if(!Index) {
+			Width = ImageWidth;
+			Height = ImageHeight;
+			Pages = (Height + 7) / 8;
+			FrameSize = Width * Pages;
+
+			if(Width > 0xFFFF || Pages > 0xFF) {
+				fprintf(stderr, "%s is too large\n", Path);
+				return 1;
+			}
+
+			Previous = calloc(1, FrameSize);
+			Current = calloc(1, FrameSize);
+			WindowList = calloc(Pages, sizeof(WindowType));
+		} else if(ImageWidth != Width || ImageHeight != Height) {
+			fprintf(stderr, "%s is %ux%u but the first frame is %ux%u\n", Path, ImageWidth, ImageHeight, Width, Height);
+			return 1;
+		}
+
+		ToPages(Pixels, Width, Height, Current);
+		free(Pixels);
+
+		Windows = FindWindows(Previous, Current, Width, Pages, WindowList);
+		DeltaSize = FRAME_SEQUENCE_DELTA_HEADER_SIZE;
+		for(Window = 0; Window < Windows; Window++) {
+			DeltaSize += FRAME_SEQUENCE_WINDOW_HEADER_SIZE + (WindowList[Window].Columns * WindowList[Window].Pages);
+		}
+
+		Delta = Index && !(KeyInterval && !(Index % KeyInterval)) && DeltaSize < FrameSize;
+
+		Data = realloc(Data, DataSize + (Delta ? DeltaSize : FrameSize));
+		Pointer = &Data[DataSize];
+
+		PutLittleEndian(&Table[(Index * FRAME_SEQUENCE_ENTRY_SIZE) + 0], FRAME_SEQUENCE_HEADER_SIZE + DataSize, 4);
+		PutLittleEndian(&Table[(Index * FRAME_SEQUENCE_ENTRY_SIZE) + 4], Delta ? DeltaSize : FrameSize, 4);
+		PutLittleEndian(&Table[(Index * FRAME_SEQUENCE_ENTRY_SIZE) + 8], Duration, 2);
+		Table[(Index * FRAME_SEQUENCE_ENTRY_SIZE) + 10] = Delta ? FrameSequence_Delta : FrameSequence_Full;
+
+		if(Delta) {
+			PutLittleEndian(Pointer, Windows, 2);
+			PutLittleEndian(Pointer + 2, 0, 2);
+			Pointer += FRAME_SEQUENCE_DELTA_HEADER_SIZE;
+
+			for(Window = 0; Window < Windows; Window++) {
+				WindowType * Changed = &WindowList[Window];
+
+				PutLittleEndian(&Pointer[0], Changed->FirstColumn, 2);
+				PutLittleEndian(&Pointer[2], Changed->Columns, 2);
+				Pointer[4] = Changed->FirstPage;
+				Pointer[5] = Changed->Pages;
+				PutLittleEndian(&Pointer[6], 0, 2);
+				Pointer += FRAME_SEQUENCE_WINDOW_HEADER_SIZE;
+
+				for(Page = Changed->FirstPage; Page < Changed->FirstPage + Changed->Pages; Page++) {
+					memcpy(Pointer, &Current[(Page * Width) + Changed->FirstColumn], Changed->Columns);
+					Pointer += Changed->Columns;
+				}
+			}
+
+			DataSize += DeltaSize;
+			DeltaFrames++;
+		} else {
+			memcpy(Pointer, Current, FrameSize);
+			DataSize += FrameSize;
+		}
+
+		memcpy(Previous, Current, FrameSize);
+	}
+
+	memcpy(&Header[0], FRAME_SEQUENCE_MAGIC, 4);
+	PutLittleEndian(&Header[4], FRAME_SEQUENCE_VERSION, 2);
+	PutLittleEndian(&Header[6], FRAME_SEQUENCE_HEADER_SIZE, 2);
+	PutLittleEndian(&Header[8], Width, 2);
+	PutLittleEndian(&Header[10], Height, 2);
+	Header[12] = FrameSequence_PageMonochrome;
+	Header[13] = 0;
+	PutLittleEndian(&Header[14], 0, 2);
+	PutLittleEndian(&Header[16], FrameCount, 4);
+	PutLittleEndian(&Header[20], FRAME_SEQUENCE_HEADER_SIZE + DataSize, 4);
+
+	Output = fopen(argv[optind], "wb");
+	if(!Output) {
+		fprintf(stderr, "failed to create %s\n", argv[optind]);
+		return 1;
+	}
+
+	fwrite(Header, 1, sizeof(Header), Output);
+	fwrite(Data, 1, DataSize, Output);
+	fwrite(Table, 1, FrameCount * FRAME_SEQUENCE_ENTRY_SIZE, Output);
+	fclose(Output);
+
+	fprintf(stderr, "%u frames of %ux%u, %u delta encoded, %zu bytes of frame data (%u if all full)\n",
+			FrameCount, Width, Height, DeltaFrames, DataSize, FrameCount * FrameSize);
+
+	free(Previous);
+	free(Current);
+	free(WindowList);
+	free(Data);
+	free(Table);
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * i2cReplay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Replays an I2C trace recorded by ExampleDriver/i2cRecorder.c through the SSD1306 emulator and
+ *  writes every frame out as an image, together with the bus cost of each frame.
+ *
+ *  A frame ends just before a message that would write to a part of the display RAM that has
+ *  already been written in the current frame. This works for full frames, partial windows and
+ *  page by page updates alike.
+ *
+ *  build:
+ *      cc -O2 -o i2cReplay Tools/i2cReplay.c Tools/ssd1306Emulator.c Tools/imageFile.c
+ *
+ *  usage:
+ *      i2cReplay trace.bin [output prefix] [pbm|png] [slave address] [RAM columns] [column offset]
+ *
+ *  For an SH1106 pass 132 RAM columns and the panel's column offset, normally 2. A slave address
+ *  of -1 replays every slave.
+ *
+ *  The per frame statistics are printed to stdout as CSV.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../ExampleDriver/i2cTrace.h"
+#include "ssd1306Emulator.h"
+#include "imageFile.h"
+
+/**
+ * defines the statistics we collect for each frame
+ */
+typedef struct {
+	uint32_t Transactions;		///< number of bus transactions
+	uint32_t Bytes;				///< payload bytes, control bytes included
+	uint32_t DataBytes;			///< bytes that ended up in GDDRAM
+	uint64_t StartMicroseconds;	///< time stamp of the first transaction
+	uint64_t EndMicroseconds;	///< time stamp of the last transaction
+} FrameStatisticsType;
+
+/**
+ * reads a little endian value
+ */
+static uint32_t GetLittleEndian(const uint8_t * source, uint_fast8_t size) {
+	uint32_t Value = 0;
+
+	while(size--) {
+		Value = (Value << 8) | source[size];
+	}
+
+	return Value;
+}
+
+/**
+ * writes out the current emulator frame and its statistics
+ */
+static void EmitFrame(SSD1306EmulatorType * emulator, FrameStatisticsType * statistics, uint32_t frameNumber, const char * prefix, const char * extension) {
+	static uint8_t Pixels[SSD1306_EMULATOR_COLUMNS * SSD1306_EMULATOR_PAGES * 8];
+	char Path[512];
+	uint32_t Height = SSD1306EmulatorHeight(emulator);
+
+	SSD1306EmulatorRender(emulator, &Pixels[0]);
+
+	snprintf(Path, sizeof(Path), "%s%04u.%s", prefix, frameNumber, extension);
+
+	if(ImageFileWrite(Path, SSD1306_EMULATOR_COLUMNS, Height, &Pixels[0])) {
+		fprintf(stderr, "failed to write %s\n", Path);
+	}
+
+	printf("%u,%llu,%llu,%u,%u,%u,%s\n",
+			frameNumber,
+			(unsigned long long)statistics->StartMicroseconds,
+			(unsigned long long)(statistics->EndMicroseconds - statistics->StartMicroseconds),
+			statistics->Transactions,
+			statistics->Bytes,
+			statistics->DataBytes,
+			Path);
+}
+
+int main(int argc, char ** argv) {
+	static SSD1306EmulatorType Emulator;
+	static SSD1306EmulatorType Scratch;
+	FrameStatisticsType Frame;
+	FrameStatisticsType Total;
+	FrameStatisticsType Pending;
+	I2CTraceRecordType Record;
+	uint8_t Header[I2C_TRACE_RECORD_HEADER_SIZE];
+	uint8_t * Payload = NULL;
+	uint32_t PayloadSize = 0;
+	uint32_t FrameNumber = 0;
+	uint32_t DataInFrame = 0;
+	uint32_t DataInMessage;
+	uint64_t Timestamp = 0;
+	const char * Prefix = "frame_";
+	const char * Extension = "pbm";
+	long SlaveFilter = -1;
+	long RamColumns = SSD1306_EMULATOR_COLUMNS;
+	long ColumnOffset = 0;
+	uint32_t HeaderSize;
+	FILE * Trace;
+
+	if(argc < 2) {
+		fprintf(stderr, "usage: %s trace.bin [output prefix] [pbm|png] [slave address] [RAM columns] [column offset]\n", argv[0]);
+		return 1;
+	}
+
+	if(argc > 2) {
+		Prefix = argv[2];
+	}
+
+	if(argc > 3) {
+		Extension = argv[3];
+	}
+
+	if(argc > 4) {
+		SlaveFilter = strtol(argv[4], NULL, 0);
+	}
+
+	if(argc > 5) {
+		RamColumns = strtol(argv[5], NULL, 0);
+	}
+
+	if(argc > 6) {
+		ColumnOffset = strtol(argv[6], NULL, 0);
+	}
+
+	if(RamColumns < SSD1306_EMULATOR_COLUMNS || RamColumns > SSD1306_EMULATOR_RAM_COLUMNS ||
+			ColumnOffset < 0 || (ColumnOffset + SSD1306_EMULATOR_COLUMNS) > RamColumns) {
+		fprintf(stderr, "the RAM must have %u to %u columns with the %u visible columns inside it\n",
+				SSD1306_EMULATOR_COLUMNS, SSD1306_EMULATOR_RAM_COLUMNS, SSD1306_EMULATOR_COLUMNS);
+		return 1;
+	}
+
+	Trace = fopen(argv[1], "rb");
+	if(!Trace) {
+		fprintf(stderr, "failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	if(fread(&Header[0], 1, I2C_TRACE_HEADER_SIZE, Trace) != I2C_TRACE_HEADER_SIZE ||
+			memcmp(&Header[0], I2C_TRACE_MAGIC, 4) ||
+			GetLittleEndian(&Header[4], 2) != I2C_TRACE_VERSION) {
+		fprintf(stderr, "%s is not a version %u I2C trace\n", argv[1], I2C_TRACE_VERSION);
+		fclose(Trace);
+		return 1;
+	}
+
+	// skip any header fields that a later version might have added
+	HeaderSize = GetLittleEndian(&Header[6], 2);
+	if(HeaderSize < I2C_TRACE_HEADER_SIZE || fseek(Trace, HeaderSize, SEEK_SET)) {
+		fprintf(stderr, "%s has a bad header size of %u\n", argv[1], HeaderSize);
+		fclose(Trace);
+		return 1;
+	}
+
+	SSD1306EmulatorReset(&Emulator);
+	SSD1306EmulatorSetColumns(&Emulator, RamColumns, ColumnOffset);
+	memset(&Frame, 0, sizeof(Frame));
+	memset(&Total, 0, sizeof(Total));
+	memset(&Pending, 0, sizeof(Pending));
+
+	printf("frame,start_us,duration_us,transactions,bytes,data_bytes,image\n");
+
+	while(fread(&Header[0], 1, I2C_TRACE_RECORD_HEADER_SIZE, Trace) == I2C_TRACE_RECORD_HEADER_SIZE) {
+		Record.DeltaMicroseconds = GetLittleEndian(&Header[0], 4);
+		Record.Length = GetLittleEndian(&Header[4], 4);
+		Record.SlaveAddress = Header[8];
+		Record.Flags = Header[9];
+
+		if(Record.Length > PayloadSize) {
+			Payload = realloc(Payload, Record.Length);
+			PayloadSize = Record.Length;
+			if(!Payload) {
+				fprintf(stderr, "out of memory\n");
+				fclose(Trace);
+				return 1;
+			}
+		}
+
+		if(fread(Payload, 1, Record.Length, Trace) != Record.Length) {
+			fprintf(stderr, "truncated record\n");
+			break;
+		}
+
+		Timestamp += Record.DeltaMicroseconds;
+
+		if((Record.Flags & I2C_TRACE_FLAG_READ) || !Record.Length ||
+				(SlaveFilter >= 0 && Record.SlaveAddress != SlaveFilter)) {
+			continue;
+		}
+
+		// try the message first to see if it starts a new frame
+		Scratch = Emulator;
+		DataInMessage = SSD1306EmulatorWrite(&Scratch, Payload, Record.Length);
+
+		if(DataInFrame && Scratch.Overwrites) {
+			EmitFrame(&Emulator, &Frame, FrameNumber++, Prefix, Extension);
+			memset(&Frame, 0, sizeof(Frame));
+			DataInFrame = 0;
+
+			SSD1306EmulatorStartFrame(&Emulator);
+			Scratch = Emulator;
+			DataInMessage = SSD1306EmulatorWrite(&Scratch, Payload, Record.Length);
+		}
+
+		Emulator = Scratch;
+
+		// command only messages belong to the frame whose data follows them
+		if(!Pending.Transactions) {
+			Pending.StartMicroseconds = Timestamp;
+		}
+		Pending.EndMicroseconds = Timestamp;
+		Pending.Transactions++;
+		Pending.Bytes += Record.Length;
+
+		Total.Transactions++;
+		Total.Bytes += Record.Length;
+
+		if(!DataInMessage) {
+			continue;
+		}
+
+		if(!Frame.Transactions) {
+			Frame.StartMicroseconds = Pending.StartMicroseconds;
+		}
+
+		Frame.EndMicroseconds = Timestamp;
+		Frame.Transactions += Pending.Transactions;
+		Frame.Bytes += Pending.Bytes;
+		Frame.DataBytes += DataInMessage;
+		DataInFrame = Frame.DataBytes;
+
+		memset(&Pending, 0, sizeof(Pending));
+	}
+
+	if(DataInFrame) {
+		Frame.Transactions += Pending.Transactions;
+		Frame.Bytes += Pending.Bytes;
+		EmitFrame(&Emulator, &Frame, FrameNumber++, Prefix, Extension);
+	}
+
+	fprintf(stderr, "%u frames, %u transactions, %u bytes, %u GDDRAM bytes, %u command bytes\n",
+			FrameNumber, Total.Transactions, Total.Bytes, Emulator.DataBytes, Emulator.CommandBytes);
+
+	free(Payload);
+	fclose(Trace);
+
+	return 0;
+}
@@ -0,0 +1,332 @@
+/*
+ * imageFile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Minimal 1 bit image readers and writers for the host side tools.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "imageFile.h"
+
+/**
+ * the largest block an uncompressed deflate block can hold
+ */
+#define DEFLATE_STORED_BLOCK_SIZE 65535
+
+/**
+ * packs one row of pixels into MSB first bits.
+ *
+ * @param litValue the bit value used for a lit pixel
+ */
+static void PackRow(uint8_t * destination, const uint8_t * pixels, uint32_t width, uint_fast8_t litValue) {
+	uint32_t Index;
+
+	memset(destination, litValue ? 0x00 : 0xFF, (width + 7) / 8);
+
+	for(Index = 0; Index < width; Index++) {
+		if(!pixels[Index]) {
+			continue;
+		}
+
+		if(litValue) {
+			destination[Index / 8] |= (0x80 >> (Index & 7));
+		} else {
+			destination[Index / 8] &= ~(0x80 >> (Index & 7));
+		}
+	}
+}
+
+int ImageFileWritePBM(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels) {
+	FILE * File;
+	uint8_t * Row;
+	uint32_t RowSize = (width + 7) / 8;
+	uint32_t Index;
+
+	File = fopen(path, "wb");
+	if(!File) {
+		return -1;
+	}
+
+	Row = malloc(RowSize ? RowSize : 1);
+	if(!Row) {
+		fclose(File);
+		return -1;
+	}
+
+	fprintf(File, "P4\n%u %u\n", width, height);
+
+	// PBM uses 1 for black so lit pixels are written as 0
+	for(Index = 0; Index < height; Index++) {
+		PackRow(Row, &pixels[Index * width], width, 0);
+		fwrite(Row, 1, RowSize, File);
+	}
+
+	free(Row);
+	fclose(File);
+
+	return 0;
+}
+
+/**
+ * updates a running PNG CRC32
+ */
+static uint32_t Crc32(uint32_t crc, const uint8_t * data, uint32_t length) {
+	static uint32_t Table[256];
+	static uint_fast8_t TableReady = 0;
+	uint32_t Index;
+	uint32_t Value;
+	uint_fast8_t Bit;
+
+	if(!TableReady) {
+		for(Index = 0; Index < 256; Index++) {
+			Value = Index;
+			for(Bit = 0; Bit < 8; Bit++) {
+				Value = (Value & 1) ? (0xEDB88320u ^ (Value >> 1)) : (Value >> 1);
+			}
+			Table[Index] = Value;
+		}
+		TableReady = 1;
+	}
+
+	crc = ~crc;
+	for(Index = 0; Index < length; Index++) {
+		crc = Table[(crc ^ data[Index]) & 0xFF] ^ (crc >> 8);
+	}
+
+	return ~crc;
+}
+
+/**
+ * stores the given value as big endian
+ */
+static void PutBigEndian(uint8_t * destination, uint32_t value) {
+	destination[0] = value >> 24;
+	destination[1] = value >> 16;
+	destination[2] = value >> 8;
+	destination[3] = value;
+}
+
+/**
+ * writes a complete PNG chunk
+ */
+static void WriteChunk(FILE * file, const char * type, const uint8_t * data, uint32_t length) {
+	uint8_t Header[8];
+	uint8_t Footer[4];
+	uint32_t Crc;
+
+	PutBigEndian(&Header[0], length);
+	memcpy(&Header[4], type, 4);
+
+	Crc = Crc32(0, (const uint8_t *)type, 4);
+	Crc = Crc32(Crc, data, length);
+	PutBigEndian(&Footer[0], Crc);
+
+	fwrite(Header, 1, sizeof(Header), file);
+	if(length) {
+		fwrite(data, 1, length, file);
+	}
+	fwrite(Footer, 1, sizeof(Footer), file);
+}
+
+int ImageFileWritePNG(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels) {
+	static const uint8_t Signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	FILE * File;
+	uint8_t Header[13];
+	uint8_t * Raw;
+	uint8_t * Stream;
+	uint8_t * StreamPointer;
+	uint32_t RowSize = ((width + 7) / 8) + 1;
+	uint32_t RawSize = RowSize * height;
+	uint32_t Blocks = (RawSize / DEFLATE_STORED_BLOCK_SIZE) + 1;
+	uint32_t Offset;
+	uint32_t BlockSize;
+	uint32_t AdlerA = 1;
+	uint32_t AdlerB = 0;
+	uint32_t Index;
+
+	Raw = malloc(RawSize + 1);
+	Stream = malloc(RawSize + (Blocks * 5) + 6);
+	File = fopen(path, "wb");
+
+	if(!Raw || !Stream || !File) {
+		free(Raw);
+		free(Stream);
+		if(File) {
+			fclose(File);
+		}
+		return -1;
+	}
+
+	// every row starts with the filter type which we leave as none
+	for(Index = 0; Index < height; Index++) {
+		Raw[Index * RowSize] = 0;
+		PackRow(&Raw[(Index * RowSize) + 1], &pixels[Index * width], width, 1);
+	}
+
+	for(Index = 0; Index < RawSize; Index++) {
+		AdlerA = (AdlerA + Raw[Index]) % 65521;
+		AdlerB = (AdlerB + AdlerA) % 65521;
+	}
+
+	// zlib header followed by stored deflate blocks
+	StreamPointer = Stream;
+	*StreamPointer++ = 0x78;
+	*StreamPointer++ = 0x01;
+
+	Offset = 0;
+	do {
+		BlockSize = RawSize - Offset;
+		if(BlockSize > DEFLATE_STORED_BLOCK_SIZE) {
+			BlockSize = DEFLATE_STORED_BLOCK_SIZE;
+		}
+
+		*StreamPointer++ = ((Offset + BlockSize) == RawSize) ? 0x01 : 0x00;
+		*StreamPointer++ = BlockSize & 0xFF;
+		*StreamPointer++ = BlockSize >> 8;
+		*StreamPointer++ = ~BlockSize & 0xFF;
+		*StreamPointer++ = (~BlockSize >> 8) & 0xFF;
+
+		memcpy(StreamPointer, &Raw[Offset], BlockSize);
+		StreamPointer += BlockSize;
+		Offset += BlockSize;
+	} while(Offset < RawSize);
+
+	PutBigEndian(StreamPointer, (AdlerB << 16) | AdlerA);
+	StreamPointer += 4;
+
+	PutBigEndian(&Header[0], width);
+	PutBigEndian(&Header[4], height);
+	Header[8] = 1;	// bit depth
+	Header[9] = 0;	// grey scale
+	Header[10] = 0;	// deflate
+	Header[11] = 0;	// adaptive filtering
+	Header[12] = 0;	// no interlace
+
+	fwrite(Signature, 1, sizeof(Signature), File);
+	WriteChunk(File, "IHDR", Header, sizeof(Header));
+	WriteChunk(File, "IDAT", Stream, (uint32_t)(StreamPointer - Stream));
+	WriteChunk(File, "IEND", NULL, 0);
+
+	free(Raw);
+	free(Stream);
+	fclose(File);
+
+	return 0;
+}
+
+int ImageFileWrite(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels) {
+	size_t Length = strlen(path);
+
+	if(Length > 4 && !strcmp(&path[Length - 4], ".png")) {
+		return ImageFileWritePNG(path, width, height, pixels);
+	}
+
+	return ImageFileWritePBM(path, width, height, pixels);
+}
+
+/**
+ * reads a header number, skipping white space and comments
+ */
+static int ReadNumber(FILE * file, uint32_t * value) {
+	int Character;
+
+	do {
+		Character = fgetc(file);
+
+		if(Character == '#') {
+			while(Character != '\n' && Character != EOF) {
+				Character = fgetc(file);
+			}
+		}
+	} while(Character == ' ' || Character == '\t' || Character == '\r' || Character == '\n');
+
+	if(Character < '0' || Character > '9') {
+		return -1;
+	}
+
+	*value = 0;
+
+	while(Character >= '0' && Character <= '9') {
+		*value = (*value * 10) + (Character - '0');
+		Character = fgetc(file);
+	}
+
+	// the white space after the last header number is part of the header
+	return 0;
+}
+
+uint8_t * ImageFileRead(const char * path, uint32_t * width, uint32_t * height) {
+	FILE * File;
+	uint8_t * Pixels = NULL;
+	uint8_t * Row = NULL;
+	uint32_t MaxValue = 1;
+	uint32_t RowSize;
+	uint32_t X;
+	uint32_t Y;
+	uint32_t Value;
+	char Magic[2];
+
+	File = fopen(path, "rb");
+	if(!File) {
+		return NULL;
+	}
+
+	if(fread(Magic, 1, 2, File) != 2 || Magic[0] != 'P' || (Magic[1] != '1' && Magic[1] != '4' && Magic[1] != '5') ||
+			ReadNumber(File, width) || ReadNumber(File, height) || !*width || !*height ||
+			(Magic[1] == '5' && (ReadNumber(File, &MaxValue) || !MaxValue || MaxValue > 255))) {
+		fclose(File);
+		return NULL;
+	}
+
+	Pixels = malloc((size_t)*width * *height);
+	RowSize = (Magic[1] == '4') ? (*width + 7) / 8 : *width;
+	Row = malloc(RowSize);
+
+	if(!Pixels || !Row) {
+		goto Failed;
+	}
+
+	for(Y = 0; Y < *height; Y++) {
+		if(Magic[1] == '1') {
+			// plain bits don't need white space between them
+			for(X = 0; X < *width; X++) {
+				do {
+					Value = fgetc(File);
+				} while(Value == ' ' || Value == '\t' || Value == '\r' || Value == '\n');
+
+				if(Value != '0' && Value != '1') {
+					goto Failed;
+				}
+				Pixels[(Y * *width) + X] = (Value == '0');
+			}
+			continue;
+		}
+
+		if(fread(Row, 1, RowSize, File) != RowSize) {
+			goto Failed;
+		}
+
+		for(X = 0; X < *width; X++) {
+			if(Magic[1] == '4') {
+				Pixels[(Y * *width) + X] = !(Row[X / 8] & (0x80 >> (X & 7)));
+			} else {
+				Pixels[(Y * *width) + X] = (Row[X] * 2) > MaxValue;
+			}
+		}
+	}
+
+	free(Row);
+	fclose(File);
+
+	return Pixels;
+
+Failed:
+	free(Pixels);
+	free(Row);
+	fclose(File);
+
+	return NULL;
+}
@@ -0,0 +1,52 @@
+/*
+ * imageFile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Minimal 1 bit image readers and writers for the host side tools.
+ */
+
+#ifndef __IMAGE_FILE_H__
+#define __IMAGE_FILE_H__
+
+	#include <stdint.h>
+
+	/**
+	 * Writes a binary PBM (P4) image. Lit pixels are written white, as they appear on the panel.
+	 *
+	 * @param path file to create
+	 * @param width image width
+	 * @param height image height
+	 * @param pixels one byte per pixel, row major. None zero means lit.
+	 *
+	 * @return 0 on success else -1
+	 */
+	int ImageFileWritePBM(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels);
+
+	/**
+	 * Writes a 1 bit grey scale PNG image using uncompressed deflate blocks.
+	 * Takes the same parameters as ImageFileWritePBM.
+	 *
+	 * @return 0 on success else -1
+	 */
+	int ImageFileWritePNG(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels);
+
+	/**
+	 * Writes either a PBM or a PNG depending on the path extension. Defaults to PBM.
+	 */
+	int ImageFileWrite(const char * path, uint32_t width, uint32_t height, const uint8_t * pixels);
+
+	/**
+	 * Reads a PBM (P1 or P4) or an 8 bit PGM (P5) image. PBM pixels are lit where the file is
+	 * white, matching ImageFileWritePBM, and PGM pixels are lit above mid grey.
+	 *
+	 * @param path file to read
+	 * @param width returns the image width
+	 * @param height returns the image height
+	 *
+	 * @return one byte per pixel, row major, none zero means lit. Free it with free(). NULL on failure
+	 */
+	uint8_t * ImageFileRead(const char * path, uint32_t * width, uint32_t * height);
+
+#endif /* __IMAGE_FILE_H__ */
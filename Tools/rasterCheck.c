@@ -0,0 +1,1234 @@
+/*
+ * rasterCheck.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Checks the drawing primitives of basicGraphics.c pixel for pixel against a deliberately naive
+ *  reference rasteriser that draws into a plain array of pixels.
+ *
+ *  Every random operation is drawn by the reference, by the library on a surface (the FillRect,
+ *  BlitPage and glyph cache fast paths) and by the library on a display that only has SetPixel and
+ *  GetPixel (the slow paths). The operations ParallelRender records are replayed through it on a
+ *  second surface. Canvases whose sides are multiples of 8 and fit a panel on its side are drawn on
+ *  an SSD1306 turned 90 or 270 degrees as well, which is synced to the emulator and read back from
+ *  the glass after every operation. The canvas size, the coordinates (off screen and negative
+ *  included), the colour, the font scale and the glyph cache state are all random.
+ *
+ *  The operations are the lines, rectangles, circles, text and icons below plus floodFill,
+ *  WriteInt and WriteFixed and Surface.Compose.
+ *
+ *  The reference describes what the library draws today, quirks included: lines and rectangles
+ *  clamp their end points to the display, a filled rectangle stops one column short of xEnd and
+ *  icons are drawn column by column with clear bits drawn in colour 0. Change it together with the
+ *  library when one of those is changed on purpose.
+ *
+ *  build:
+ *      cc -O1 -g -fsanitize=address,undefined -include common.h -I. -o rasterCheck Tools/rasterCheck.c \
+ *          Tools/imageFile.c Tools/ssd1306Emulator.c basicGraphics.c glyphCache.c surface.c parallelRender.c \
+ *          workerPool.c ExampleDriver/ssd1306.c Fonts/font_DejaVuSansMono.c -lpthread
+ *
+ *  usage:
+ *      rasterCheck [-s seed] [-n canvases] [-o operations per canvas] [-w golden directory] [-g golden directory]
+ *
+ *  -w writes the golden scenes as PBM images and -g compares the library against images written
+ *  earlier. The golden scenes are kept in Tools/golden. The tool exits with 1 on the first
+ *  difference and prints the operation that caused it.
+ *
+ *  Built with -DRASTER_CHECK_FUZZER and -fsanitize=fuzzer the tool is a libFuzzer target instead,
+ *  where the fuzzer's input drives the random choices.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "basicGraphics.h"
+#include "glyphCache.h"
+#include "surface.h"
+#include "parallelRender.h"
+#include "ExampleDriver/ssd1306.h"
+#include "Fonts/font_DejaVuSansMono.h"
+#include "imageFile.h"
+#include "ssd1306Emulator.h"
+
+/**
+ * defines the largest canvas that is checked
+ */
+#define MAX_WIDTH 160
+#define MAX_HEIGHT 72
+
+/**
+ * how far off the canvas coordinates may go
+ */
+#define COORDINATE_RANGE 256
+
+/**
+ * defines the largest surface that is composed onto the canvas
+ */
+#define SOURCE_WIDTH 64
+#define SOURCE_HEIGHT 48
+
+/**
+ * the threads ParallelRender draws with
+ */
+#define PARALLEL_THREADS 4
+
+/**
+ * defines the operations that are checked
+ */
+typedef enum {
+	Operation_Line = 0,
+	Operation_Rectangle,
+	Operation_Circle,
+	Operation_Text,
+	Operation_Icon,
+	Operation_FloodFill,
+	Operation_Number,
+	Operation_Compose,
+	Operation_Count
+} OperationType;
+
+#ifndef RASTER_CHECK_FUZZER
+/**
+ * names of the operations, for the report
+ */
+static const char * const OperationNames[Operation_Count] = {"drawLine", "drawRectagle", "drawCircle", "WriteStringScaled", "drawIcon",
+		"floodFill", "WriteInt/WriteFixed", "Surface.Compose"};
+#endif
+
+/**
+ * the canvas size
+ */
+static int32_t Width;
+static int32_t Height;
+
+/**
+ * the reference canvas and the canvas of the SetPixel only display, one byte per pixel
+ */
+static uint8_t Reference[MAX_WIDTH * MAX_HEIGHT];
+static uint8_t Pixels[MAX_WIDTH * MAX_HEIGHT];
+
+/**
+ * the reference before a flood fill, for fills that stop part way
+ */
+static uint8_t Before[MAX_WIDTH * MAX_HEIGHT];
+
+/**
+ * the surface the library draws into with its fast paths
+ */
+static SurfaceType Canvas;
+static uint8_t CanvasMemory[SURFACE_BUFFER_SIZE(MAX_WIDTH, MAX_HEIGHT)];
+
+/**
+ * the surface ParallelRender draws into and the memory it records into
+ */
+static SurfaceType ParallelCanvas;
+static uint8_t ParallelCanvasMemory[SURFACE_BUFFER_SIZE(MAX_WIDTH, MAX_HEIGHT)];
+static uint8_t ParallelMemory[4096];
+
+/**
+ * the surface that is composed onto the canvas
+ */
+static SurfaceType Source;
+static uint8_t SourceMemory[SURFACE_BUFFER_SIZE(SOURCE_WIDTH, SOURCE_HEIGHT)];
+
+/**
+ * the panel turned on its side, what the emulator shows on it and how it is turned. 0 when the
+ * canvas doesn't fit a panel
+ */
+static uint8_t PanelBuffer[SURFACE_BUFFER_SIZE(SSD1306_MAX_WIDTH, SSD1306_MAX_HEIGHT)];
+static SSD1306EmulatorType Emulator;
+static uint8_t PanelPixels[SSD1306_EMULATOR_COLUMNS * SSD1306_EMULATOR_PAGES * 8];
+static uint8_t PanelOrientation;
+
+/**
+ * glyph cache memory. It is sometimes left disabled or made too small for some glyphs
+ */
+static uint8_t CacheMemory[4096];
+
+/**
+ * the random state, or the fuzzer input that replaces it
+ */
+static uint64_t RandomState;
+static const uint8_t * FuzzData;
+static size_t FuzzSize;
+
+/**
+ * how many operations of each kind were checked
+ */
+static uint32_t Checked[Operation_Count];
+static uint32_t PanelChecked;
+static uint32_t ParallelChecked;
+
+/**
+ * the description of the operation being checked
+ */
+static char Description[600];
+
+/**
+ * returns the next random value. The fuzzer input is used first when there is one
+ */
+static uint32_t NextRandom(void) {
+	uint32_t Value = 0;
+	uint_fast8_t Index;
+
+	if(FuzzData) {
+		for(Index = 0; Index < 4 && FuzzSize; Index++, FuzzSize--) {
+			Value = (Value << 8) | *FuzzData++;
+		}
+
+		return Value;
+	}
+
+	RandomState ^= RandomState << 13;
+	RandomState ^= RandomState >> 7;
+	RandomState ^= RandomState << 17;
+
+	return (uint32_t)(RandomState >> 16);
+}
+
+/**
+ * returns a random value from minimum to maximum, both included
+ */
+static int32_t RandomRange(int32_t minimum, int32_t maximum) {
+	return minimum + (int32_t)(NextRandom() % (uint32_t)(maximum - minimum + 1));
+}
+
+/**
+ * returns a coordinate that is mostly on the canvas but often off it
+ */
+static int32_t RandomCoordinate(int32_t size) {
+	switch(NextRandom() & 3) {
+		case 0:
+			return RandomRange(-COORDINATE_RANGE, size + COORDINATE_RANGE);
+
+		case 1:
+			return RandomRange(-2, 1) + ((NextRandom() & 1) ? size : 0);
+
+		default:
+			return RandomRange(0, size - 1);
+	}
+}
+
+/**
+ * The SetPixel display. GetPixel is only there for floodFill to read with, everything else the
+ * library needs is left out so it takes its slow paths
+ */
+static void PixelSetPixel(uint32_t x, uint32_t y, uint8_t value) {
+	if(x < (uint32_t)Width && y < (uint32_t)Height) {
+		Pixels[(y * Width) + x] = value ? 1 : 0;
+	}
+}
+
+static uint_fast8_t PixelGetPixel(uint32_t x, uint32_t y) {
+	if(x < (uint32_t)Width && y < (uint32_t)Height) {
+		return Pixels[(y * Width) + x];
+	}
+
+	return 0;
+}
+
+static DisplayInterfaceType PixelDisplay = {
+	SetPixel: PixelSetPixel,
+	GetPixel: PixelGetPixel
+};
+
+/**
+ * the bus the panel is sent over, straight into the emulator
+ */
+static void EmulatorOpen(uint_fast8_t port, uint8_t address) {
+	(void)port;
+	(void)address;
+}
+
+static void EmulatorClose(void) {
+}
+
+static void EmulatorWrite(uint8_t * source, uint32_t length) {
+	SSD1306EmulatorWrite(&Emulator, source, length);
+}
+
+static void EmulatorRead(uint8_t * destination, uint32_t length) {
+	memset(destination, 0, length);
+}
+
+static int32_t EmulatorTryWrite(uint8_t * source, uint32_t length) {
+	EmulatorWrite(source, length);
+	return (int32_t)length;
+}
+
+static I2CInterface EmulatorInterface = {
+	Open: EmulatorOpen,
+	Close: EmulatorClose,
+	Write: EmulatorWrite,
+	Read: EmulatorRead,
+	TryWrite: EmulatorTryWrite
+};
+
+/**
+ * reference pixel. Pixels off the canvas are dropped
+ */
+static void ReferencePixel(int32_t x, int32_t y, uint_fast8_t colour) {
+	if(x >= 0 && y >= 0 && x < Width && y < Height) {
+		Reference[(y * Width) + x] = colour ? 1 : 0;
+	}
+}
+
+/**
+ * reference clamp of a point to the canvas, as lines and rectangles do
+ */
+static void ReferenceClamp(int32_t * x, int32_t * y) {
+	*x = *x < 0 ? 0 : (*x >= Width ? Width - 1 : *x);
+	*y = *y < 0 ? 0 : (*y >= Height ? Height - 1 : *y);
+}
+
+/**
+ * reference line. The end points are clamped, then the line is walked one pixel at a time
+ */
+static void ReferenceLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint_fast8_t colour) {
+	int32_t DeltaX;
+	int32_t DeltaY;
+	int32_t Error;
+	int32_t Step;
+
+	ReferenceClamp(&x0, &y0);
+	ReferenceClamp(&x1, &y1);
+
+	DeltaX = abs(x1 - x0);
+	DeltaY = abs(y1 - y0);
+	Error = (DeltaX > DeltaY ? DeltaX : -DeltaY) / 2;
+
+	for(;;) {
+		ReferencePixel(x0, y0, colour);
+
+		if(x0 == x1 && y0 == y1) {
+			break;
+		}
+
+		Step = Error;
+
+		if(Step > -DeltaX) {
+			Error -= DeltaY;
+			x0 += x0 < x1 ? 1 : -1;
+		}
+		if(Step < DeltaY) {
+			Error += DeltaX;
+			y0 += y0 < y1 ? 1 : -1;
+		}
+	}
+}
+
+/**
+ * reference rectangle. A filled rectangle is every column from x0 up to, but not including, x1
+ */
+static void ReferenceRectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint_fast8_t colour, uint_fast8_t fill) {
+	int32_t X;
+	int32_t Y;
+
+	ReferenceClamp(&x0, &y0);
+	ReferenceClamp(&x1, &y1);
+
+	if(fill) {
+		for(X = x0; X != x1; X += (x1 < x0 ? -1 : 1)) {
+			for(Y = (y0 < y1 ? y0 : y1); Y <= (y0 < y1 ? y1 : y0); Y++) {
+				ReferencePixel(X, Y, colour);
+			}
+		}
+		return;
+	}
+
+	ReferenceLine(x0, y0, x0, y1, colour);
+	ReferenceLine(x0, y0, x1, y0, colour);
+	ReferenceLine(x1, y1, x1, y0, colour);
+	ReferenceLine(x1, y1, x0, y1, colour);
+}
+
+/**
+ * reference circle. The centre is clamped and the outline points are the midpoint circle ones
+ */
+static void ReferenceCircle(int32_t x0, int32_t y0, int32_t radius, uint_fast8_t colour, uint_fast8_t fill) {
+	int32_t X = radius - 1;
+	int32_t Y = 0;
+	int32_t DeltaX = 1;
+	int32_t DeltaY = 1;
+	int32_t Error = DeltaX - (radius * 2);
+	int32_t Octant;
+	int32_t PointX;
+	int32_t PointY;
+
+	ReferenceClamp(&x0, &y0);
+
+	while(X >= Y) {
+		for(Octant = 0; Octant < 8; Octant++) {
+			PointX = (Octant & 4) ? Y : X;
+			PointY = (Octant & 4) ? X : Y;
+			PointX = (Octant & 1) ? -PointX : PointX;
+			PointY = (Octant & 2) ? -PointY : PointY;
+
+			if(fill) {
+				// each span is a clamped line across the circle
+				ReferenceLine(x0 + PointX, y0 + PointY, x0 - PointX, y0 + PointY, colour);
+			} else {
+				ReferencePixel(x0 + PointX, y0 + PointY, colour);
+			}
+		}
+
+		if(Error <= 0) {
+			Y++;
+			Error += DeltaY;
+			DeltaY += 2;
+		}
+		if(Error > 0) {
+			X--;
+			DeltaX += 2;
+			Error += DeltaX - (radius * 2);
+		}
+	}
+}
+
+/**
+ * reference text. Every set bit of a glyph is a scaleX by scaleY block
+ */
+static void ReferenceText(const uint8_t * text, int32_t x, int32_t y, uint_fast8_t colour, const GFXfont * font, uint_fast8_t scaleX, uint_fast8_t scaleY) {
+	const GFXglyph * Glyph;
+	uint32_t Bit;
+	int32_t Row;
+	int32_t Column;
+	int32_t BlockX;
+	int32_t BlockY;
+
+	scaleX = !scaleX ? 1 : (scaleX > BASIC_GRAPHICS_MAX_FONT_SCALE ? BASIC_GRAPHICS_MAX_FONT_SCALE : scaleX);
+	scaleY = !scaleY ? 1 : (scaleY > BASIC_GRAPHICS_MAX_FONT_SCALE ? BASIC_GRAPHICS_MAX_FONT_SCALE : scaleY);
+
+	for( ; *text; text++) {
+		if(*text < font->first || *text > font->last) {
+			continue;
+		}
+
+		Glyph = &font->glyph[*text - font->first];
+		Bit = Glyph->bitmapOffset * 8;
+
+		for(Row = 0; Row < Glyph->height; Row++) {
+			for(Column = 0; Column < Glyph->width; Column++, Bit++) {
+				if(!(font->bitmap[Bit / 8] & (0x80 >> (Bit & 7)))) {
+					continue;
+				}
+
+				for(BlockY = 0; BlockY < scaleY; BlockY++) {
+					for(BlockX = 0; BlockX < scaleX; BlockX++) {
+						ReferencePixel(x + ((Glyph->xOffset + Column) * scaleX) + BlockX,
+								y + ((Glyph->yOffset + Row) * scaleY) + BlockY, colour);
+					}
+				}
+			}
+		}
+
+		x += Glyph->xAdvance * scaleX;
+	}
+}
+
+/**
+ * reference icon. Bits run down each column, most significant bit first, and clear bits draw colour 0
+ */
+static void ReferenceIcon(int32_t x, int32_t y, uint32_t height, uint32_t width, uint_fast8_t colour, const uint32_t * source) {
+	uint32_t Bit;
+
+	for(Bit = 0; Bit < width * height; Bit++) {
+		ReferencePixel(x + (Bit / height), y + (Bit % height), ((source[Bit / 32] << (Bit & 31)) & 0x80000000) ? colour : 0);
+	}
+}
+
+/**
+ * reference flood fill. Every pixel of the other colour that joins the seed up, down, left or right
+ * is filled, one pixel at a time
+ */
+static void ReferenceFloodFill(int32_t x, int32_t y, uint_fast8_t colour) {
+	static const int8_t Neighbours[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	static int32_t Stack[MAX_WIDTH * MAX_HEIGHT];
+	uint32_t Depth = 0;
+	uint_fast8_t Index;
+	int32_t Pixel;
+	int32_t X;
+	int32_t Y;
+
+	colour = colour ? 1 : 0;
+
+	if(x < 0 || y < 0 || x >= Width || y >= Height || Reference[(y * Width) + x] == colour) {
+		return;
+	}
+
+	// every pixel is filled as it is pushed, so none is pushed twice
+	Reference[(y * Width) + x] = colour;
+	Stack[Depth++] = (y * Width) + x;
+
+	while(Depth) {
+		Pixel = Stack[--Depth];
+
+		for(Index = 0; Index < 4; Index++) {
+			X = (Pixel % Width) + Neighbours[Index][0];
+			Y = (Pixel / Width) + Neighbours[Index][1];
+
+			if(X >= 0 && Y >= 0 && X < Width && Y < Height && Reference[(Y * Width) + X] != colour) {
+				Reference[(Y * Width) + X] = colour;
+				Stack[Depth++] = (Y * Width) + X;
+			}
+		}
+	}
+}
+
+/**
+ * reference number. The number is formatted with snprintf and drawn as text. Zero padding stops
+ * one short of the widest field, which keeps a place for the sign, and the field is cleared over
+ * the height of all the number glyphs
+ */
+static void ReferenceNumber(int32_t value, uint_fast8_t decimals, int32_t x, int32_t y, uint_fast8_t width, uint_fast8_t flags, uint_fast8_t colour, const GFXfont * font) {
+	static const char NumberCharacters[] = "0123456789-+. ";
+	const GFXglyph * Glyph;
+	char Digits[24];
+	char Sign[2] = {0, 0};
+	char Text[BASIC_GRAPHICS_MAX_NUMBER_WIDTH + sizeof(Digits)];	// the padding, sign and zeros fit in the field width
+	int32_t Length;
+	int32_t Pad;
+	int32_t Zeros = 0;
+	int32_t FieldWidth = 0;
+	int32_t Top = 0;
+	int32_t Bottom = 0;
+	int32_t Row;
+	int32_t Column;
+	uint32_t Index;
+
+	if(value < 0) {
+		Sign[0] = '-';
+	} else if(flags & Number_ShowSign) {
+		Sign[0] = '+';
+	}
+
+	Length = snprintf(Digits, sizeof(Digits), "%0*lld", decimals + 1, llabs((long long)value));
+
+	if(decimals) {
+		memmove(&Digits[Length - decimals + 1], &Digits[Length - decimals], decimals + 1);
+		Digits[Length - decimals] = '.';
+		Length++;
+	}
+
+	if(width > BASIC_GRAPHICS_MAX_NUMBER_WIDTH) {
+		width = BASIC_GRAPHICS_MAX_NUMBER_WIDTH;
+	}
+
+	Pad = width - Length - (Sign[0] ? 1 : 0);
+	if(Pad < 0) {
+		Pad = 0;
+	}
+
+	if(flags & Number_PadZero) {
+		Zeros = Pad < (BASIC_GRAPHICS_MAX_NUMBER_WIDTH - 1 - Length) ? Pad : (BASIC_GRAPHICS_MAX_NUMBER_WIDTH - 1 - Length);
+		Pad -= Zeros;
+	}
+
+	Index = 0;
+	memset(&Text[Index], ' ', Pad);
+	Index += Pad;
+	if(Sign[0]) {
+		Text[Index++] = Sign[0];
+	}
+	memset(&Text[Index], '0', Zeros);
+	Index += Zeros;
+	memcpy(&Text[Index], Digits, Length + 1);
+
+	for(Index = 0; Text[Index]; Index++) {
+		FieldWidth += font->glyph[(uint8_t)Text[Index] - font->first].xAdvance;
+	}
+
+	if(flags & Number_RightAlign) {
+		x -= FieldWidth;
+	}
+
+	if(flags & Number_ClearField) {
+		for(Index = 0; NumberCharacters[Index]; Index++) {
+			Glyph = &font->glyph[(uint8_t)NumberCharacters[Index] - font->first];
+
+			if(Glyph->width && Glyph->height) {
+				Top = Glyph->yOffset < Top ? Glyph->yOffset : Top;
+				Bottom = (Glyph->yOffset + Glyph->height) > Bottom ? (Glyph->yOffset + Glyph->height) : Bottom;
+			}
+		}
+
+		for(Row = y + Top; Row < y + Bottom; Row++) {
+			for(Column = x; Column < x + FieldWidth; Column++) {
+				ReferencePixel(Column, Row, !colour);
+			}
+		}
+	}
+
+	ReferenceText((const uint8_t *)Text, x, y, colour, font, 1, 1);
+}
+
+/**
+ * reference compose. Each source pixel is combined into the canvas on its own
+ */
+static void ReferenceCompose(int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY, int32_t width, int32_t height, uint_fast8_t operation) {
+	int32_t Row;
+	int32_t Column;
+	int32_t SourceColumn;
+	int32_t SourceRow;
+	uint_fast8_t Bit;
+
+	for(Row = 0; Row < height; Row++) {
+		for(Column = 0; Column < width; Column++) {
+			SourceColumn = sourceX + Column;
+			SourceRow = sourceY + Row;
+
+			if(SourceColumn < 0 || SourceRow < 0 || SourceColumn >= (int32_t)source->Width || SourceRow >= (int32_t)source->Height ||
+					(x + Column) < 0 || (y + Row) < 0 || (x + Column) >= Width || (y + Row) >= Height) {
+				continue;
+			}
+
+			Bit = (source->Buffer[((SourceRow / 8) * source->Width) + SourceColumn] >> (SourceRow & 7)) & 1;
+
+			switch(operation) {
+				case Raster_Copy:
+					ReferencePixel(x + Column, y + Row, Bit);
+				break;
+
+				case Raster_Or:
+					if(Bit) {
+						ReferencePixel(x + Column, y + Row, 1);
+					}
+				break;
+
+				case Raster_AndNot:
+					if(Bit) {
+						ReferencePixel(x + Column, y + Row, 0);
+					}
+				break;
+
+				default:
+					if(Bit) {
+						ReferencePixel(x + Column, y + Row, !Reference[((y + Row) * Width) + x + Column]);
+					}
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @return a canvas pixel as the emulator shows it on the panel. The emulator renders all of its
+ * columns, so a panel narrower than that is at the far end when it is turned 90 degrees
+ */
+static uint8_t PanelPixel(int32_t x, int32_t y) {
+	if(PanelOrientation == SSD1306_Rotate90) {
+		return PanelPixels[(x * SSD1306_EMULATOR_COLUMNS) + (SSD1306_EMULATOR_COLUMNS - 1 - y)];
+	}
+
+	return PanelPixels[((Width - 1 - x) * SSD1306_EMULATOR_COLUMNS) + y];
+}
+
+/**
+ * compares every library canvas with the reference
+ *
+ * @param before when not NULL a pixel may also still be as it was in here
+ * @return true if they all match
+ */
+static uint_fast8_t Compare(const uint8_t * before) {
+	static const char * const Targets[4] = {"the surface", "the SetPixel display", "the parallel renderer", "the panel"};
+	uint8_t Found[4];
+	uint_fast8_t Target;
+	int32_t X;
+	int32_t Y;
+	uint8_t Expected;
+
+	if(PanelOrientation) {
+		SSD1306.Sync();
+		SSD1306EmulatorRender(&Emulator, PanelPixels);
+	}
+
+	for(Y = 0; Y < Height; Y++) {
+		for(X = 0; X < Width; X++) {
+			Expected = Reference[(Y * Width) + X];
+			Found[0] = (Canvas.Buffer[((Y / 8) * Width) + X] >> (Y & 7)) & 1;
+			Found[1] = Pixels[(Y * Width) + X];
+			Found[2] = (ParallelCanvas.Buffer[((Y / 8) * Width) + X] >> (Y & 7)) & 1;
+			Found[3] = PanelOrientation ? PanelPixel(X, Y) : Expected;
+
+			for(Target = 0; Target < 4; Target++) {
+				if(Found[Target] == Expected || (before && Found[Target] == before[(Y * Width) + X])) {
+					continue;
+				}
+
+				fprintf(stderr, "%s\n  on a %dx%d canvas: pixel %d,%d is %u on %s, expected %u\n",
+						Description, Width, Height, X, Y, Found[Target], Targets[Target], Expected);
+
+				if(Target == 3) {
+					fprintf(stderr, "  the panel is turned %u degrees\n", PanelOrientation == SSD1306_Rotate90 ? 90 : 270);
+				}
+
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * puts every library canvas in step with the reference
+ */
+static void MatchReference(void) {
+	int32_t Index;
+
+	for(Index = 0; Index < Width * Height; Index++) {
+		Pixels[Index] = Reference[Index];
+
+		if(Reference[Index]) {
+			Canvas.Buffer[((Index / Width / 8) * Width) + (Index % Width)] |= 1 << ((Index / Width) & 7);
+		} else {
+			Canvas.Buffer[((Index / Width / 8) * Width) + (Index % Width)] &= ~(1 << ((Index / Width) & 7));
+		}
+
+		if(PanelOrientation) {
+			SSD1306.SetPixel(Index % Width, Index / Width, Reference[Index]);
+		}
+	}
+
+	memcpy(ParallelCanvas.Buffer, Canvas.Buffer, SURFACE_BUFFER_SIZE(Width, Height));
+}
+
+/**
+ * starts a new canvas of the given size, filled with random pixels
+ */
+static void NewCanvas(int32_t width, int32_t height) {
+	int32_t Index;
+
+	Width = width;
+	Height = height;
+
+	Surface.Create(&Canvas, Width, Height, Surface_PageMonochrome, CanvasMemory, sizeof(CanvasMemory));
+	Surface.Create(&ParallelCanvas, Width, Height, Surface_PageMonochrome, ParallelCanvasMemory, sizeof(ParallelCanvasMemory));
+	PixelDisplay.Width = Width;
+	PixelDisplay.Height = Height;
+
+	// a canvas that fits a panel on its side is drawn on one too, in any of the sync modes
+	PanelOrientation = 0;
+
+	if(!(Width & 7) && !(Height & 7) && Width <= SSD1306_MAX_HEIGHT && Height <= SSD1306_MAX_WIDTH) {
+		SSD1306ConfigType Config = SSD1306_CONFIG_128X64;
+
+		Config.Width = Height;
+		Config.Height = Width;
+		Config.AddressMode = NextRandom() % 3;
+		Config.Orientation = (NextRandom() & 1) ? SSD1306_Rotate90 : SSD1306_Rotate270;
+		Config.Buffer = PanelBuffer;
+
+		if(!SSD1306Configure(&SSD1306, &Config)) {
+			SSD1306EmulatorReset(&Emulator);
+			SSD1306.Open((GenericComInterface *)&EmulatorInterface);
+			PanelOrientation = Config.Orientation;
+		}
+	}
+
+	for(Index = 0; Index < Width * Height; Index++) {
+		Reference[Index] = NextRandom() & 1;
+	}
+
+	MatchReference();
+
+	// the glyph cache may be off, small enough to bypass some glyphs or roomy
+	switch(NextRandom() % 3) {
+		case 0:
+			GlyphCache.Init(NULL, 0);
+		break;
+
+		case 1:
+			GlyphCache.Init(CacheMemory, 256);
+		break;
+
+		default:
+			GlyphCache.Init(CacheMemory, sizeof(CacheMemory));
+		break;
+	}
+}
+
+/**
+ * starts a random canvas. A quarter of them fit a panel on its side
+ */
+static void RandomCanvas(void) {
+	if(!(NextRandom() & 3)) {
+		NewCanvas(RandomRange(1, SSD1306_MAX_HEIGHT / 8) * 8, RandomRange(1, MAX_HEIGHT / 8) * 8);
+	} else {
+		NewCanvas(RandomRange(1, MAX_WIDTH), RandomRange(1, MAX_HEIGHT));
+	}
+}
+
+/**
+ * draws one random operation with the reference and on every library canvas
+ *
+ * @return true if the results match
+ */
+static uint_fast8_t CheckOperation(void) {
+	OperationType Operation = NextRandom() % Operation_Count;
+	DisplayInterfaceType * Display;
+	int32_t Values[4];
+	int32_t Area[4] = {0, 0, 0, 0};
+	int32_t Number = 0;
+	uint_fast8_t Colour = NextRandom() & 1;
+	uint_fast8_t Fill = NextRandom() & 1;
+	uint8_t Text[12];
+	uint32_t Icon[64];
+	uint32_t * IconCopy = NULL;
+	uint32_t IconWords;
+	uint32_t Byte;
+	uint_fast8_t Target;
+	uint_fast8_t Index;
+	uint_fast8_t ScaleX = NextRandom() % (BASIC_GRAPHICS_MAX_FONT_SCALE + 2);
+	uint_fast8_t ScaleY = NextRandom() % (BASIC_GRAPHICS_MAX_FONT_SCALE + 2);
+	uint_fast8_t Decimals = 0;
+	uint_fast8_t FieldWidth = 0;
+	uint_fast8_t Flags = 0;
+	uint_fast8_t Raster = Raster_Copy;
+	uint_fast8_t Complete = 1;
+	uint_fast8_t Result;
+
+	Values[0] = RandomCoordinate(Width);
+	Values[1] = RandomCoordinate(Height);
+	Values[2] = RandomCoordinate(Width);
+	Values[3] = RandomCoordinate(Height);
+
+	switch(Operation) {
+		case Operation_Line:
+			snprintf(Description, sizeof(Description), "drawLine(%d, %d, %d, %d, %u)", Values[0], Values[1], Values[2], Values[3], Colour);
+			ReferenceLine(Values[0], Values[1], Values[2], Values[3], Colour);
+		break;
+
+		case Operation_Rectangle:
+			snprintf(Description, sizeof(Description), "drawRectagle(%d, %d, %d, %d, %u, %u)", Values[0], Values[1], Values[2], Values[3], Colour, Fill);
+			ReferenceRectangle(Values[0], Values[1], Values[2], Values[3], Colour, Fill);
+		break;
+
+		case Operation_Circle:
+			Values[2] = RandomRange(-2, MAX_WIDTH);
+			snprintf(Description, sizeof(Description), "drawCircle(%d, %d, %d, %u, %u)", Values[0], Values[1], Values[2], Colour, Fill);
+			ReferenceCircle(Values[0], Values[1], Values[2], Colour, Fill);
+		break;
+
+		case Operation_Text:
+			for(Index = 0; Index < sizeof(Text) - 1; Index++) {
+				// mostly printable, sometimes outside of the font
+				Text[Index] = (NextRandom() & 15) ? RandomRange(' ', '~') : RandomRange(1, 255);
+			}
+			Text[RandomRange(0, sizeof(Text) - 1)] = 0;
+			Values[1] = RandomCoordinate(Height + 16);
+
+			snprintf(Description, sizeof(Description), "WriteStringScaled(\"%s\", %d, %d, %u, font, %u, %u)", Text, Values[0], Values[1], Colour, ScaleX, ScaleY);
+			ReferenceText(Text, Values[0], Values[1], Colour, &DejaVuSansMono8pt7b, ScaleX, ScaleY);
+		break;
+
+		case Operation_FloodFill:
+			snprintf(Description, sizeof(Description), "floodFill(%d, %d, %u)", Values[0], Values[1], Colour);
+			memcpy(Before, Reference, Width * Height);
+			ReferenceFloodFill(Values[0], Values[1], Colour);
+		break;
+
+		case Operation_Number:
+			switch(NextRandom() & 3) {
+				case 0:
+					Number = (int32_t)NextRandom();
+				break;
+
+				case 1:
+					Number = (NextRandom() & 1) ? INT32_MIN : INT32_MAX;
+				break;
+
+				default:
+					Number = RandomRange(-9999, 9999);
+				break;
+			}
+
+			// WriteInt is WriteFixed without decimals
+			Decimals = (NextRandom() & 1) ? RandomRange(1, 4) : 0;
+			FieldWidth = RandomRange(0, BASIC_GRAPHICS_MAX_NUMBER_WIDTH + 2);
+			Flags = NextRandom() & (Number_PadZero | Number_ShowSign | Number_RightAlign | Number_ClearField);
+			Values[1] = RandomCoordinate(Height + 16);
+
+			if(Decimals) {
+				snprintf(Description, sizeof(Description), "WriteFixed(%d, %u, %d, %d, %u, 0x%02X, %u, font)", Number, Decimals, Values[0], Values[1], FieldWidth, Flags, Colour);
+			} else {
+				snprintf(Description, sizeof(Description), "WriteInt(%d, %d, %d, %u, 0x%02X, %u, font)", Number, Values[0], Values[1], FieldWidth, Flags, Colour);
+			}
+			ReferenceNumber(Number, Decimals, Values[0], Values[1], FieldWidth, Flags, Colour, &DejaVuSansMono8pt7b);
+		break;
+
+		case Operation_Compose:
+			Surface.Create(&Source, RandomRange(1, SOURCE_WIDTH), RandomRange(1, SOURCE_HEIGHT), Surface_PageMonochrome, SourceMemory, sizeof(SourceMemory));
+
+			// the bits below the last row are random too, they must not be drawn
+			for(Byte = 0; Byte < SURFACE_BUFFER_SIZE(Source.Width, Source.Height); Byte++) {
+				Source.Buffer[Byte] = NextRandom();
+			}
+
+			Area[0] = RandomRange(-8, Source.Width);
+			Area[1] = RandomRange(-8, Source.Height);
+			Area[2] = RandomRange(-2, Source.Width + 8);
+			Area[3] = RandomRange(-2, Source.Height + 8);
+			Raster = NextRandom() & 3;
+
+			snprintf(Description, sizeof(Description), "Surface.Compose(canvas, %d, %d, %ux%u source, %d, %d, %d, %d, %u)",
+					Values[0], Values[1], Source.Width, Source.Height, Area[0], Area[1], Area[2], Area[3], Raster);
+			ReferenceCompose(Values[0], Values[1], &Source, Area[0], Area[1], Area[2], Area[3], Raster);
+		break;
+
+		case Operation_Icon:
+		default:
+			Values[2] = RandomRange(0, 40);
+			Values[3] = RandomRange(0, 40);
+
+			for(Index = 0; Index < 64; Index++) {
+				Icon[Index] = NextRandom();
+			}
+
+			// an exact size copy so that reading past the icon is caught by the address sanitiser
+			IconWords = ((Values[2] * Values[3]) + 31) / 32;
+			IconCopy = malloc((IconWords ? IconWords : 1) * sizeof(uint32_t));
+			memcpy(IconCopy, Icon, IconWords * sizeof(uint32_t));
+
+			snprintf(Description, sizeof(Description), "drawIcon(%d, %d, %d, %d, %u, icon)", Values[0], Values[1], Values[3], Values[2], Colour);
+			ReferenceIcon(Values[0], Values[1], Values[3], Values[2], Colour, Icon);
+		break;
+	}
+
+	for(Target = 0; Target < 3; Target++) {
+		if(Target == 2 && !PanelOrientation) {
+			break;
+		}
+
+		Display = (Target == 0) ? Surface.Bind(&Canvas) : ((Target == 1) ? &PixelDisplay : &SSD1306);
+		GraphicsInstance.SetTarget(Display);
+
+		switch(Operation) {
+			case Operation_Line:
+				GraphicsInstance.drawLine(Values[0], Values[1], Values[2], Values[3], Colour);
+			break;
+
+			case Operation_Rectangle:
+				GraphicsInstance.drawRectagle(Values[0], Values[1], Values[2], Values[3], Colour, Fill);
+			break;
+
+			case Operation_Circle:
+				GraphicsInstance.drawCircle(Values[0], Values[1], Values[2], Colour, Fill);
+			break;
+
+			case Operation_Text:
+				GraphicsInstance.WriteStringScaled(Text, Values[0], Values[1], Colour, NULL, ScaleX, ScaleY);
+			break;
+
+			case Operation_FloodFill:
+				Complete &= (GraphicsInstance.floodFill(Values[0], Values[1], Colour) == BasicGReturned_OK);
+			break;
+
+			case Operation_Number:
+				if(Decimals) {
+					GraphicsInstance.WriteFixed(Number, Decimals, Values[0], Values[1], FieldWidth, Flags, Colour, NULL);
+				} else {
+					GraphicsInstance.WriteInt(Number, Values[0], Values[1], FieldWidth, Flags, Colour, NULL);
+				}
+			break;
+
+			case Operation_Compose:
+				if(Target == 0) {
+					Surface.Compose(&Canvas, Values[0], Values[1], &Source, Area[0], Area[1], Area[2], Area[3], Raster);
+				} else if(Raster == Raster_Xor && !Display->BlitPage) {
+					// the SetPixel display can't invert, so it has to refuse and is then given the reference result
+					if(Surface.ComposeToDisplay(Display, Values[0], Values[1], &Source, Area[0], Area[1], Area[2], Area[3], Raster) != BasicGReturned_Error) {
+						fprintf(stderr, "%s\n  the SetPixel display took Raster_Xor\n", Description);
+						return 0;
+					}
+					memcpy(Pixels, Reference, Width * Height);
+				} else {
+					Surface.ComposeToDisplay(Display, Values[0], Values[1], &Source, Area[0], Area[1], Area[2], Area[3], Raster);
+				}
+			break;
+
+			case Operation_Icon:
+			default:
+				GraphicsInstance.drawIcon(Values[0], Values[1], Values[3], Values[2], Colour, IconCopy);
+			break;
+		}
+	}
+
+	switch(Operation) {
+		case Operation_FloodFill:
+		case Operation_Number:
+		case Operation_Compose:
+			// ParallelRender doesn't record these, so its canvas is brought back in step
+			memcpy(ParallelCanvas.Buffer, Canvas.Buffer, SURFACE_BUFFER_SIZE(Width, Height));
+		break;
+
+		default:
+			ParallelRender.Begin(&ParallelCanvas);
+
+			switch(Operation) {
+				case Operation_Line:
+					ParallelRender.drawLine(Values[0], Values[1], Values[2], Values[3], Colour);
+				break;
+
+				case Operation_Rectangle:
+					ParallelRender.drawRectagle(Values[0], Values[1], Values[2], Values[3], Colour, Fill);
+				break;
+
+				case Operation_Circle:
+					ParallelRender.drawCircle(Values[0], Values[1], Values[2], Colour, Fill);
+				break;
+
+				case Operation_Text:
+					ParallelRender.WriteStringScaled(Text, Values[0], Values[1], Colour, NULL, ScaleX, ScaleY);
+				break;
+
+				default:
+					ParallelRender.drawIcon(Values[0], Values[1], Values[3], Values[2], Colour, IconCopy);
+				break;
+			}
+
+			ParallelRender.Finish();
+			ParallelChecked++;
+		break;
+	}
+
+	free(IconCopy);
+	Checked[Operation]++;
+
+	if(PanelOrientation) {
+		PanelChecked++;
+	}
+
+	if(!Complete) {
+		// the flood fill ran out of stack and stopped part way. It must not have gone outside the
+		// area, then every canvas is put back in step with the reference
+		Result = Compare(Before);
+		MatchReference();
+
+		return Result;
+	}
+
+	return Compare(NULL);
+}
+
+#ifndef RASTER_CHECK_FUZZER
+/**
+ * draws the golden scenes. Each one is a fixed list of calls that covers one primitive
+ */
+static void DrawScene(uint_fast8_t scene, uint_fast8_t reference) {
+	static const uint32_t Arrow[] = {0x10387CFE, 0x38383838, 0x38380000};
+	int32_t Index;
+
+	switch(scene) {
+		case 0:
+			for(Index = -8; Index < 136; Index += 12) {
+				if(reference) {
+					ReferenceLine(64, 32, Index, -4, 1);
+					ReferenceLine(64, 32, Index, 68, 1);
+				} else {
+					GraphicsInstance.drawLine(64, 32, Index, -4, 1);
+					GraphicsInstance.drawLine(64, 32, Index, 68, 1);
+				}
+			}
+		break;
+
+		case 1:
+			for(Index = 0; Index < 6; Index++) {
+				if(reference) {
+					ReferenceRectangle(Index * 22 - 4, Index * 6, Index * 22 + 14, Index * 10 + 20, 1, Index & 1);
+					ReferenceCircle(Index * 24 + 4, 48, Index * 3 + 1, 1, !(Index & 1));
+				} else {
+					GraphicsInstance.drawRectagle(Index * 22 - 4, Index * 6, Index * 22 + 14, Index * 10 + 20, 1, Index & 1);
+					GraphicsInstance.drawCircle(Index * 24 + 4, 48, Index * 3 + 1, 1, !(Index & 1));
+				}
+			}
+		break;
+
+		default:
+			if(reference) {
+				ReferenceText((const uint8_t *)"Hello 0123", -3, 12, 1, &DejaVuSansMono8pt7b, 1, 1);
+				ReferenceText((const uint8_t *)"Ag", 2, 46, 1, &DejaVuSansMono8pt7b, 2, 3);
+				ReferenceText((const uint8_t *)"x", 100, 66, 1, &DejaVuSansMono8pt7b, 4, 4);
+				ReferenceIcon(40, 30, 7, 8, 1, Arrow);
+				ReferenceIcon(124, 60, 7, 8, 1, Arrow);
+			} else {
+				GraphicsInstance.WriteString((uint8_t *)"Hello 0123", -3, 12, 1, NULL);
+				GraphicsInstance.WriteStringScaled((uint8_t *)"Ag", 2, 46, 1, NULL, 2, 3);
+				GraphicsInstance.WriteStringScaled((uint8_t *)"x", 100, 66, 1, NULL, 4, 4);
+				GraphicsInstance.drawIcon(40, 30, 7, 8, 1, (uint32_t *)Arrow);
+				GraphicsInstance.drawIcon(124, 60, 7, 8, 1, (uint32_t *)Arrow);
+			}
+		break;
+	}
+}
+
+/**
+ * writes the golden scenes, or checks the library and the reference against them
+ *
+ * @return true if nothing differs
+ */
+static uint_fast8_t GoldenScenes(const char * directory, uint_fast8_t write) {
+	uint8_t * Golden;
+	uint32_t GoldenWidth;
+	uint32_t GoldenHeight;
+	uint_fast8_t Scene;
+	uint_fast8_t Target;
+	char Path[512];
+
+	for(Scene = 0; Scene < 3; Scene++) {
+		snprintf(Path, sizeof(Path), "%s/scene_%u.pbm", directory, Scene);
+
+		NewCanvas(128, 64);
+		memset(Reference, 0, sizeof(Reference));
+		memset(Pixels, 0, sizeof(Pixels));
+		memset(Canvas.Buffer, 0, SURFACE_BUFFER_SIZE(Width, Height));
+
+		DrawScene(Scene, 1);
+
+		for(Target = 0; Target < 2; Target++) {
+			GraphicsInstance.SetTarget(Target ? &PixelDisplay : Surface.Bind(&Canvas));
+			DrawScene(Scene, 0);
+		}
+
+		// the parallel renderer is only checked by the random operations
+		memcpy(ParallelCanvas.Buffer, Canvas.Buffer, SURFACE_BUFFER_SIZE(Width, Height));
+
+		snprintf(Description, sizeof(Description), "golden scene %u against the reference", Scene);
+		if(!Compare(NULL)) {
+			return 0;
+		}
+
+		if(write) {
+			if(ImageFileWrite(Path, Width, Height, Reference)) {
+				fprintf(stderr, "failed to write %s\n", Path);
+				return 0;
+			}
+			continue;
+		}
+
+		Golden = ImageFileRead(Path, &GoldenWidth, &GoldenHeight);
+		if(!Golden || GoldenWidth != (uint32_t)Width || GoldenHeight != (uint32_t)Height) {
+			fprintf(stderr, "failed to read %s\n", Path);
+			free(Golden);
+			return 0;
+		}
+
+		// the golden image becomes the reference so both library paths are held to it
+		memcpy(Reference, Golden, Width * Height);
+		free(Golden);
+
+		snprintf(Description, sizeof(Description), "golden scene %u against %s", Scene, Path);
+		if(!Compare(NULL)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+#endif
+
+#ifdef RASTER_CHECK_FUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size) {
+	static uint_fast8_t Started;
+
+	if(!Started) {
+		ParallelRender.Start(PARALLEL_THREADS, ParallelMemory, sizeof(ParallelMemory));
+		Started = 1;
+	}
+
+	GraphicsInstance.Init(&PixelDisplay, &DejaVuSansMono8pt7b);
+
+	FuzzData = data;
+	FuzzSize = size;
+
+	RandomCanvas();
+
+	while(FuzzSize) {
+		if(!CheckOperation()) {
+			abort();
+		}
+	}
+
+	return 0;
+}
+
+#else
+
+int main(int argc, char ** argv) {
+	uint32_t Seed = 1;
+	uint32_t Canvases = 2000;
+	uint32_t Operations = 50;
+	uint32_t Canvas;
+	uint32_t Operation;
+	const char * GoldenDirectory = NULL;
+	uint_fast8_t WriteGolden = 0;
+	int Option;
+
+	while((Option = getopt(argc, argv, "s:n:o:w:g:")) != -1) {
+		switch(Option) {
+			case 's':
+				Seed = strtoul(optarg, NULL, 0);
+			break;
+
+			case 'n':
+				Canvases = strtoul(optarg, NULL, 0);
+			break;
+
+			case 'o':
+				Operations = strtoul(optarg, NULL, 0);
+			break;
+
+			case 'w':
+			case 'g':
+				GoldenDirectory = optarg;
+				WriteGolden = (Option == 'w');
+			break;
+
+			default:
+				fprintf(stderr, "usage: %s [-s seed] [-n canvases] [-o operations per canvas] [-w golden directory] [-g golden directory]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	GraphicsInstance.Init(&PixelDisplay, &DejaVuSansMono8pt7b);
+
+	if(ParallelRender.Start(PARALLEL_THREADS, ParallelMemory, sizeof(ParallelMemory))) {
+		fprintf(stderr, "failed to start the parallel renderer\n");
+		return 1;
+	}
+
+	RandomState = ((uint64_t)Seed << 32) | 0x9E3779B9u;
+
+	if(GoldenDirectory) {
+		if(!GoldenScenes(GoldenDirectory, WriteGolden)) {
+			return 1;
+		}
+		printf("golden scenes %s %s\n", WriteGolden ? "written to" : "match", GoldenDirectory);
+	}
+
+	for(Canvas = 0; Canvas < Canvases; Canvas++) {
+		RandomCanvas();
+
+		for(Operation = 0; Operation < Operations; Operation++) {
+			if(!CheckOperation()) {
+				fprintf(stderr, "seed %u, canvas %u, operation %u\n", Seed, Canvas, Operation);
+				return 1;
+			}
+		}
+	}
+
+	for(Operation = 0; Operation < Operation_Count; Operation++) {
+		printf("%-20s %u checked\n", OperationNames[Operation], Checked[Operation]);
+	}
+
+	printf("%u operations also checked on a panel turned 90 or 270 degrees\n", PanelChecked);
+	printf("%u operations also checked through ParallelRender\n", ParallelChecked);
+
+	ParallelRender.Stop();
+
+	return 0;
+}
+
+#endif
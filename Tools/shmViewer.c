@@ -0,0 +1,253 @@
+/*
+ * shmViewer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Maps the shared memory segment of a running virtual display (ExampleDriver/shmDisplay.c) read
+ *  only and writes snapshots of it as images, or prints its statistics as CSV.
+ *
+ *  The producer is never held up. Each copy is taken inside the segment's sequence lock and
+ *  retried if the producer published while it was being taken.
+ *
+ *  build:
+ *      cc -O2 -o shmViewer Tools/shmViewer.c Tools/imageFile.c
+ *
+ *  usage:
+ *      shmViewer [-n name] [-o output prefix] [-f pbm|png] [-c count] [-i milliseconds] [-s]
+ *
+ *  Without -s the tool writes count snapshots, waiting at least the interval between them and
+ *  skipping frames that have already been written. With -s it prints count statistics lines, one
+ *  per interval.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../ExampleDriver/shmDisplayFormat.h"
+#include "imageFile.h"
+
+/**
+ * how many times a copy is retried before giving up
+ */
+#define COPY_RETRIES 10000
+
+/**
+ * takes a consistent copy of the header and, if buffer isn't NULL, the frame buffer
+ *
+ * @return 0 or -EAGAIN if the producer kept publishing while we were copying
+ */
+static int32_t TakeCopy(const ShmDisplayHeaderType * segment, ShmDisplayHeaderType * header, uint8_t * buffer) {
+	uint32_t Retries;
+	unsigned int Before;
+	unsigned int After;
+
+	for(Retries = 0; Retries < COPY_RETRIES; Retries++) {
+		Before = atomic_load_explicit((atomic_uint *)&segment->Sequence, memory_order_acquire);
+
+		if(Before & 1) {
+			sched_yield();
+			continue;
+		}
+
+		memcpy(header, segment, sizeof(*header));
+
+		if(buffer) {
+			memcpy(buffer, (const uint8_t *)segment + segment->HeaderSize, segment->BufferSize);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+		After = atomic_load_explicit((atomic_uint *)&segment->Sequence, memory_order_relaxed);
+
+		if(Before == After) {
+			return 0;
+		}
+	}
+
+	return -EAGAIN;
+}
+
+/**
+ * returns a monotonic time stamp in microseconds
+ */
+static uint64_t GetTimestamp(void) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((uint64_t)Now.tv_sec * 1000000u) + ((uint64_t)Now.tv_nsec / 1000u);
+}
+
+/**
+ * converts the page layout into one byte per pixel
+ */
+static void ToPixels(const uint8_t * pages, uint32_t width, uint32_t height, uint8_t * pixels) {
+	uint32_t X;
+	uint32_t Y;
+
+	for(Y = 0; Y < height; Y++) {
+		for(X = 0; X < width; X++) {
+			*pixels++ = (pages[((Y / 8) * width) + X] >> (Y & 7)) & 1;
+		}
+	}
+}
+
+int main(int argc, char ** argv) {
+	const char * Name = SHM_DISPLAY_DEFAULT_NAME;
+	const char * Prefix = "snapshot_";
+	const char * Extension = "pbm";
+	uint32_t Count = 1;
+	uint32_t IntervalMilliseconds = 1000;
+	uint_fast8_t Statistics = 0;
+	ShmDisplayHeaderType * Segment;
+	ShmDisplayHeaderType Header;
+	ShmDisplayHeaderType Previous;
+	uint8_t * Buffer;
+	uint8_t * Pixels;
+	uint32_t Index;
+	uint32_t LastFrame = 0;
+	uint64_t Now;
+	uint64_t Then;
+	struct stat Information;
+	char Path[512];
+	int Handle;
+	int Option;
+
+	while((Option = getopt(argc, argv, "n:o:f:c:i:s")) != -1) {
+		switch(Option) {
+			case 'n':
+				Name = optarg;
+			break;
+
+			case 'o':
+				Prefix = optarg;
+			break;
+
+			case 'f':
+				Extension = optarg;
+			break;
+
+			case 'c':
+				Count = strtoul(optarg, NULL, 0);
+			break;
+
+			case 'i':
+				IntervalMilliseconds = strtoul(optarg, NULL, 0);
+			break;
+
+			case 's':
+				Statistics = 1;
+			break;
+
+			default:
+				fprintf(stderr, "usage: %s [-n name] [-o output prefix] [-f pbm|png] [-c count] [-i milliseconds] [-s]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	Handle = shm_open(Name, O_RDONLY, 0);
+	if(Handle < 0 || fstat(Handle, &Information) || (size_t)Information.st_size < sizeof(ShmDisplayHeaderType)) {
+		fprintf(stderr, "failed to open %s: %s\n", Name, strerror(errno));
+		return 1;
+	}
+
+	Segment = mmap(NULL, Information.st_size, PROT_READ, MAP_SHARED, Handle, 0);
+	close(Handle);
+
+	if(Segment == MAP_FAILED) {
+		fprintf(stderr, "failed to map %s: %s\n", Name, strerror(errno));
+		return 1;
+	}
+
+	if(Segment->Magic != SHM_DISPLAY_MAGIC || Segment->Version != SHM_DISPLAY_VERSION ||
+			(uint64_t)Segment->HeaderSize + Segment->BufferSize > (uint64_t)Information.st_size ||
+			Segment->BufferSize != Segment->Width * ((Segment->Height + 7u) / 8u)) {
+		fprintf(stderr, "%s is not a version %u display segment\n", Name, SHM_DISPLAY_VERSION);
+		return 1;
+	}
+
+	Buffer = malloc(Segment->BufferSize);
+	Pixels = malloc(Segment->Width * Segment->Height);
+	if(!Buffer || !Pixels) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	if(TakeCopy(Segment, &Previous, NULL)) {
+		fprintf(stderr, "the producer is publishing too fast to take a copy\n");
+		return 1;
+	}
+
+	Then = GetTimestamp();
+
+	if(Statistics) {
+		printf("time_us,frames,region_syncs,frames_per_second,bytes_per_second,brightness,open,producer_pid\n");
+	}
+
+	for(Index = 0; Index < Count; ) {
+		if(Statistics) {
+			usleep(IntervalMilliseconds * 1000u);
+
+			if(TakeCopy(Segment, &Header, NULL)) {
+				continue;
+			}
+
+			Now = GetTimestamp();
+
+			printf("%llu,%u,%u,%.1f,%.0f,%u,%u,%u\n",
+					(unsigned long long)Now,
+					Header.Frames,
+					Header.RegionSyncs,
+					(Header.Frames - Previous.Frames) * 1e6 / (double)(Now - Then),
+					(Header.BytesPublished - Previous.BytesPublished) * 1e6 / (double)(Now - Then),
+					Header.Brightness,
+					Header.Open,
+					Header.ProducerPid);
+			fflush(stdout);
+
+			Previous = Header;
+			Then = Now;
+			Index++;
+			continue;
+		}
+
+		if(TakeCopy(Segment, &Header, Buffer)) {
+			fprintf(stderr, "the producer is publishing too fast to take a copy\n");
+			return 1;
+		}
+
+		// only write frames we haven't written yet, unless nothing is publishing any more
+		if(Index && Header.Frames == LastFrame && Header.Open) {
+			usleep(1000);
+			continue;
+		}
+
+		LastFrame = Header.Frames;
+
+		ToPixels(Buffer, Header.Width, Header.Height, Pixels);
+		snprintf(Path, sizeof(Path), "%s%04u.%s", Prefix, Index, Extension);
+
+		if(ImageFileWrite(Path, Header.Width, Header.Height, Pixels)) {
+			fprintf(stderr, "failed to write %s\n", Path);
+			return 1;
+		}
+
+		fprintf(stderr, "%s: frame %u\n", Path, Header.Frames);
+
+		if(++Index < Count) {
+			usleep(IntervalMilliseconds * 1000u);
+		}
+	}
+
+	free(Buffer);
+	free(Pixels);
+	munmap(Segment, Information.st_size);
+
+	return 0;
+}
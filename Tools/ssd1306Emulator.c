@@ -0,0 +1,305 @@
+/*
+ * ssd1306Emulator.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  A host side model of the SSD1306 controller. Only the commands the driver uses are modelled;
+ *  everything else is decoded for its length and then ignored.
+ */
+#include <string.h>
+#include "ssd1306Emulator.h"
+
+/**
+ * set the continuation bit Co
+ */
+#define CONTROL_CONTINUATION_BIT 0x80
+
+/**
+ * the D/C# bit of the control byte
+ */
+#define CONTROL_DATA_BIT 0x40
+
+void SSD1306EmulatorReset(SSD1306EmulatorType * emulator) {
+	memset(emulator, 0, sizeof(*emulator));
+
+	emulator->RamColumns = SSD1306_EMULATOR_COLUMNS;
+	emulator->AddressMode = 0x02;
+	emulator->ColumnEnd = SSD1306_EMULATOR_COLUMNS - 1;
+	emulator->PageEnd = SSD1306_EMULATOR_PAGES - 1;
+	emulator->MultiplexRatio = 63;
+	emulator->Contrast = 0x7F;
+}
+
+void SSD1306EmulatorSetColumns(SSD1306EmulatorType * emulator, uint32_t ramColumns, uint32_t columnOffset) {
+	if(ramColumns < SSD1306_EMULATOR_COLUMNS) {
+		ramColumns = SSD1306_EMULATOR_COLUMNS;
+	} else if(ramColumns > SSD1306_EMULATOR_RAM_COLUMNS) {
+		ramColumns = SSD1306_EMULATOR_RAM_COLUMNS;
+	}
+
+	if(columnOffset > (ramColumns - SSD1306_EMULATOR_COLUMNS)) {
+		columnOffset = ramColumns - SSD1306_EMULATOR_COLUMNS;
+	}
+
+	emulator->RamColumns = ramColumns;
+	emulator->ColumnOffset = columnOffset;
+}
+
+void SSD1306EmulatorStartFrame(SSD1306EmulatorType * emulator) {
+	memset(&emulator->Written[0][0], 0, sizeof(emulator->Written));
+	emulator->Overwrites = 0;
+}
+
+uint32_t SSD1306EmulatorHeight(const SSD1306EmulatorType * emulator) {
+	uint32_t Height = emulator->MultiplexRatio + 1u;
+
+	if(Height > (SSD1306_EMULATOR_PAGES * 8)) {
+		Height = SSD1306_EMULATOR_PAGES * 8;
+	}
+
+	return Height;
+}
+
+/**
+ * @return the total length of the command including its first byte
+ */
+static uint_fast8_t CommandLength(uint8_t command) {
+	switch(command) {
+		case 0x20: // memory address mode
+		case 0x81: // contrast
+		case 0x8D: // charge pump
+		case 0xA8: // multiplex ratio
+		case 0xD3: // display offset
+		case 0xD5: // clock divide
+		case 0xD9: // pre-charge period
+		case 0xDA: // COM pins configuration
+		case 0xDB: // VCOMH deselect level
+			return 2;
+
+		case 0x21: // column address
+		case 0x22: // page address
+		case 0xA3: // vertical scroll area
+			return 3;
+
+		case 0x29: // vertical and horizontal scroll setup
+		case 0x2A:
+			return 6;
+
+		case 0x26: // horizontal scroll setup
+		case 0x27:
+			return 7;
+
+		default:
+			return 1;
+	}
+}
+
+/**
+ * applies a fully received command
+ */
+static void ExecuteCommand(SSD1306EmulatorType * emulator) {
+	uint8_t *Command = &emulator->Command[0];
+
+	switch(Command[0]) {
+		case 0x20:
+			emulator->AddressMode = Command[1] & 0x03;
+		break;
+
+		case 0x21:
+			emulator->ColumnStart = Command[1] & 0x7F;
+			emulator->ColumnEnd = Command[2] & 0x7F;
+			emulator->Column = emulator->ColumnStart;
+		break;
+
+		case 0x22:
+			emulator->PageStart = Command[1] & 0x07;
+			emulator->PageEnd = Command[2] & 0x07;
+			emulator->Page = emulator->PageStart;
+		break;
+
+		case 0x81:
+			emulator->Contrast = Command[1];
+		break;
+
+		case 0xA8:
+			emulator->MultiplexRatio = Command[1] & 0x3F;
+		break;
+
+		case 0xA0:
+		case 0xA1:
+			emulator->SegmentRemap = Command[0] & 0x01;
+		break;
+
+		case 0xA4:
+		case 0xA5:
+			emulator->EntireDisplayOn = Command[0] & 0x01;
+		break;
+
+		case 0xA6:
+		case 0xA7:
+			emulator->Inverse = Command[0] & 0x01;
+		break;
+
+		case 0xAE:
+		case 0xAF:
+			emulator->DisplayOn = Command[0] & 0x01;
+		break;
+
+		case 0xC0:
+		case 0xC8:
+			emulator->ComScanReverse = (Command[0] & 0x08) ? 1 : 0;
+		break;
+
+		default:
+			if(Command[0] <= 0x0F) {
+				// page mode lower column nibble
+				emulator->PageModeColumn = (emulator->PageModeColumn & 0xF0) | Command[0];
+				emulator->Column = emulator->PageModeColumn;
+			} else if(Command[0] <= 0x1F) {
+				// page mode higher column nibble
+				emulator->PageModeColumn = ((Command[0] & 0x07) << 4) | (emulator->PageModeColumn & 0x0F);
+				emulator->Column = emulator->PageModeColumn;
+			} else if(Command[0] >= 0xB0 && Command[0] <= 0xB7) {
+				emulator->Page = Command[0] & 0x07;
+			}
+		break;
+	}
+}
+
+/**
+ * feeds one command byte into the decoder
+ */
+static void CommandByte(SSD1306EmulatorType * emulator, uint8_t value) {
+	if(!emulator->CommandLength) {
+		emulator->CommandExpected = CommandLength(value);
+	}
+
+	emulator->Command[emulator->CommandLength++] = value;
+	emulator->CommandBytes++;
+
+	if(emulator->CommandLength >= emulator->CommandExpected) {
+		ExecuteCommand(emulator);
+		emulator->CommandLength = 0;
+	}
+}
+
+/**
+ * @return the RAM column count. An emulator that was never reset has the SSD1306's
+ */
+static uint32_t RamColumns(const SSD1306EmulatorType * emulator) {
+	return emulator->RamColumns ? emulator->RamColumns : SSD1306_EMULATOR_COLUMNS;
+}
+
+/**
+ * writes one byte to the graphics RAM and moves the pointer on based on the address mode
+ */
+static void DataByte(SSD1306EmulatorType * emulator, uint8_t value) {
+	uint8_t Page = emulator->Page % SSD1306_EMULATOR_PAGES;
+	uint8_t Column = emulator->Column % RamColumns(emulator);
+
+	emulator->Ram[Page][Column] = value;
+	emulator->DataBytes++;
+
+	if(emulator->Written[Page][Column]) {
+		emulator->Overwrites++;
+	}
+	emulator->Written[Page][Column] = 1;
+
+	switch(emulator->AddressMode) {
+		case 0x00:
+			if(emulator->Column >= emulator->ColumnEnd) {
+				emulator->Column = emulator->ColumnStart;
+				emulator->Page = (emulator->Page >= emulator->PageEnd) ? emulator->PageStart : (emulator->Page + 1);
+			} else {
+				emulator->Column++;
+			}
+		break;
+
+		case 0x01:
+			if(emulator->Page >= emulator->PageEnd) {
+				emulator->Page = emulator->PageStart;
+				emulator->Column = (emulator->Column >= emulator->ColumnEnd) ? emulator->ColumnStart : (emulator->Column + 1);
+			} else {
+				emulator->Page++;
+			}
+		break;
+
+		default:
+			emulator->Column = (emulator->Column >= (RamColumns(emulator) - 1)) ? emulator->PageModeColumn : (emulator->Column + 1);
+		break;
+	}
+}
+
+uint32_t SSD1306EmulatorWrite(SSD1306EmulatorType * emulator, const uint8_t * message, uint32_t length) {
+	uint32_t DataBytes = 0;
+	uint8_t Control;
+
+	while(length) {
+		Control = *message++;
+		length--;
+
+		if(Control & CONTROL_CONTINUATION_BIT) {
+			// a single byte follows and then another control byte
+			if(!length) {
+				break;
+			}
+
+			if(Control & CONTROL_DATA_BIT) {
+				DataByte(emulator, *message);
+				DataBytes++;
+			} else {
+				CommandByte(emulator, *message);
+			}
+
+			message++;
+			length--;
+			continue;
+		}
+
+		// the rest of the message is all the same type
+		for( ; length; length--, message++) {
+			if(Control & CONTROL_DATA_BIT) {
+				DataByte(emulator, *message);
+				DataBytes++;
+			} else {
+				CommandByte(emulator, *message);
+			}
+		}
+	}
+
+	return DataBytes;
+}
+
+void SSD1306EmulatorRender(const SSD1306EmulatorType * emulator, uint8_t * pixels) {
+	uint32_t Height = SSD1306EmulatorHeight(emulator);
+	uint32_t X;
+	uint32_t Y;
+	uint32_t Column;
+	uint32_t Row;
+	uint8_t Value;
+
+	for(Y = 0; Y < Height; Y++) {
+		for(X = 0; X < SSD1306_EMULATOR_COLUMNS; X++) {
+			// the driver mounts the panel with the segments remapped and the COM scan reversed
+			Column = emulator->ColumnOffset + (emulator->SegmentRemap ? X : (SSD1306_EMULATOR_COLUMNS - 1 - X));
+			Row = emulator->ComScanReverse ? Y : (Height - 1 - Y);
+
+			Value = (emulator->Ram[Row / 8][Column] >> (Row & 7)) & 0x01;
+
+			if(emulator->EntireDisplayOn) {
+				Value = 1;
+			}
+
+			if(emulator->Inverse) {
+				Value ^= 1;
+			}
+
+			if(!emulator->DisplayOn) {
+				Value = 0;
+			}
+
+			pixels[(Y * SSD1306_EMULATOR_COLUMNS) + X] = Value;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/*
+ * ssd1306Emulator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  A host side model of the SSD1306 controller. It takes the same I2C messages that the driver
+ *  writes and keeps a copy of the graphics RAM so that the result can be rendered offline.
+ */
+
+#ifndef __SSD1306_EMULATOR_H__
+#define __SSD1306_EMULATOR_H__
+
+	#include <stdint.h>
+
+	/**
+	 * defines the visible column count, which is the width of a rendered frame
+	 */
+	#define SSD1306_EMULATOR_COLUMNS 128
+
+	/**
+	 * defines the largest graphics RAM column count. The SH1106 has 132 columns of RAM
+	 */
+	#define SSD1306_EMULATOR_RAM_COLUMNS 132
+
+	/**
+	 * defines the graphics RAM page count
+	 */
+	#define SSD1306_EMULATOR_PAGES 8
+
+	/**
+	 * defines the emulated controller state
+	 */
+	typedef struct SSD1306EmulatorType {
+		uint8_t Ram[SSD1306_EMULATOR_PAGES][SSD1306_EMULATOR_RAM_COLUMNS];	///< graphics RAM, one byte holds 8 vertical pixels
+		uint8_t Written[SSD1306_EMULATOR_PAGES][SSD1306_EMULATOR_RAM_COLUMNS];	///< RAM bytes written since SSD1306EmulatorStartFrame
+
+		uint8_t RamColumns;			///< columns of RAM the controller has. See SSD1306EmulatorSetColumns
+		uint8_t ColumnOffset;		///< the RAM column of the first visible column
+
+		uint8_t AddressMode;		///< 0 = horizontal, 1 = vertical, 2 = page
+		uint8_t ColumnStart;		///< column window start
+		uint8_t ColumnEnd;			///< column window end
+		uint8_t PageStart;			///< page window start
+		uint8_t PageEnd;			///< page window end
+		uint8_t PageModeColumn;		///< the column start used in page mode
+		uint8_t Column;				///< current column pointer
+		uint8_t Page;				///< current page pointer
+
+		uint8_t MultiplexRatio;		///< number of active rows - 1
+		uint8_t Contrast;			///< contrast control value
+		uint8_t SegmentRemap;		///< true when column 127 is mapped to SEG0
+		uint8_t ComScanReverse;		///< true when the COM scan is reversed
+		uint8_t DisplayOn;			///< true when the panel is on
+		uint8_t Inverse;			///< true when the display is inverted
+		uint8_t EntireDisplayOn;	///< true when all pixels are forced on
+
+		uint8_t Command[8];			///< the command that is currently being decoded
+		uint8_t CommandLength;		///< how many bytes of Command we have
+		uint8_t CommandExpected;	///< how many bytes the command needs in total
+
+		uint32_t DataBytes;			///< total GDDRAM bytes written
+		uint32_t CommandBytes;		///< total command bytes written
+		uint32_t Overwrites;		///< RAM bytes written twice since SSD1306EmulatorStartFrame
+	} SSD1306EmulatorType;
+
+	/**
+	 * puts the emulator into the controller's power on state
+	 */
+	void SSD1306EmulatorReset(SSD1306EmulatorType * emulator);
+
+	/**
+	 * Sets the RAM size and the visible window for controllers other than the SSD1306, such as the
+	 * SH1106 with 132 columns of RAM and the panel starting at column 2. Call after
+	 * SSD1306EmulatorReset, which selects 128 columns and no offset.
+	 *
+	 * @param ramColumns limited to SSD1306_EMULATOR_COLUMNS to SSD1306_EMULATOR_RAM_COLUMNS
+	 * @param columnOffset limited so the visible window stays inside the RAM
+	 */
+	void SSD1306EmulatorSetColumns(SSD1306EmulatorType * emulator, uint32_t ramColumns, uint32_t columnOffset);
+
+	/**
+	 * Clears the record of which RAM bytes have been written. A second write to the same byte
+	 * after this counts as an overwrite, which is how a new frame is detected.
+	 */
+	void SSD1306EmulatorStartFrame(SSD1306EmulatorType * emulator);
+
+	/**
+	 * Processes a single I2C write message, control byte included.
+	 *
+	 * @return the number of GDDRAM data bytes that the message carried
+	 */
+	uint32_t SSD1306EmulatorWrite(SSD1306EmulatorType * emulator, const uint8_t * message, uint32_t length);
+
+	/**
+	 * @return the number of visible rows, as set by the multiplex ratio
+	 */
+	uint32_t SSD1306EmulatorHeight(const SSD1306EmulatorType * emulator);
+
+	/**
+	 * Renders the visible panel content.
+	 *
+	 * @note The driver's mounting orientation (segment remap and reversed COM scan) is taken as
+	 * the upright orientation so an unrotated frame matches the driver's frame buffer.
+	 *
+	 * @param pixels destination of SSD1306_EMULATOR_COLUMNS * SSD1306EmulatorHeight() bytes. 1 = lit
+	 */
+	void SSD1306EmulatorRender(const SSD1306EmulatorType * emulator, uint8_t * pixels);
+
+#endif /* __SSD1306_EMULATOR_H__ */
@@ -0,0 +1,370 @@
+/*
+ * animation.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Time based tweens for widget properties and custom values.
+ *
+ * Every value is worked out from the clock rather than from a step count, so a late frame simply
+ * jumps to where the animation should be by now instead of falling behind. Animation.Step applies
+ * all the animations and then does a single Widgets.Step, which redraws the changed widgets and
+ * sends all their rectangles in one go.
+ *
+ * When a frame's time budget runs out the remaining animations are left where they are and are
+ * serviced first on the next frame.
+ */
+#include <time.h>
+#include "animation.h"
+
+/**
+ * 1.0 in the tween fixed point format
+ */
+#define TWEEN_ONE 65536
+
+/**
+ * the animation pool
+ */
+static AnimationType Pool[ANIMATION_POOL_SIZE];
+
+/**
+ * where the next frame starts servicing animations
+ */
+static uint32_t NextIndex;
+
+/**
+ * the animation counters
+ */
+static AnimationStatisticsType Statistics;
+
+/**
+ * the default clock
+ */
+static uint32_t MonotonicMicroseconds(void) {
+#if defined(CLOCK_MONOTONIC)
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (uint32_t)(((uint64_t)Now.tv_sec * 1000000) + (Now.tv_nsec / 1000));
+#else
+	return 0;
+#endif
+}
+
+/**
+ * the clock in use
+ */
+static uint32_t (*Clock)(void) = MonotonicMicroseconds;
+
+static void SetClock(uint32_t (*microseconds)(void)) {
+	Clock = microseconds ? microseconds : MonotonicMicroseconds;
+}
+
+/**
+ * applies a curve to a linear progress. Both are 0 to TWEEN_ONE
+ */
+static uint32_t ease(uint_fast8_t curve, uint32_t progress) {
+	uint32_t Remaining = TWEEN_ONE - progress;
+
+	switch(curve) {
+		case Tween_EaseIn:
+			return (uint32_t)(((uint64_t)progress * progress) >> 16);
+
+		case Tween_EaseOut:
+			return TWEEN_ONE - (uint32_t)(((uint64_t)Remaining * Remaining) >> 16);
+
+		case Tween_EaseInOut:
+			if(progress < (TWEEN_ONE / 2)) {
+				return (uint32_t)(((uint64_t)progress * progress) >> 15);
+			}
+			return TWEEN_ONE - (uint32_t)(((uint64_t)Remaining * Remaining) >> 15);
+
+		case Tween_Linear:
+		default:
+			return progress;
+	}
+}
+
+/**
+ * @return the current value of a widget property
+ */
+static int32_t getProperty(const WidgetType * widget, uint_fast8_t property) {
+	switch(property) {
+		case Animate_X:
+			return widget->X;
+		case Animate_Y:
+			return widget->Y;
+		case Animate_Width:
+			return widget->Width;
+		case Animate_Height:
+			return widget->Height;
+		case Animate_Value:
+		default:
+			return widget->Value;
+	}
+}
+
+/**
+ * hands a new value to the animation's target
+ */
+static void applyValue(AnimationType * animation, int32_t value) {
+	WidgetType * Widget = animation->Widget;
+
+	if(!Widget) {
+		if(animation->Apply) {
+			animation->Apply(animation->Context, value);
+		}
+		return;
+	}
+
+	switch(animation->Property) {
+		case Animate_X:
+			Widgets.SetBounds(Widget, value, Widget->Y, Widget->Width, Widget->Height);
+		break;
+		case Animate_Y:
+			Widgets.SetBounds(Widget, Widget->X, value, Widget->Width, Widget->Height);
+		break;
+		case Animate_Width:
+			Widgets.SetBounds(Widget, Widget->X, Widget->Y, value, Widget->Height);
+		break;
+		case Animate_Height:
+			Widgets.SetBounds(Widget, Widget->X, Widget->Y, Widget->Width, value);
+		break;
+		case Animate_Value:
+		default:
+			Widgets.SetValue(Widget, value);
+		break;
+	}
+}
+
+/**
+ * takes an animation from the pool
+ */
+static AnimationType * allocate(int32_t from, int32_t to, uint32_t milliseconds, uint_fast8_t curve) {
+	uint32_t Index;
+	AnimationType * Animation;
+
+	for(Index = 0; Index < ANIMATION_POOL_SIZE; Index++) {
+		Animation = &Pool[Index];
+
+		if(!Animation->Active) {
+			memset(Animation, 0, sizeof(AnimationType));
+			Animation->Active = 1;
+			Animation->Curve = curve;
+			Animation->From = from;
+			Animation->To = to;
+			Animation->Last = from;
+			Animation->StartMicroseconds = Clock();
+			Animation->DurationMicroseconds = milliseconds * 1000;
+
+			return Animation;
+		}
+	}
+
+	return NULL;
+}
+
+static void Stop(AnimationType * animation) {
+	if(animation) {
+		animation->Active = 0;
+	}
+}
+
+static void StopAll(WidgetType * widget) {
+	uint32_t Index;
+
+	for(Index = 0; Index < ANIMATION_POOL_SIZE; Index++) {
+		if(!widget || Pool[Index].Widget == widget) {
+			Pool[Index].Active = 0;
+		}
+	}
+}
+
+/**
+ * animates a widget property from its current value. Any animation already running on the same property is replaced
+ *
+ * @param widget the widget
+ * @param property AnimationPropertyType
+ * @param to the end value
+ * @param milliseconds how long it takes
+ * @param curve TweenCurveType
+ * @return the animation or NULL if the pool is used up
+ */
+static AnimationType * Start(WidgetType * widget, uint_fast8_t property, int32_t to, uint32_t milliseconds, uint_fast8_t curve) {
+	AnimationType * Animation;
+	uint32_t Index;
+
+	if(!widget || property > Animate_Value) {
+		return NULL;
+	}
+
+	for(Index = 0; Index < ANIMATION_POOL_SIZE; Index++) {
+		if(Pool[Index].Active && Pool[Index].Widget == widget && Pool[Index].Property == property) {
+			Pool[Index].Active = 0;
+		}
+	}
+
+	Animation = allocate(getProperty(widget, property), to, milliseconds, curve);
+
+	if(Animation) {
+		Animation->Widget = widget;
+		Animation->Property = property;
+	}
+
+	return Animation;
+}
+
+/**
+ * animates any value
+ *
+ * @param from the start value
+ * @param to the end value
+ * @param milliseconds how long it takes
+ * @param curve TweenCurveType
+ * @param apply called with each new value
+ * @param context handed to apply
+ * @return the animation or NULL if the pool is used up
+ */
+static AnimationType * StartCustom(int32_t from, int32_t to, uint32_t milliseconds, uint_fast8_t curve, AnimationApplyType apply, void * context) {
+	AnimationType * Animation;
+
+	if(!apply) {
+		return NULL;
+	}
+
+	Animation = allocate(from, to, milliseconds, curve);
+
+	if(Animation) {
+		Animation->Apply = apply;
+		Animation->Context = context;
+	}
+
+	return Animation;
+}
+
+/**
+ * hands a fade value to the display
+ */
+static void applyBrightness(void * context, int32_t value) {
+	DisplayInterfaceType * Display = context;
+
+	Display->setBrightness((uint8_t)value);
+}
+
+/**
+ * fades a display's brightness. Each step is only a brightness change, so nothing is redrawn and
+ * the bus only carries a few command bytes
+ *
+ * @param display the display
+ * @param from the start brightness, ignored when a fade on the display is still running
+ * @param to the end brightness
+ * @param milliseconds how long it takes
+ * @param curve TweenCurveType
+ * @return the animation or NULL if the pool is used up or the display can't change its brightness
+ */
+static AnimationType * StartFade(DisplayInterfaceType * display, uint8_t from, uint8_t to, uint32_t milliseconds, uint_fast8_t curve) {
+	int32_t From = from;
+	uint32_t Index;
+
+	if(!display || !display->setBrightness) {
+		return NULL;
+	}
+
+	for(Index = 0; Index < ANIMATION_POOL_SIZE; Index++) {
+		if(Pool[Index].Active && Pool[Index].Apply == applyBrightness && Pool[Index].Context == display) {
+			From = Pool[Index].Last;
+			Pool[Index].Active = 0;
+		}
+	}
+
+	return StartCustom(From, to, milliseconds, curve, applyBrightness, display);
+}
+
+/**
+ * moves every animation on to the current time, then redraws and flushes once
+ *
+ * @param budgetMicroseconds how long the animations may take this frame, 0 for no limit
+ * @return the number of animations still running
+ */
+static uint32_t Step(uint32_t budgetMicroseconds) {
+	uint32_t Now = Clock();
+	uint32_t Elapsed;
+	uint32_t Progress;
+	uint32_t Running = 0;
+	uint32_t Count;
+	uint32_t Index = NextIndex;
+	uint_fast8_t OutOfTime = 0;
+	AnimationType * Animation;
+	int32_t Value;
+
+	Statistics.Frames++;
+
+	for(Count = 0; Count < ANIMATION_POOL_SIZE; Count++, Index = (Index + 1) % ANIMATION_POOL_SIZE) {
+		Animation = &Pool[Index];
+
+		if(!Animation->Active) {
+			continue;
+		}
+
+		if(OutOfTime) {
+			Statistics.Deferred++;
+			Running++;
+			continue;
+		}
+
+		Elapsed = Now - Animation->StartMicroseconds;
+
+		if(Elapsed >= Animation->DurationMicroseconds) {
+			Value = Animation->To;
+			Animation->Active = 0;
+			Statistics.Finished++;
+		} else {
+			Progress = (uint32_t)(((uint64_t)Elapsed * TWEEN_ONE) / Animation->DurationMicroseconds);
+			Value = Animation->From + (int32_t)((((int64_t)Animation->To - Animation->From) * ease(Animation->Curve, Progress)) / TWEEN_ONE);
+			Running++;
+		}
+
+		if(Value != Animation->Last) {
+			Animation->Last = Value;
+			applyValue(Animation, Value);
+			Statistics.Updates++;
+		}
+
+		// whatever is left gets serviced first next time
+		if(budgetMicroseconds && (Clock() - Now) > budgetMicroseconds) {
+			OutOfTime = 1;
+			NextIndex = (Index + 1) % ANIMATION_POOL_SIZE;
+		}
+	}
+
+	if(!OutOfTime) {
+		NextIndex = 0;
+	}
+
+	Widgets.Step();
+
+	return Running;
+}
+
+static void GetStatistics(AnimationStatisticsType * statistics) {
+	if(!statistics) {
+		return;
+	}
+
+	*statistics = Statistics;
+}
+
+/**
+ * This is our animation instance
+ */
+AnimationInterfaceType Animation = {
+	SetClock: SetClock,
+	Start: Start,
+	StartCustom: StartCustom,
+	StartFade: StartFade,
+	Stop: Stop,
+	StopAll: StopAll,
+	Step: Step,
+	GetStatistics: GetStatistics
+};
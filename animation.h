@@ -0,0 +1,96 @@
+/*
+ * animation.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __ANIMATION_H__
+#define __ANIMATION_H__
+
+	#include "widget.h"
+
+	/**
+	 * defines how many animations can run at the same time
+	 */
+	#ifndef ANIMATION_POOL_SIZE
+		#define ANIMATION_POOL_SIZE 16
+	#endif
+
+	/**
+	 * defines the tween curves
+	 */
+	typedef enum {
+		Tween_Linear = 0,
+		Tween_EaseIn,
+		Tween_EaseOut,
+		Tween_EaseInOut
+	} TweenCurveType;
+
+	/**
+	 * defines the widget properties that can be animated
+	 */
+	typedef enum {
+		Animate_X = 0,
+		Animate_Y,
+		Animate_Width,
+		Animate_Height,
+		Animate_Value
+	} AnimationPropertyType;
+
+	/**
+	 * called with each new value of a custom animation. Report what you draw with Widgets.AddDamage
+	 */
+	typedef void (*AnimationApplyType)(void * context, int32_t value);
+
+	/**
+	 * defines a running animation. Treat it as a handle
+	 */
+	typedef struct AnimationType {
+		uint8_t Active;
+		uint8_t Curve;				///< TweenCurveType
+		uint8_t Property;			///< AnimationPropertyType
+		int32_t From;
+		int32_t To;
+		int32_t Last;				///< the value applied last
+		uint32_t StartMicroseconds;
+		uint32_t DurationMicroseconds;
+		WidgetType * Widget;		///< the widget, or NULL for a custom animation
+		AnimationApplyType Apply;
+		void * Context;
+	} AnimationType;
+
+	/**
+	 * defines the animation counters
+	 */
+	typedef struct AnimationStatisticsType {
+		uint32_t Frames;			///< Step calls
+		uint32_t Updates;			///< values that changed and were applied
+		uint32_t Deferred;			///< animations left for the next frame because the budget ran out
+		uint32_t Finished;			///< animations that reached their end value
+	} AnimationStatisticsType;
+
+	/**
+	 * defines the animation interface
+	 */
+	typedef struct AnimationInterfaceType {
+		/** sets the clock in microseconds. It must be monotonic and may wrap. Linux uses CLOCK_MONOTONIC by default **/
+		void (*SetClock)(uint32_t (*microseconds)(void));
+		/** animates a widget property from its current value **/
+		AnimationType * (*Start)(WidgetType * widget, uint_fast8_t property, int32_t to, uint32_t milliseconds, uint_fast8_t curve);
+		/** animates any value. apply is called each frame the value changes **/
+		AnimationType * (*StartCustom)(int32_t from, int32_t to, uint32_t milliseconds, uint_fast8_t curve, AnimationApplyType apply, void * context);
+		/** fades a display's brightness with setBrightness. A fade already running on the display is replaced and carries on from where it got to **/
+		AnimationType * (*StartFade)(DisplayInterfaceType * display, uint8_t from, uint8_t to, uint32_t milliseconds, uint_fast8_t curve);
+		/** stops an animation where it is **/
+		void (*Stop)(AnimationType * animation);
+		/** stops every animation of a widget, or all of them for NULL. Do this before destroying an animated widget **/
+		void (*StopAll)(WidgetType * widget);
+		/** moves every animation on to the current time and flushes once. Returns the number still running **/
+		uint32_t (*Step)(uint32_t budgetMicroseconds);
+		void (*GetStatistics)(AnimationStatisticsType * statistics);
+	} AnimationInterfaceType;
+
+	extern AnimationInterfaceType Animation;
+
+#endif /* __ANIMATION_H__ */
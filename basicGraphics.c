@@ -7,6 +7,7 @@
  * This is the a simple graphics library for drawing primitives, fonts and bitmaps
  */
 #include "basicGraphics.h"
+#include "glyphCache.h"
 #include <stdlib.h>
 #include "../common.h"
 
@@ -33,6 +34,30 @@ static void Init(DisplayInterfaceType * driver, const GFXfont * font) {
 	Driver = driver;
 }
 
+/**
+ * changes the driver that everything is drawn to, keeping the current font. This is how drawing
+ * is sent to an off screen surface (see Surface.Bind) and back to the display
+ *
+ * @param driver the new driver. NULL keeps the current one, which is then just returned
+ * @return the previous driver
+ */
+static DisplayInterfaceType * SetTarget(DisplayInterfaceType * driver) {
+	DisplayInterfaceType * Previous = Driver;
+
+	if(driver) {
+		Driver = driver;
+	}
+
+	return Previous;
+}
+
+/**
+ * @return the font used when none is given
+ */
+static const GFXfont * GetFont(void) {
+	return CurrentFont;
+}
+
 
 static void getStringJustificationPos(basicStringBoundType * TextBounds, GraphicsTextPostEnumType justification, uint32_t containerWidth, uint32_t containerHeight) {
 
@@ -95,30 +120,43 @@ static void getStringJustificationPos(basicStringBoundType * TextBounds, Graphic
 
 }
 /**
- * this function will return the give text height and width bound.
+ * clamps a font scale factor to the supported range
+ */
+static uint_fast8_t sanitiseScale(uint_fast8_t scale) {
+	if(!scale) {
+		return 1;
+	}
+
+	if(scale > BASIC_GRAPHICS_MAX_FONT_SCALE) {
+		return BASIC_GRAPHICS_MAX_FONT_SCALE;
+	}
+
+	return scale;
+}
+
+/**
+ * this function will return the give text height and width bound when drawn at the given scale.
  *
  * @param text is the pointer to the string to find screen bound
  * @param font is the font pointer
  * @param bounds pointer to return the new bound values
+ * @param scaleX horizontal scale factor, 1 to BASIC_GRAPHICS_MAX_FONT_SCALE
+ * @param scaleY vertical scale factor, 1 to BASIC_GRAPHICS_MAX_FONT_SCALE
  */
-static void getStringBounds(uint8_t * text, GFXfont * font, basicStringBoundType * bounds) {
+static void getStringBoundsScaled(uint8_t * text, GFXfont * font, basicStringBoundType * bounds, uint_fast8_t scaleX, uint_fast8_t scaleY) {
 	GFXglyph *Glyph;
-	uint8_t  *Bitmap;
 	uint8_t TempChar;
 	GFXfont * Font = font;
 
-	uint32_t YTemp = 0;
-	uint32_t XTemp = 0;
+	if(!bounds) {
+		return;
+	}
 
 	bounds->x = 0;
 	bounds->y = 0;
 	bounds->width = 0;
 	bounds->height = 0;
 
-	if(!bounds) {
-		return;
-	}
-
 	if(!Font) {
 		if(!CurrentFont) {
 			/// @TODO return invalid pointer error
@@ -127,8 +165,10 @@ static void getStringBounds(uint8_t * text, GFXfont * font, basicStringBoundType
 		Font = (GFXfont *)CurrentFont;
 	}
 
+	scaleX = sanitiseScale(scaleX);
+	scaleY = sanitiseScale(scaleY);
 
-	bounds->height = Font->maxHeight;
+	bounds->height = Font->maxHeight * scaleY;
 
 	while(*text) {
 		TempChar = *text;
@@ -139,7 +179,7 @@ static void getStringBounds(uint8_t * text, GFXfont * font, basicStringBoundType
 			TempChar -= Font->first;
 			Glyph  = &Font->glyph[TempChar];
 
-			bounds->width += Glyph->xAdvance;
+			bounds->width += Glyph->xAdvance * scaleX;
 		}
 
 		text++;
@@ -149,6 +189,37 @@ static void getStringBounds(uint8_t * text, GFXfont * font, basicStringBoundType
 		bounds->width = Driver->Width;
 	}
 }
+
+/**
+ * this function will return the give text height and width bound.
+ *
+ * @param text is the pointer to the string to find screen bound
+ * @param font is the font pointer
+ * @param bounds pointer to return the new bound values
+ */
+static void getStringBounds(uint8_t * text, GFXfont * font, basicStringBoundType * bounds) {
+	getStringBoundsScaled(text, font, bounds, 1, 1);
+}
+
+/**
+ * sets or clears a rectangle, using the driver's fill when it has one
+ */
+static void fillRectangle(int32_t x, int32_t y, int32_t width, int32_t height, uint_fast8_t colour) {
+	int32_t XIndex;
+	int32_t YIndex;
+
+	if(Driver->FillRect) {
+		Driver->FillRect(x, y, width, height, colour);
+		return;
+	}
+
+	for(YIndex = (y < 0 ? 0 : y); YIndex < (y + height); YIndex++) {
+		for(XIndex = (x < 0 ? 0 : x); XIndex < (x + width); XIndex++) {
+			Driver->SetPixel(XIndex, YIndex, colour);
+		}
+	}
+}
+
 /**
  * handles rendering the character with the given font.
  *
@@ -186,6 +257,28 @@ static GraphicsReturnType renderCharacter(	GFXglyph *glyph,
 	int32_t YIndex;
 	int32_t XIndex;
 
+	const uint8_t * PageRows;
+	uint_fast8_t Pages;
+	int32_t Top;
+	uint_fast8_t Phase;
+
+	// use the decoded glyph when the driver can take whole page bytes
+	if(Driver->BlitPage && Width && Height) {
+		Top = (int32_t)*yPos + yOffset;
+		Phase = Top & 7;
+		PageRows = GlyphCache.Get(glyph, bitmap, Phase, &Pages);
+
+		if(PageRows) {
+			// Top - Phase is a multiple of 8 so this divides exactly, negative or not
+			Top = (Top - (int32_t)Phase) / 8;
+
+			for(YIndex = 0; YIndex < Pages; YIndex++) {
+				Driver->BlitPage((int32_t)*xPos + xOffset, Top + YIndex, &PageRows[YIndex * Width], Width, 0xFF, colour ? Raster_Or : Raster_AndNot);
+			}
+
+			return BasicGReturned_OK;
+		}
+	}
 
 	/// @Todo Add character clipping here
 
@@ -209,15 +302,134 @@ static GraphicsReturnType renderCharacter(	GFXglyph *glyph,
 	return BasicGReturned_OK;
 }
 
+/**
+ * Expands a 4 bit nibble so every bit is repeated scale times. Indexed by scale - 1.
+ */
+static const uint16_t NibbleExpansion[BASIC_GRAPHICS_MAX_FONT_SCALE][16] = {
+	{0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF},
+	{0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF},
+	{0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF, 0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF},
+	{0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF, 0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF}
+};
+
+/**
+ * handles rendering a scaled character. Each glyph row is read 8 bits at a time, expanded with
+ * the nibble table and the runs of set bits are filled as scaleX by scaleY rectangles, so a row
+ * costs a few span fills instead of a SetPixel call per scaled pixel.
+ *
+ * @param glyph pointer to the character data structure
+ * @param bitmap pointer to the character bitmap data buffer
+ * @param xPos the X axis position
+ * @param yPos the Y axis position
+ * @param colour this is the colour that the text will be drawn as
+ * @param scaleX horizontal scale factor
+ * @param scaleY vertical scale factor
+ */
+static GraphicsReturnType renderCharacterScaled(GFXglyph *glyph,
+												uint8_t *bitmap,
+												int32_t xPos,
+												int32_t yPos,
+												uint_fast8_t colour,
+												uint_fast8_t scaleX,
+												uint_fast8_t scaleY) {
+
+	if(!Driver || !Driver->SetPixel) {
+		// invalid pointer
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	const uint16_t *Expansion = &NibbleExpansion[scaleX - 1][0];
+	int32_t OriginX = xPos + (glyph->xOffset * scaleX);
+	int32_t OriginY = yPos + (glyph->yOffset * scaleY);
+	uint32_t BitPosition = (uint32_t)glyph->bitmapOffset * 8;
+	uint_fast8_t ChunkBits;
+	uint_fast8_t ExpandedBits;
+	uint32_t Source;
+	uint32_t Word;
+	uint_fast8_t Count;
+	uint_fast8_t Used;
+	int32_t RunStart = 0;
+	uint_fast8_t InRun;
+	int32_t ChunkX;
+	int32_t Y;
+	uint32_t Row;
+	uint32_t Column;
+
+	for(Row = 0; Row < glyph->height; Row++) {
+		Y = OriginY + (int32_t)(Row * scaleY);
+		InRun = 0;
+
+		for(Column = 0; Column < glyph->width; Column += 8) {
+			ChunkBits = (glyph->width - Column) < 8 ? (glyph->width - Column) : 8;
+
+			// pull the next bits out of the stream, most significant bit first
+			Source = bitmap[BitPosition >> 3] << 8;
+			if((BitPosition & 7) + ChunkBits > 8) {
+				Source |= bitmap[(BitPosition >> 3) + 1];
+			}
+			Source = (Source << (BitPosition & 7)) >> 8;
+			Source &= (0xFF00 >> ChunkBits) & 0xFF;
+			BitPosition += ChunkBits;
+
+			// expand to scaleX bits per source bit and left align the result
+			ExpandedBits = ChunkBits * scaleX;
+			Word = ((uint32_t)Expansion[Source >> 4] << (4 * scaleX)) | Expansion[Source & 0x0F];
+			Word <<= 32 - (8 * scaleX);
+
+			ChunkX = OriginX + (int32_t)(Column * scaleX);
+			Used = 0;
+
+			// walk the runs of set and clear bits
+			while(Used < ExpandedBits) {
+				if(!InRun) {
+					if(!Word) {
+						break;
+					}
+					Count = __builtin_clz(Word);
+					if(Count >= (ExpandedBits - Used)) {
+						break;
+					}
+					Used += Count;
+					Word <<= Count;
+					RunStart = ChunkX + Used;
+					InRun = 1;
+				} else {
+					Count = (~Word) ? __builtin_clz(~Word) : 32;
+					if(Count > (ExpandedBits - Used)) {
+						Count = ExpandedBits - Used;
+					}
+					Used += Count;
+					Word = (Count >= 32) ? 0 : (Word << Count);
+
+					if(Used < ExpandedBits) {
+						fillRectangle(RunStart, Y, (ChunkX + Used) - RunStart, scaleY, colour);
+						InRun = 0;
+					}
+				}
+			}
+		}
+
+		// close a run that reaches the end of the row
+		if(InRun) {
+			fillRectangle(RunStart, Y, (OriginX + (int32_t)(glyph->width * scaleX)) - RunStart, scaleY, colour);
+		}
+	}
+
+	return BasicGReturned_OK;
+}
+
 /*
- * Handles drawing string onto the string
+ * Handles drawing a scaled string onto the screen
  *
  * @param *text is the pointer to a null terminated string
  * @param xPos is the X axis position
  * @param yPos is the Y axis position. Note that yPos is draw from bottom up which mean that the minimum yPos should be the text height
  * @param colour this is the colour that the text will be drawn as. Current only support monotone which is TRUE or FALSE.
+ * @param fontToUse the font to use or NULL for the current font
+ * @param scaleX horizontal scale factor, 1 to BASIC_GRAPHICS_MAX_FONT_SCALE
+ * @param scaleY vertical scale factor, 1 to BASIC_GRAPHICS_MAX_FONT_SCALE
  */
-static void WriteString(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8_t colour, const GFXfont * fontToUse) {
+static void WriteStringScaled(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8_t colour, const GFXfont * fontToUse, uint_fast8_t scaleX, uint_fast8_t scaleY) {
 	GFXglyph *Glyph;
 	uint8_t  *Bitmap;
 	uint8_t TempChar;
@@ -232,6 +444,9 @@ static void WriteString(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8
 		Font = (GFXfont *)CurrentFont;
 	}
 
+	scaleX = sanitiseScale(scaleX);
+	scaleY = sanitiseScale(scaleY);
+
 	while(*text) {
 		TempChar = *text;
 
@@ -244,15 +459,269 @@ static void WriteString(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8
 			// make sure that we aren't trying to render an empty character
 			if(Glyph->width && Glyph->height) {
 				Bitmap = Font->bitmap;
-				renderCharacter(Glyph, Bitmap, TempChar, &xPos, &yPos, colour);
+				if(scaleX == 1 && scaleY == 1) {
+					renderCharacter(Glyph, Bitmap, TempChar, &xPos, &yPos, colour);
+				} else {
+					renderCharacterScaled(Glyph, Bitmap, xPos, yPos, colour, scaleX, scaleY);
+				}
 			}
-			xPos += Glyph->xAdvance;
+			xPos += Glyph->xAdvance * scaleX;
 		}
 
 		text++;
 	}
 
 }
+
+/*
+ * Handles drawing string onto the string
+ *
+ * @param *text is the pointer to a null terminated string
+ * @param xPos is the X axis position
+ * @param yPos is the Y axis position. Note that yPos is draw from bottom up which mean that the minimum yPos should be the text height
+ * @param colour this is the colour that the text will be drawn as. Current only support monotone which is TRUE or FALSE.
+ */
+static void WriteString(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8_t colour, const GFXfont * fontToUse) {
+	WriteStringScaled(text, xPos, yPos, colour, fontToUse, 1, 1);
+}
+/**
+ * defines the glyphs needed to draw numbers in one font. Only the glyph pointers and bounds are
+ * kept, the bitmaps come from the glyph cache like any other text
+ */
+typedef struct {
+	const GFXfont * Font;
+	const GFXglyph * Digits[10];
+	const GFXglyph * Minus;
+	const GFXglyph * Plus;
+	const GFXglyph * Point;
+	const GFXglyph * Space;
+	uint_fast8_t Advance;		///< the advance of every number glyph, 0 if they differ
+	int_fast8_t Top;			///< the highest glyph row relative to the base line
+	int_fast8_t Bottom;			///< the row below the lowest glyph row relative to the base line
+} digitGlyphSetType;
+
+/**
+ * the number glyphs of the most recently used fonts
+ */
+static digitGlyphSetType DigitSets[BASIC_GRAPHICS_DIGIT_SETS];
+
+/**
+ * the next digit set to replace
+ */
+static uint_fast8_t NextDigitSet;
+
+/**
+ * @return the glyph of the given character or NULL if the font doesn't have it
+ */
+static const GFXglyph * getGlyph(const GFXfont * font, uint8_t character) {
+	if(character < font->first || character > font->last) {
+		return NULL;
+	}
+
+	return &font->glyph[character - font->first];
+}
+
+/**
+ * returns the font's number glyphs, looking them up and measuring them the first time the font is used
+ */
+static digitGlyphSetType * getDigitSet(const GFXfont * font) {
+	const GFXglyph * Glyphs[14];
+	digitGlyphSetType * Set;
+	uint_fast8_t Index;
+	int_fast8_t Bottom;
+
+	for(Index = 0; Index < BASIC_GRAPHICS_DIGIT_SETS; Index++) {
+		if(DigitSets[Index].Font == font) {
+			return &DigitSets[Index];
+		}
+	}
+
+	Set = &DigitSets[NextDigitSet];
+	NextDigitSet = (NextDigitSet + 1) % BASIC_GRAPHICS_DIGIT_SETS;
+
+	for(Index = 0; Index < 10; Index++) {
+		Set->Digits[Index] = getGlyph(font, '0' + Index);
+	}
+	Set->Minus = getGlyph(font, '-');
+	Set->Plus = getGlyph(font, '+');
+	Set->Point = getGlyph(font, '.');
+	Set->Space = getGlyph(font, ' ');
+
+	memcpy(&Glyphs[0], &Set->Digits[0], sizeof(Set->Digits));
+	Glyphs[10] = Set->Minus;
+	Glyphs[11] = Set->Plus;
+	Glyphs[12] = Set->Point;
+	Glyphs[13] = Set->Space;
+
+	Set->Advance = 0;
+	Set->Top = 0;
+	Set->Bottom = 0;
+
+	for(Index = 0; Index < 14; Index++) {
+		if(!Glyphs[Index]) {
+			continue;
+		}
+
+		if(!Set->Advance) {
+			Set->Advance = Glyphs[Index]->xAdvance;
+		} else if(Set->Advance != Glyphs[Index]->xAdvance) {
+			Set->Advance = 0xFF;
+		}
+
+		if(Glyphs[Index]->width && Glyphs[Index]->height) {
+			Bottom = Glyphs[Index]->yOffset + Glyphs[Index]->height;
+			if(Glyphs[Index]->yOffset < Set->Top) {
+				Set->Top = Glyphs[Index]->yOffset;
+			}
+			if(Bottom > Set->Bottom) {
+				Set->Bottom = Bottom;
+			}
+		}
+	}
+
+	// mixed advances mean the font isn't monospaced
+	if(Set->Advance == 0xFF) {
+		Set->Advance = 0;
+	}
+
+	Set->Font = font;
+
+	return Set;
+}
+
+/**
+ * drops the font's digit set, so that its glyphs are looked up again the next time it is used
+ */
+static void ForgetFont(const GFXfont * font) {
+	uint_fast8_t Index;
+
+	for(Index = 0; Index < BASIC_GRAPHICS_DIGIT_SETS; Index++) {
+		if(DigitSets[Index].Font == font) {
+			DigitSets[Index].Font = NULL;
+		}
+	}
+}
+
+/**
+ * Draws a fixed point number without formatting it into a string first. The glyphs are picked
+ * straight from the font's digit set and, for monospaced fonts, the field width is known
+ * up front so right alignment and clearing cost nothing extra.
+ *
+ * @param value the number. With decimals the value is scaled, e.g. 1234 with 2 decimals is 12.34
+ * @param decimals number of digits after the decimal point
+ * @param xPos is the X axis position, or the right edge with Number_RightAlign
+ * @param yPos is the Y axis position of the base line
+ * @param width minimum field width in characters
+ * @param flags GraphicsNumberFlagType options
+ * @param colour this is the colour that the text will be drawn as
+ * @param fontToUse the font to use or NULL for the current font
+ */
+static void WriteFixed(int32_t value, uint_fast8_t decimals, uint32_t xPos, uint32_t yPos, uint_fast8_t width, uint_fast8_t flags, uint_fast8_t colour, const GFXfont * fontToUse) {
+	const GFXglyph * Glyphs[BASIC_GRAPHICS_MAX_NUMBER_WIDTH];
+	const GFXglyph * Sign = NULL;
+	const GFXfont * Font = fontToUse;
+	digitGlyphSetType * Set;
+	uint32_t Magnitude;
+	uint32_t FieldWidth;
+	uint_fast8_t Count = 0;
+	uint_fast8_t Digits = 0;
+	uint_fast8_t Index;
+	uint_fast8_t Pad;
+
+	if(!CurrentFont || !Driver || !Driver->SetPixel) {
+		/// @TODO return invalid pointer error
+		return;
+	}
+
+	if(!Font) {
+		Font = CurrentFont;
+	}
+
+	Set = getDigitSet(Font);
+
+	if(width > BASIC_GRAPHICS_MAX_NUMBER_WIDTH) {
+		width = BASIC_GRAPHICS_MAX_NUMBER_WIDTH;
+	}
+
+	Magnitude = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+
+	if(value < 0) {
+		Sign = Set->Minus;
+	} else if(flags & Number_ShowSign) {
+		Sign = Set->Plus;
+	}
+
+	// build the digits from the right, the point goes in after the decimals
+	Index = BASIC_GRAPHICS_MAX_NUMBER_WIDTH;
+	do {
+		if(decimals && Digits == decimals) {
+			Glyphs[--Index] = Set->Point;
+		}
+
+		Glyphs[--Index] = Set->Digits[Magnitude % 10];
+		Magnitude /= 10;
+		Digits++;
+	} while((Magnitude || Digits <= decimals) && Index > 2);
+
+	Count = BASIC_GRAPHICS_MAX_NUMBER_WIDTH - Index;
+
+	// pad out to the field width, zeros go after the sign and spaces before it
+	Pad = (width > (Count + (Sign ? 1 : 0))) ? (width - Count - (Sign ? 1 : 0)) : 0;
+
+	if(flags & Number_PadZero) {
+		for( ; Pad && Index > 1; Pad--) {
+			Glyphs[--Index] = Set->Digits[0];
+		}
+	}
+
+	if(Sign && Index) {
+		Glyphs[--Index] = Sign;
+	}
+
+	for( ; Pad && Index; Pad--) {
+		Glyphs[--Index] = Set->Space;
+	}
+
+	Count = BASIC_GRAPHICS_MAX_NUMBER_WIDTH - Index;
+
+	// work out the field width
+	if(Set->Advance) {
+		FieldWidth = (uint32_t)Count * Set->Advance;
+	} else {
+		FieldWidth = 0;
+		for(Pad = Index; Pad < BASIC_GRAPHICS_MAX_NUMBER_WIDTH; Pad++) {
+			FieldWidth += Glyphs[Pad] ? Glyphs[Pad]->xAdvance : 0;
+		}
+	}
+
+	if(flags & Number_RightAlign) {
+		xPos -= FieldWidth;
+	}
+
+	if(flags & Number_ClearField) {
+		fillRectangle(xPos, (int32_t)yPos + Set->Top, FieldWidth, Set->Bottom - Set->Top, !colour);
+	}
+
+	for( ; Index < BASIC_GRAPHICS_MAX_NUMBER_WIDTH; Index++) {
+		if(!Glyphs[Index]) {
+			continue;
+		}
+
+		if(Glyphs[Index]->width && Glyphs[Index]->height) {
+			renderCharacter((GFXglyph *)Glyphs[Index], Font->bitmap, 0, &xPos, &yPos, colour);
+		}
+
+		xPos += Glyphs[Index]->xAdvance;
+	}
+}
+
+/**
+ * Draws an integer. See WriteFixed for the parameters
+ */
+static void WriteInt(int32_t value, uint32_t xPos, uint32_t yPos, uint_fast8_t width, uint_fast8_t flags, uint_fast8_t colour, const GFXfont * fontToUse) {
+	WriteFixed(value, 0, xPos, yPos, width, flags, colour, fontToUse);
+}
+
 /**
  * this function should be call to clean and free up resources
  */
@@ -284,6 +753,21 @@ static void Flush(void) {
 	Driver->Sync();
 }
 
+/**
+ * @return true if something was drawn since the last flush. Drivers that don't track this are always dirty
+ */
+static uint_fast8_t IsDirty(void) {
+	if(!Driver) {
+		return false;
+	}
+
+	if(!Driver->IsDirty) {
+		return true;
+	}
+
+	return Driver->IsDirty();
+}
+
 /**
  * Sanitases the X and Y coordinates to ensure that it doesn't surpases the screen range
  */
@@ -414,7 +898,7 @@ void drawCircle(int32_t x0, int32_t y0, int32_t  radius, uint_fast8_t colour, ui
 	int32_t y = 0;
 	int32_t dx = 1;
 	int32_t dy = 1;
-	int32_t err = dx - (radius << 1);
+	int32_t err = dx - (radius * 2);
 
     while (x >= y) {
 
@@ -449,11 +933,220 @@ void drawCircle(int32_t x0, int32_t y0, int32_t  radius, uint_fast8_t colour, ui
         if (err > 0) {
             x--;
             dx += 2;
-            err += dx - (radius << 1);
+            err += dx - (radius * 2);
         }
     }
 }
 
+/**
+ * defines a run of filled pixels whose neighbours in the next row still have to be looked at
+ */
+typedef struct {
+	int32_t Row;		///< the row that was filled
+	int32_t Left;
+	int32_t Right;		///< the last filled column
+	int32_t Direction;	///< 1 to look at the row below, -1 for the row above
+} floodFillSpanType;
+
+/**
+ * keeps the page bytes the flood fill last read, so most pixels don't need a driver call
+ */
+typedef struct {
+	int32_t Page;		///< -1 when nothing is held
+	int32_t First;		///< the column of Bytes[0]
+	uint32_t Count;
+	uint8_t Bytes[32];
+} floodFillReaderType;
+
+/**
+ * the spans waiting to be looked at
+ */
+static floodFillSpanType FloodFillSpans[BASIC_GRAPHICS_FLOOD_FILL_SPANS];
+
+/**
+ * @return a pixel of the display buffer
+ */
+static uint_fast8_t floodFillRead(floodFillReaderType * reader, int32_t x, int32_t y) {
+	int32_t Page = y / 8;
+
+	if(!Driver->ReadPage) {
+		return Driver->GetPixel(x, y) ? 1 : 0;
+	}
+
+	if(Page != reader->Page || x < reader->First || x >= (reader->First + (int32_t)reader->Count)) {
+		reader->Page = Page;
+		reader->First = x & ~(int32_t)(sizeof(reader->Bytes) - 1);
+		reader->Count = Driver->ReadPage(reader->First, Page, &reader->Bytes[0], sizeof(reader->Bytes));
+
+		if(x >= (reader->First + (int32_t)reader->Count)) {
+			return 0;
+		}
+	}
+
+	return (reader->Bytes[x - reader->First] >> (y & 7)) & 0x01;
+}
+
+/**
+ * queues a filled span so the row next to it gets looked at
+ *
+ * @return false when there is no room left
+ */
+static uint_fast8_t floodFillPush(uint32_t * depth, int32_t row, int32_t left, int32_t right, int32_t direction) {
+	floodFillSpanType * Span;
+
+	if((row + direction) < 0 || (row + direction) >= (int32_t)Driver->Height) {
+		return true;
+	}
+
+	if(*depth >= BASIC_GRAPHICS_FLOOD_FILL_SPANS) {
+		return false;
+	}
+
+	Span = &FloodFillSpans[(*depth)++];
+	Span->Row = row;
+	Span->Left = left;
+	Span->Right = right;
+	Span->Direction = direction;
+
+	return true;
+}
+
+/**
+ * fills a run and queues the parts of it that really changed. Pixels the driver drops, such as
+ * where a canvas has no panel, keep reading back unfilled and are treated as a border
+ *
+ * @param parent the span the run was found from, NULL for the seed run
+ * @return false if the stack ran out
+ */
+static uint_fast8_t floodFillRun(floodFillReaderType * reader, uint32_t * depth, int32_t row, int32_t left, int32_t right, const floodFillSpanType * parent, uint_fast8_t target, uint_fast8_t colour) {
+	uint_fast8_t Complete = true;
+	int32_t Column = left;
+	int32_t First;
+	int32_t Last;
+
+	fillRectangle(left, row, right - left + 1, 1, colour);
+	reader->Page = -1;
+
+	while(Column <= right) {
+		while(Column <= right && floodFillRead(reader, Column, row) == target) {
+			Column++;
+		}
+
+		First = Column;
+		while(Column <= right && floodFillRead(reader, Column, row) != target) {
+			Column++;
+		}
+		Last = Column - 1;
+
+		if(First > Last) {
+			break;
+		}
+
+		if(!parent) {
+			Complete &= floodFillPush(depth, row, First, Last, 1);
+			Complete &= floodFillPush(depth, row, First, Last, -1);
+			continue;
+		}
+
+		Complete &= floodFillPush(depth, row, First, Last, parent->Direction);
+
+		// the parts that stick out past the span can leak back round
+		if(First < parent->Left) {
+			Complete &= floodFillPush(depth, row, First, Last < parent->Left ? Last : parent->Left - 1, -parent->Direction);
+		}
+		if(Last > parent->Right) {
+			Complete &= floodFillPush(depth, row, First > parent->Right ? First : parent->Right + 1, Last, -parent->Direction);
+		}
+	}
+
+	return Complete;
+}
+
+/**
+ * fills the area around a pixel that is not yet in the colour, up to the pixels that are. Whole
+ * runs of a row are found and filled at a time, and the rows above and below each run wait on a
+ * fixed size stack rather than being recursed into.
+ *
+ * @param x seed x position
+ * @param y seed y position
+ * @param colour the fill colour
+ * @return BasicGReturned_Error if the driver can't read pixels back or the stack ran out, in which case part of the area is left unfilled
+ */
+static GraphicsReturnType floodFill(int32_t x, int32_t y, uint_fast8_t colour) {
+	floodFillReaderType Reader;
+	floodFillSpanType Span;
+	uint32_t Depth = 0;
+	uint_fast8_t Target;
+	uint_fast8_t Complete = true;
+	int32_t Width;
+	int32_t Row;
+	int32_t Column;
+	int32_t Left;
+
+	if(!Driver || !Driver->SetPixel || (!Driver->ReadPage && !Driver->GetPixel)) {
+		return BasicGReturned_Error;
+	}
+
+	Width = Driver->Width;
+
+	if(x < 0 || y < 0 || x >= Width || y >= (int32_t)Driver->Height) {
+		return BasicGReturned_OK;
+	}
+
+	colour = colour ? 1 : 0;
+	Target = !colour;
+	Reader.Page = -1;
+
+	if(floodFillRead(&Reader, x, y) != Target) {
+		return BasicGReturned_OK;
+	}
+
+	// the seed run goes both ways
+	Left = x;
+	while(Left > 0 && floodFillRead(&Reader, Left - 1, y) == Target) {
+		Left--;
+	}
+	while(x < (Width - 1) && floodFillRead(&Reader, x + 1, y) == Target) {
+		x++;
+	}
+
+	Complete = floodFillRun(&Reader, &Depth, y, Left, x, NULL, Target, colour);
+
+	while(Depth) {
+		Span = FloodFillSpans[--Depth];
+		Row = Span.Row + Span.Direction;
+		Column = Span.Left;
+		Reader.Page = -1;
+
+		while(Column <= Span.Right) {
+			// skip to the next run that touches the span
+			while(Column <= Span.Right && floodFillRead(&Reader, Column, Row) != Target) {
+				Column++;
+			}
+			if(Column > Span.Right) {
+				break;
+			}
+
+			// only the first run can start left of the span
+			Left = Column;
+			if(Column == Span.Left) {
+				while(Left > 0 && floodFillRead(&Reader, Left - 1, Row) == Target) {
+					Left--;
+				}
+			}
+			while(Column < (Width - 1) && floodFillRead(&Reader, Column + 1, Row) == Target) {
+				Column++;
+			}
+
+			Complete &= floodFillRun(&Reader, &Depth, Row, Left, Column, &Span, Target, colour);
+
+			Column += 2;
+		}
+	}
+
+	return Complete ? BasicGReturned_OK : BasicGReturned_Error;
+}
+
 /**
 * this is the data size for the icon array
 */
@@ -483,22 +1176,20 @@ static void drawIcon(int32_t x, int32_t y, uint32_t height, uint32_t width, uint
 	uint32_t HeightIndex;
 	uint32_t WidthIndex;
 	uint32_t BitIndex = 0;
-	uint32_t Value = *source;
+	uint32_t Value = 0;
 
 	for(WidthIndex = 0 ; WidthIndex < width; WidthIndex++) {
 		for(HeightIndex = 0 ;HeightIndex < height; HeightIndex++) {
-			
-			Driver->SetPixel(x + WidthIndex, y + HeightIndex, (Value & 0x80000000) ? colour : 0);
 
-			if(BitIndex < (IconDataBitSize -1)) {
-				BitIndex++;
-				Value = Value << 1;
-			} else {
-				BitIndex = 0;
-				source++;
-				Value = *source;
+			// only load a word once it is needed so we never read past the end of the icon
+			if(!BitIndex) {
+				Value = *source++;
 			}
-			
+
+			Driver->SetPixel(x + WidthIndex, y + HeightIndex, (Value & 0x80000000) ? colour : 0);
+
+			Value = Value << 1;
+			BitIndex = (BitIndex + 1) & (IconDataBitSize - 1);
 		}
 	}
 }
@@ -519,17 +1210,26 @@ static void Reset(uint_fast8_t resetBuffer) {
  */
 SimpleGraphcisType GraphicsInstance = {
 		Init: Init,
+		SetTarget: SetTarget,
+		GetFont: GetFont,
 		Reset: Reset,
 		Destroy: Destroy,
 		Clear: Clear,
 		Flush: Flush,
 		WriteString: WriteString,
 		GetStringBounds: getStringBounds,
+		WriteStringScaled: WriteStringScaled,
+		WriteInt: WriteInt,
+		WriteFixed: WriteFixed,
+		ForgetFont: ForgetFont,
+		GetStringBoundsScaled: getStringBoundsScaled,
 		getStringJustificationPos : getStringJustificationPos,
 		drawLine: drawLine,
 		drawCircle: drawCircle,
 		drawRectagle: drawRectagle,
 		drawIcon : drawIcon,
+		floodFill : floodFill,
 		drawFullScreen : drawFullScreen,
-		Fill: Fill
+		Fill: Fill,
+		IsDirty: IsDirty
 };
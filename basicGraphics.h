@@ -15,6 +15,11 @@
 	#include "Fonts/gfxfont.h"
 	#include "displayDriver.h"
 
+	/**
+	 * the largest font scale factor
+	 */
+	#define BASIC_GRAPHICS_MAX_FONT_SCALE 4
+
 	/**
 	 * this is the justification of a text
 	 */
@@ -28,6 +33,32 @@
 		Text_RightTop,
 	} GraphicsTextPostEnumType;
 
+	/**
+	 * defines the number formatting options for WriteInt and WriteFixed. These can be combined
+	 */
+	typedef enum {
+		Number_Default = 0x00,
+		Number_PadZero = 0x01,		///< pad to the field width with zeros instead of spaces
+		Number_ShowSign = 0x02,		///< show a + for positive values
+		Number_RightAlign = 0x04,	///< xPos is the right edge of the field
+		Number_ClearField = 0x08	///< clear the field's box before drawing
+	} GraphicsNumberFlagType;
+
+	/**
+	 * the widest number field in characters
+	 */
+	#define BASIC_GRAPHICS_MAX_NUMBER_WIDTH 16
+
+	/**
+	 * how many fonts keep their number glyphs looked up at the same time
+	 */
+	#define BASIC_GRAPHICS_DIGIT_SETS 4
+
+	/**
+	 * how many spans the flood fill can have waiting. Each one takes 16 bytes
+	 */
+	#define BASIC_GRAPHICS_FLOOD_FILL_SPANS 128
+
 	/**
 	 * defines the data structure for working out the a string bound based on a given font
 	 */
@@ -52,20 +83,30 @@
 	 */
 	typedef struct SimpleGraphcisType {
 		void (*Init) (DisplayInterfaceType * driver, const GFXfont * font);
+		DisplayInterfaceType * (*SetTarget) (DisplayInterfaceType * driver);
+		const GFXfont * (*GetFont) (void);
 		void (*Destroy) (void);
 		void (*Reset) (uint_fast8_t resetBuffer);
 		void (*Clear)(void);
 		void (*Flush)(void);
 		void (*WriteString)(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8_t colour, const GFXfont * fontToUse);
 		void (*GetStringBounds)(uint8_t * text, GFXfont * font, basicStringBoundType * bounds);
+		void (*WriteStringScaled)(uint8_t * text, uint32_t xPos, uint32_t yPos, uint_fast8_t colour, const GFXfont * fontToUse, uint_fast8_t scaleX, uint_fast8_t scaleY);
+		void (*WriteInt)(int32_t value, uint32_t xPos, uint32_t yPos, uint_fast8_t width, uint_fast8_t flags, uint_fast8_t colour, const GFXfont * fontToUse);
+		void (*WriteFixed)(int32_t value, uint_fast8_t decimals, uint32_t xPos, uint32_t yPos, uint_fast8_t width, uint_fast8_t flags, uint_fast8_t colour, const GFXfont * fontToUse);
+		/** drops what WriteInt and WriteFixed looked up about the font. Call it before the font's glyphs are freed or changed **/
+		void (*ForgetFont)(const GFXfont * font);
+		void (*GetStringBoundsScaled)(uint8_t * text, GFXfont * font, basicStringBoundType * bounds, uint_fast8_t scaleX, uint_fast8_t scaleY);
 		void (*getStringJustificationPos)(basicStringBoundType * TextBounds, GraphicsTextPostEnumType justification, uint32_t containerWidth, uint32_t containerHeight);
 		void (*drawLine)(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour);
 		void (*drawCircle)(int32_t x0, int32_t y0, int32_t radius, uint_fast8_t colour, uint_fast8_t fill);
 		void (*drawRectagle)(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour, uint_fast8_t fill);
 		void (*drawFullScreen)(uint8_t *source);
 		void (*drawIcon) (int32_t x, int32_t y, uint32_t height, uint32_t width, uint_fast8_t colour, uint32_t *source);
+		GraphicsReturnType (*floodFill)(int32_t x, int32_t y, uint_fast8_t colour);
 		void (*Fill)(uint8_t value);
 		void (*Update)(void);
+		uint_fast8_t (*IsDirty)(void);
 	} SimpleGraphcisType;
 
 
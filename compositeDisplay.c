@@ -0,0 +1,814 @@
+/*
+ * compositeDisplay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * A display made of several panels, so that a wall of small displays can be drawn on as one
+ * canvas with a single GraphicsInstance.
+ *
+ * Nothing is buffered here. Every call is cut up by the panels it touches and handed to their own
+ * drivers in panel coordinates, and each panel remembers the part of it that has been drawn on.
+ * Sync and SyncRegion only send those parts, and panels on different buses are sent from their own
+ * threads so that the buses work at the same time. The threads are started by
+ * CompositeDisplaySetup and wait between syncs, so a sync doesn't pay for creating them.
+ */
+#include <errno.h>
+#include <string.h>
+#include "basicGraphics.h"
+#include "compositeDisplay.h"
+#if COMPOSITE_DISPLAY_THREADS
+	#include "workerPool.h"
+#endif
+
+/**
+ * defines a rectangle. The end is exclusive
+ */
+typedef struct {
+	int32_t X;
+	int32_t Y;
+	int32_t XEnd;
+	int32_t YEnd;
+} compositeRectType;
+
+/**
+ * defines the state of one panel
+ */
+typedef struct {
+	CompositePanelType Panel;
+	int32_t Width;					///< the area the panel covers on the canvas
+	int32_t Height;
+	compositeRectType Dirty;		///< panel coordinates drawn on since the last send, empty when X >= XEnd
+	compositeRectType Send;			///< panel coordinates the current flush sends
+	uint8_t BusIndex;				///< the panel's bus in Buses
+} compositePanelStateType;
+
+/**
+ * the panels
+ */
+static compositePanelStateType Panels[COMPOSITE_DISPLAY_MAX_PANELS];
+
+/**
+ * number of panels in use
+ */
+static uint32_t PanelCount;
+
+/**
+ * the different buses the panels are on
+ */
+static uint8_t Buses[COMPOSITE_DISPLAY_MAX_PANELS];
+static uint32_t BusCount;
+
+#if COMPOSITE_DISPLAY_THREADS
+/**
+ * the bus workers. Worker n sends Buses[n] and the first bus is sent from the thread that syncs.
+ * Buses after the last worker that started are sent from the syncing thread too
+ */
+static void sendWorkerBus(uint32_t worker);
+static WorkerPoolType Pool = WORKER_POOL_INIT(sendWorkerBus);
+#endif
+
+/**
+ * @return true if the rectangle is empty
+ */
+static uint_fast8_t rectIsEmpty(const compositeRectType * rect) {
+	return rect->X >= rect->XEnd || rect->Y >= rect->YEnd;
+}
+
+/**
+ * cuts a rectangle down to the part inside another
+ */
+static void rectIntersect(compositeRectType * rect, const compositeRectType * clip) {
+	if(rect->X < clip->X) {
+		rect->X = clip->X;
+	}
+	if(rect->Y < clip->Y) {
+		rect->Y = clip->Y;
+	}
+	if(rect->XEnd > clip->XEnd) {
+		rect->XEnd = clip->XEnd;
+	}
+	if(rect->YEnd > clip->YEnd) {
+		rect->YEnd = clip->YEnd;
+	}
+}
+
+/**
+ * turns a point on the panel's part of the canvas into panel coordinates
+ */
+static void toPanel(const compositePanelStateType * state, int32_t x, int32_t y, int32_t * panelX, int32_t * panelY) {
+	x -= state->Panel.X;
+	y -= state->Panel.Y;
+
+	switch(state->Panel.Orientation) {
+		case Composite_Rotate90:
+			*panelX = y;
+			*panelY = state->Width - 1 - x;
+		break;
+
+		case Composite_Rotate180:
+			*panelX = state->Width - 1 - x;
+			*panelY = state->Height - 1 - y;
+		break;
+
+		case Composite_Rotate270:
+			*panelX = state->Height - 1 - y;
+			*panelY = x;
+		break;
+
+		default:
+			*panelX = x;
+			*panelY = y;
+		break;
+	}
+}
+
+/**
+ * cuts a canvas rectangle down to a panel and turns it into panel coordinates
+ *
+ * @param rect canvas rectangle
+ * @param panelRect receives the panel rectangle
+ * @return false if the rectangle misses the panel
+ */
+static uint_fast8_t toPanelRect(const compositePanelStateType * state, const compositeRectType * rect, compositeRectType * panelRect) {
+	compositeRectType Footprint = {X: state->Panel.X, Y: state->Panel.Y, XEnd: state->Panel.X + state->Width, YEnd: state->Panel.Y + state->Height};
+	compositeRectType Clipped = *rect;
+	int32_t FirstX;
+	int32_t FirstY;
+	int32_t LastX;
+	int32_t LastY;
+
+	rectIntersect(&Clipped, &Footprint);
+
+	if(rectIsEmpty(&Clipped)) {
+		return 0;
+	}
+
+	toPanel(state, Clipped.X, Clipped.Y, &FirstX, &FirstY);
+	toPanel(state, Clipped.XEnd - 1, Clipped.YEnd - 1, &LastX, &LastY);
+
+	panelRect->X = FirstX < LastX ? FirstX : LastX;
+	panelRect->Y = FirstY < LastY ? FirstY : LastY;
+	panelRect->XEnd = (FirstX < LastX ? LastX : FirstX) + 1;
+	panelRect->YEnd = (FirstY < LastY ? LastY : FirstY) + 1;
+
+	return 1;
+}
+
+/**
+ * adds panel coordinates to what the panel has to send
+ */
+static void markDirty(compositePanelStateType * state, const compositeRectType * rect) {
+	if(rectIsEmpty(&state->Dirty)) {
+		state->Dirty = *rect;
+		return;
+	}
+
+	if(rect->X < state->Dirty.X) {
+		state->Dirty.X = rect->X;
+	}
+	if(rect->Y < state->Dirty.Y) {
+		state->Dirty.Y = rect->Y;
+	}
+	if(rect->XEnd > state->Dirty.XEnd) {
+		state->Dirty.XEnd = rect->XEnd;
+	}
+	if(rect->YEnd > state->Dirty.YEnd) {
+		state->Dirty.YEnd = rect->YEnd;
+	}
+}
+
+/**
+ * marks the whole of every panel as drawn on
+ */
+static void markAllDirty(void) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		compositeRectType All = {X: 0, Y: 0, XEnd: Panels[Index].Panel.Display->Width, YEnd: Panels[Index].Panel.Display->Height};
+
+		Panels[Index].Dirty = All;
+	}
+}
+
+/**
+ * @return the panel that shows a canvas pixel or NULL
+ */
+static compositePanelStateType * findPanel(int32_t x, int32_t y) {
+	uint32_t Index;
+	compositePanelStateType * State;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		State = &Panels[Index];
+
+		if(x >= State->Panel.X && y >= State->Panel.Y && x < (State->Panel.X + State->Width) && y < (State->Panel.Y + State->Height)) {
+			return State;
+		}
+	}
+
+	return NULL;
+}
+
+static void SetPixel(uint32_t x, uint32_t y, uint8_t value) {
+	compositePanelStateType * State = findPanel(x, y);
+	compositeRectType Pixel;
+
+	if(!State || x > INT32_MAX || y > INT32_MAX) {
+		return;
+	}
+
+	toPanel(State, x, y, &Pixel.X, &Pixel.Y);
+	Pixel.XEnd = Pixel.X + 1;
+	Pixel.YEnd = Pixel.Y + 1;
+
+	State->Panel.Display->SetPixel(Pixel.X, Pixel.Y, value);
+	markDirty(State, &Pixel);
+}
+
+static uint_fast8_t GetPixel(uint32_t x, uint32_t y) {
+	compositePanelStateType * State = findPanel(x, y);
+	int32_t PanelX;
+	int32_t PanelY;
+
+	if(!State || !State->Panel.Display->GetPixel || x > INT32_MAX || y > INT32_MAX) {
+		return 0;
+	}
+
+	toPanel(State, x, y, &PanelX, &PanelY);
+
+	return State->Panel.Display->GetPixel(PanelX, PanelY);
+}
+
+/**
+ * sets or clears a rectangle on every panel it reaches
+ */
+static void FillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) {
+	compositeRectType Rect = {X: x, Y: y, XEnd: x + width, YEnd: y + height};
+	compositeRectType PanelRect;
+	DisplayInterfaceType * Display;
+	uint32_t Index;
+	int32_t Row;
+	int32_t Column;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(!toPanelRect(&Panels[Index], &Rect, &PanelRect)) {
+			continue;
+		}
+
+		Display = Panels[Index].Panel.Display;
+
+		if(Display->FillRect) {
+			Display->FillRect(PanelRect.X, PanelRect.Y, PanelRect.XEnd - PanelRect.X, PanelRect.YEnd - PanelRect.Y, value);
+		} else {
+			for(Row = PanelRect.Y; Row < PanelRect.YEnd; Row++) {
+				for(Column = PanelRect.X; Column < PanelRect.XEnd; Column++) {
+					Display->SetPixel(Column, Row, value);
+				}
+			}
+		}
+
+		markDirty(&Panels[Index], &PanelRect);
+	}
+}
+
+/**
+ * combines a run of page bytes into a panel a pixel at a time, for panels that are turned
+ *
+ * @return BasicGReturned_Error for Raster_Xor on a panel that can't be read back
+ */
+static GraphicsReturnType blitPixels(compositePanelStateType * state, const compositeRectType * rect, int32_t x, int32_t page, const uint8_t * source, uint8_t mask, uint_fast8_t operation) {
+	DisplayInterfaceType * Display = state->Panel.Display;
+	int32_t Column;
+	int32_t Row;
+	int32_t PanelX;
+	int32_t PanelY;
+	uint_fast8_t Bit;
+	uint_fast8_t Value;
+
+	if(operation == Raster_Xor && !Display->GetPixel) {
+		return BasicGReturned_Error;
+	}
+
+	for(Column = rect->X; Column < rect->XEnd; Column++) {
+		for(Row = rect->Y; Row < rect->YEnd; Row++) {
+			Bit = Row - (page * 8);
+
+			if(!(mask & (1 << Bit))) {
+				continue;
+			}
+
+			Value = (source[Column - x] >> Bit) & 0x01;
+			toPanel(state, Column, Row, &PanelX, &PanelY);
+
+			switch(operation) {
+				case Raster_Or:
+					if(Value) {
+						Display->SetPixel(PanelX, PanelY, 1);
+					}
+				break;
+
+				case Raster_AndNot:
+					if(Value) {
+						Display->SetPixel(PanelX, PanelY, 0);
+					}
+				break;
+
+				case Raster_Xor:
+					if(Value) {
+						Display->SetPixel(PanelX, PanelY, !Display->GetPixel(PanelX, PanelY));
+					}
+				break;
+
+				case Raster_Copy:
+				default:
+					Display->SetPixel(PanelX, PanelY, Value);
+				break;
+			}
+		}
+	}
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * combines a run of page bytes into a panel that isn't turned but starts part way down a page,
+ * so each canvas page is split over two panel pages
+ *
+ * @param panelPage the first of the two panel pages
+ * @param shift how far down the panel page the canvas page starts
+ */
+static void blitShifted(DisplayInterfaceType * display, int32_t x, int32_t panelPage, uint_fast8_t shift, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	uint8_t Upper[64];
+	uint8_t Lower[64];
+	uint32_t Done;
+	uint32_t Count;
+	uint32_t Index;
+
+	for(Done = 0; Done < length; Done += Count) {
+		Count = length - Done;
+		if(Count > sizeof(Upper)) {
+			Count = sizeof(Upper);
+		}
+
+		for(Index = 0; Index < Count; Index++) {
+			Upper[Index] = source[Done + Index] << shift;
+			Lower[Index] = source[Done + Index] >> (8 - shift);
+		}
+
+		display->BlitPage(x + Done, panelPage, &Upper[0], Count, (uint8_t)(mask << shift), operation);
+		display->BlitPage(x + Done, panelPage + 1, &Lower[0], Count, mask >> (8 - shift), operation);
+	}
+}
+
+/**
+ * combines a run of page bytes into every panel it reaches
+ */
+static void BlitPage(int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	compositeRectType Rect = {X: x, Y: page * 8, XEnd: x + (int32_t)length, YEnd: (page * 8) + 8};
+	compositeRectType Clipped;
+	compositeRectType PanelRect;
+	compositePanelStateType * State;
+	uint32_t Index;
+	int32_t Offset;
+	int32_t PanelPage;
+
+	if(!source || page < 0) {
+		return;
+	}
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		State = &Panels[Index];
+
+		if(!toPanelRect(State, &Rect, &PanelRect)) {
+			continue;
+		}
+
+		if(State->Panel.Orientation != Composite_Rotate0 || !State->Panel.Display->BlitPage) {
+			compositeRectType Footprint = {X: State->Panel.X, Y: State->Panel.Y, XEnd: State->Panel.X + State->Width, YEnd: State->Panel.Y + State->Height};
+
+			Clipped = Rect;
+			rectIntersect(&Clipped, &Footprint);
+
+			// the panel is left as it was rather than drawn wrong
+			if(blitPixels(State, &Clipped, x, page, source, mask, operation) != BasicGReturned_OK) {
+				continue;
+			}
+		} else {
+			// the panel clips the columns itself
+			Offset = (page * 8) - State->Panel.Y;
+			PanelPage = (Offset >= 0 ? Offset : Offset - 7) / 8;
+
+			if(Offset == PanelPage * 8) {
+				State->Panel.Display->BlitPage(x - State->Panel.X, PanelPage, source, length, mask, operation);
+			} else {
+				blitShifted(State->Panel.Display, x - State->Panel.X, PanelPage, Offset - (PanelPage * 8), source, length, mask, operation);
+			}
+		}
+
+		markDirty(State, &PanelRect);
+	}
+}
+
+/**
+ * copies a run of canvas page bytes out of the panels. Parts no panel covers are 0
+ *
+ * @return the number of bytes copied
+ */
+static uint32_t ReadPage(int32_t x, int32_t page, uint8_t * destination, uint32_t length) {
+	compositeRectType Rect = {X: x, Y: page * 8, XEnd: x + (int32_t)length, YEnd: (page * 8) + 8};
+	compositeRectType Footprint;
+	compositePanelStateType * State;
+	uint8_t Bytes[64];
+	uint32_t Index;
+	uint32_t Count;
+	int32_t Column;
+	int32_t Row;
+	int32_t PanelX;
+	int32_t PanelY;
+
+	if(!destination || x < 0 || page < 0 || x >= (int32_t)CompositeDisplay.Width || (page * 8) >= (int32_t)CompositeDisplay.Height) {
+		return 0;
+	}
+
+	if(length > (CompositeDisplay.Width - x)) {
+		length = CompositeDisplay.Width - x;
+		Rect.XEnd = x + length;
+	}
+
+	memset(destination, 0, length);
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		State = &Panels[Index];
+		Footprint.X = State->Panel.X;
+		Footprint.Y = State->Panel.Y;
+		Footprint.XEnd = State->Panel.X + State->Width;
+		Footprint.YEnd = State->Panel.Y + State->Height;
+
+		Footprint.X = Footprint.X > Rect.X ? Footprint.X : Rect.X;
+		Footprint.XEnd = Footprint.XEnd < Rect.XEnd ? Footprint.XEnd : Rect.XEnd;
+
+		if(Footprint.X >= Footprint.XEnd || Footprint.Y >= Rect.YEnd || Footprint.YEnd <= Rect.Y) {
+			continue;
+		}
+
+		if(State->Panel.Orientation == Composite_Rotate0 && State->Panel.Display->ReadPage && !(State->Panel.Y & 7)) {
+			for(Column = Footprint.X; Column < Footprint.XEnd; Column += Count) {
+				Count = State->Panel.Display->ReadPage(Column - State->Panel.X, page - (State->Panel.Y / 8), &Bytes[0],
+						(Footprint.XEnd - Column) < (int32_t)sizeof(Bytes) ? (uint32_t)(Footprint.XEnd - Column) : sizeof(Bytes));
+
+				if(!Count) {
+					break;
+				}
+
+				memcpy(&destination[Column - x], &Bytes[0], Count);
+			}
+			continue;
+		}
+
+		if(!State->Panel.Display->GetPixel) {
+			continue;
+		}
+
+		for(Column = Footprint.X; Column < Footprint.XEnd; Column++) {
+			for(Row = Rect.Y; Row < Rect.YEnd; Row++) {
+				if(Row < Footprint.Y || Row >= Footprint.YEnd) {
+					continue;
+				}
+
+				toPanel(State, Column, Row, &PanelX, &PanelY);
+
+				if(State->Panel.Display->GetPixel(PanelX, PanelY)) {
+					destination[Column - x] |= 1 << (Row - Rect.Y);
+				}
+			}
+		}
+	}
+
+	return length;
+}
+
+static void Fill(uint8_t value) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(Panels[Index].Panel.Display->Fill) {
+			Panels[Index].Panel.Display->Fill(value);
+		} else {
+			compositeRectType All = {X: Panels[Index].Panel.X, Y: Panels[Index].Panel.Y, XEnd: Panels[Index].Panel.X + Panels[Index].Width, YEnd: Panels[Index].Panel.Y + Panels[Index].Height};
+
+			FillRect(All.X, All.Y, All.XEnd - All.X, All.YEnd - All.Y, value);
+		}
+	}
+
+	markAllDirty();
+}
+
+static void Clear(void) {
+	Fill(0);
+}
+
+/**
+ * copies a complete canvas into the panels. The source uses the canvas page layout
+ */
+static void DirectWriteToBuffer(uint8_t * source) {
+	uint32_t Page;
+
+	if(!source) {
+		return;
+	}
+
+	for(Page = 0; Page < (CompositeDisplay.Height + 7) / 8; Page++) {
+		BlitPage(0, Page, &source[Page * CompositeDisplay.Width], CompositeDisplay.Width, 0xFF, Raster_Copy);
+	}
+}
+
+static uint32_t GetDisplayBuffer(uint8_t * destinationPointer) {
+	uint32_t Page;
+
+	if(!destinationPointer) {
+		return 0;
+	}
+
+	for(Page = 0; Page < (CompositeDisplay.Height + 7) / 8; Page++) {
+		ReadPage(0, Page, &destinationPointer[Page * CompositeDisplay.Width], CompositeDisplay.Width);
+	}
+
+	return CompositeDisplay.Width * ((CompositeDisplay.Height + 7) / 8);
+}
+
+static void SetBrightness(uint8_t value) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(Panels[Index].Panel.Display->setBrightness) {
+			Panels[Index].Panel.Display->setBrightness(value);
+		}
+	}
+}
+
+static uint_fast8_t IsDirty(void) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(!rectIsEmpty(&Panels[Index].Dirty)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * sends what a panel has marked for this flush
+ */
+static void sendPanel(compositePanelStateType * state) {
+	DisplayInterfaceType * Display = state->Panel.Display;
+
+	if(Display->SyncRegion) {
+		Display->SyncRegion(state->Send.X, state->Send.Y, state->Send.XEnd - state->Send.X, state->Send.YEnd - state->Send.Y);
+	} else if(Display->Sync) {
+		Display->Sync();
+	}
+}
+
+/**
+ * sends every marked panel on a bus, one after another
+ */
+static void sendBus(uint_fast8_t bus) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(Panels[Index].Panel.Bus == bus && !rectIsEmpty(&Panels[Index].Send)) {
+			sendPanel(&Panels[Index]);
+		}
+	}
+}
+
+#if COMPOSITE_DISPLAY_THREADS
+/**
+ * sends a worker's bus
+ */
+static void sendWorkerBus(uint32_t worker) {
+	sendBus(Buses[worker]);
+}
+
+/**
+ * starts a worker for every bus but the first. If a thread can't be started, its bus and the ones
+ * after it are sent from the syncing thread
+ */
+static void startWorkers(void) {
+	uint32_t Workers = BusCount ? BusCount - 1 : 0;
+
+	if(Workers > WORKER_POOL_MAX_WORKERS) {
+		Workers = WORKER_POOL_MAX_WORKERS;
+	}
+
+	WorkerPoolStart(&Pool, Workers);
+}
+#endif
+
+/**
+ * sends the drawn on parts of the panels that are inside a canvas rectangle
+ */
+static void flush(const compositeRectType * rect) {
+	compositeRectType PanelRect;
+	compositePanelStateType * State;
+	uint8_t Busy[COMPOSITE_DISPLAY_MAX_PANELS];
+	uint32_t BusyCount = 0;
+	uint32_t Index;
+	uint32_t Bus;
+
+	memset(&Busy[0], 0, sizeof(Busy));
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		State = &Panels[Index];
+		memset(&State->Send, 0, sizeof(State->Send));
+
+		if(rectIsEmpty(&State->Dirty) || !toPanelRect(State, rect, &PanelRect)) {
+			continue;
+		}
+
+		State->Send = State->Dirty;
+		rectIntersect(&State->Send, &PanelRect);
+
+		if(rectIsEmpty(&State->Send)) {
+			continue;
+		}
+
+		if(!memcmp(&State->Send, &State->Dirty, sizeof(State->Send))) {
+			memset(&State->Dirty, 0, sizeof(State->Dirty));
+		}
+
+		if(!Busy[State->BusIndex]) {
+			Busy[State->BusIndex] = 1;
+			BusyCount++;
+		}
+	}
+
+#if COMPOSITE_DISPLAY_THREADS
+	// a single bus isn't worth waking the workers for
+	if(BusyCount > 1 && Pool.Count) {
+		WorkerPoolWake(&Pool);
+
+		sendBus(Buses[0]);
+
+		for(Bus = Pool.Count + 1; Bus < BusCount; Bus++) {
+			sendBus(Buses[Bus]);
+		}
+
+		WorkerPoolWait(&Pool);
+
+		return;
+	}
+#endif
+
+	for(Bus = 0; Bus < BusCount; Bus++) {
+		if(Busy[Bus]) {
+			sendBus(Buses[Bus]);
+		}
+	}
+}
+
+static void Sync(void) {
+	compositeRectType All = {X: 0, Y: 0, XEnd: CompositeDisplay.Width, YEnd: CompositeDisplay.Height};
+
+	flush(&All);
+}
+
+static void SyncRegion(int32_t x, int32_t y, int32_t width, int32_t height) {
+	compositeRectType Rect = {X: x, Y: y, XEnd: x + width, YEnd: y + height};
+
+	flush(&Rect);
+}
+
+/**
+ * resets every panel. Each panel sends its whole buffer as part of this
+ */
+static void Reset(uint_fast8_t resetBuffer) {
+	uint32_t Index;
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(Panels[Index].Panel.Display->Reset) {
+			Panels[Index].Panel.Display->Reset(resetBuffer);
+		}
+
+		memset(&Panels[Index].Dirty, 0, sizeof(Panels[Index].Dirty));
+	}
+}
+
+/**
+ * closes every panel and stops the bus workers. Sync still works afterwards, one bus at a time
+ */
+static void Close(uint_fast8_t cleanScreenFlag) {
+	uint32_t Index;
+
+#if COMPOSITE_DISPLAY_THREADS
+	WorkerPoolStop(&Pool);
+#endif
+
+	for(Index = 0; Index < PanelCount; Index++) {
+		if(Panels[Index].Panel.Display->Close) {
+			Panels[Index].Panel.Display->Close(cleanScreenFlag);
+		}
+
+		memset(&Panels[Index].Dirty, 0, sizeof(Panels[Index].Dirty));
+	}
+}
+
+int32_t CompositeDisplaySetup(const CompositePanelType * panels, uint32_t count) {
+	compositePanelStateType * State;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t Index;
+	uint32_t Other;
+
+	if(!panels || !count || count > COMPOSITE_DISPLAY_MAX_PANELS) {
+		return -EINVAL;
+	}
+
+#if COMPOSITE_DISPLAY_THREADS
+	// the workers send from the panel table, so they stop before it changes
+	WorkerPoolStop(&Pool);
+#endif
+
+	PanelCount = 0;
+	BusCount = 0;
+
+	for(Index = 0; Index < count; Index++) {
+		State = &Panels[Index];
+		memset(State, 0, sizeof(compositePanelStateType));
+		State->Panel = panels[Index];
+
+		if(!State->Panel.Display || !State->Panel.Display->SetPixel || State->Panel.X < 0 || State->Panel.Y < 0 ||
+				State->Panel.Orientation > Composite_Rotate270 || !State->Panel.Display->Width || !State->Panel.Display->Height) {
+			PanelCount = 0;
+			return -EINVAL;
+		}
+
+		if(State->Panel.Orientation & 0x01) {
+			State->Width = State->Panel.Display->Height;
+			State->Height = State->Panel.Display->Width;
+		} else {
+			State->Width = State->Panel.Display->Width;
+			State->Height = State->Panel.Display->Height;
+		}
+
+		for(Other = 0; Other < Index; Other++) {
+			if(State->Panel.X < (Panels[Other].Panel.X + Panels[Other].Width) && Panels[Other].Panel.X < (State->Panel.X + State->Width) &&
+					State->Panel.Y < (Panels[Other].Panel.Y + Panels[Other].Height) && Panels[Other].Panel.Y < (State->Panel.Y + State->Height)) {
+				PanelCount = 0;
+				return -EINVAL;
+			}
+		}
+
+		for(Other = 0; Other < BusCount && Buses[Other] != State->Panel.Bus; Other++);
+
+		if(Other == BusCount) {
+			Buses[BusCount++] = State->Panel.Bus;
+		}
+
+		State->BusIndex = Other;
+
+		if((uint32_t)(State->Panel.X + State->Width) > Width) {
+			Width = State->Panel.X + State->Width;
+		}
+		if((uint32_t)(State->Panel.Y + State->Height) > Height) {
+			Height = State->Panel.Y + State->Height;
+		}
+	}
+
+	PanelCount = count;
+
+	CompositeDisplay.Width = Width;
+	CompositeDisplay.Height = Height;
+
+#if COMPOSITE_DISPLAY_THREADS
+	startWorkers();
+#endif
+
+	return 0;
+}
+
+/**
+ * This is our composite display instance
+ */
+struct DisplayInterfaceType CompositeDisplay = {
+	Width: 0,
+	Height: 0,
+	Open: NULL,
+	Reset: Reset,
+	Close: Close,
+	Sync: Sync,
+	SetPixel: SetPixel,
+	directWriteToBuffer: DirectWriteToBuffer,
+	Clear: Clear,
+	Fill: Fill,
+	GetDisplayBuffer: GetDisplayBuffer,
+	setBrightness: SetBrightness,
+	IsDirty: IsDirty,
+	FillRect: FillRect,
+	BlitPage: BlitPage,
+	SyncRegion: SyncRegion,
+	GetPixel: GetPixel,
+	ReadPage: ReadPage
+};
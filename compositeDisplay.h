@@ -0,0 +1,69 @@
+/*
+ * compositeDisplay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __COMPOSITE_DISPLAY_H__
+#define __COMPOSITE_DISPLAY_H__
+
+	#include "displayDriver.h"
+
+	/**
+	 * the most panels one canvas can be made of
+	 */
+	#ifndef COMPOSITE_DISPLAY_MAX_PANELS
+		#define COMPOSITE_DISPLAY_MAX_PANELS 8
+	#endif
+
+	/**
+	 * set to 0 to always send the panels one after another, e.g. where there are no threads
+	 */
+	#ifndef COMPOSITE_DISPLAY_THREADS
+		#define COMPOSITE_DISPLAY_THREADS 1
+	#endif
+
+	/**
+	 * defines how a panel is turned on the canvas, clockwise
+	 */
+	typedef enum {
+		Composite_Rotate0 = 0,
+		Composite_Rotate90,
+		Composite_Rotate180,
+		Composite_Rotate270
+	} CompositeOrientationType;
+
+	/**
+	 * defines where a panel sits on the canvas
+	 */
+	typedef struct CompositePanelType {
+		DisplayInterfaceType * Display;	///< the panel's driver, already opened
+		int32_t X;						///< canvas position of the panel's top left corner, after turning it
+		int32_t Y;
+		uint8_t Orientation;			///< CompositeOrientationType
+		uint8_t Bus;					///< panels with different bus numbers are sent at the same time
+	} CompositePanelType;
+
+	/**
+	 * Sets up the canvas. It is as big as the area the panels cover, and the parts no panel covers
+	 * are dropped when drawn to and read back as 0. Panels must not overlap.
+	 *
+	 * Turning panels in their own driver, such as with SSD1306SetOrientation, is faster than
+	 * turning them here. Panels that are turned here, or whose Y isn't a multiple of 8, have page
+	 * writes broken up into pixels or split pages. Raster_Xor page writes are skipped on panels
+	 * that are turned here or have no BlitPage, unless their driver has GetPixel.
+	 *
+	 * A thread is started for every bus after the first, and waits between syncs. Setting up
+	 * again or closing the display stops them.
+	 *
+	 * @param panels the panels. They are copied
+	 * @param count number of panels
+	 *
+	 * @return 0 on success or -EINVAL
+	 */
+	int32_t CompositeDisplaySetup(const CompositePanelType * panels, uint32_t count);
+
+	extern struct DisplayInterfaceType CompositeDisplay;
+
+#endif /* __COMPOSITE_DISPLAY_H__ */
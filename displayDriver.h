@@ -20,6 +20,16 @@
 		void (*Read) (uint8_t * destination, uint32_t length);
 	} GenericComInterface;
 
+	/**
+	 * defines how a source byte is combined with the display buffer
+	 */
+	typedef enum {
+		Raster_Copy = 0,	///< replace with the source
+		Raster_Or,			///< set the bits that are set in the source
+		Raster_AndNot,		///< clear the bits that are set in the source
+		Raster_Xor			///< invert the bits that are set in the source
+	} DisplayRasterOpType;
+
 	/**
 	 * defines an interface layer for displays
 	 */
@@ -37,6 +47,22 @@
 		/** This is used for debug only **/
 		uint32_t (*GetDisplayBuffer)(uint8_t *destinationPointer);
 		void (*setBrightness)(uint8_t value);
+		/** returns true if the buffer has changed since the last Sync **/
+		uint_fast8_t (*IsDirty)(void);
+		/** sets or clears a rectangle. Parts outside of the display are clipped **/
+		void (*FillRect)(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value);
+		/** combines a run of page bytes (8 vertical pixels each) into the buffer. Only the bits in mask change **/
+		void (*BlitPage)(int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation);
+		/** sends only the part of the buffer that covers the rectangle **/
+		void (*SyncRegion)(int32_t x, int32_t y, int32_t width, int32_t height);
+		/** returns a pixel from the buffer. Pixels outside of the display are 0 **/
+		uint_fast8_t (*GetPixel)(uint32_t x, uint32_t y);
+		/** copies a run of page bytes out of the buffer. Returns how many were copied, fewer than length at the right edge **/
+		uint32_t (*ReadPage)(int32_t x, int32_t page, uint8_t * destination, uint32_t length);
+		/** starts a sync that SyncStep sends a piece at a time. Nothing is pending if the buffer hasn't changed since the last sync **/
+		void (*SyncBegin)(void);
+		/** sends about budget bytes of the pending sync, commands included, carrying on where the last call stopped. Returns true while more is left **/
+		uint_fast8_t (*SyncStep)(uint32_t budget);
 	} DisplayInterfaceType;
 
 
@@ -0,0 +1,267 @@
+/*
+ * fontFile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Loads font files (see fontFileFormat.h) so that fonts can be changed without rebuilding.
+ *
+ * The file is mapped read only and checked once. The GFXfont then points straight at the glyph
+ * table and bitmaps in the mapping, so nothing is parsed or copied while drawing and processes
+ * that use the same file share the page cache pages. Reload swaps the file behind a GFXfont that
+ * is already in use.
+ */
+#include <errno.h>
+#include <string.h>
+#include "fontFile.h"
+#include "glyphCache.h"
+#include "basicGraphics.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#define FONT_FILE_MMAP
+#endif
+
+/**
+ * reads a little endian value
+ */
+static uint32_t getLittleEndian(const uint8_t * source, uint_fast8_t size) {
+	uint32_t Value = 0;
+
+	while(size--) {
+		Value = (Value << 8) | source[size];
+	}
+
+	return Value;
+}
+
+/**
+ * @return true if a glyph in the file can be used as a GFXglyph on this machine
+ */
+static uint_fast8_t glyphLayoutMatches(void) {
+	static const uint8_t Sample[FONT_FILE_GLYPH_SIZE] = {0x34, 0x12, 1, 2, 3, 0xFC, 0xFB, 0};
+	GFXglyph Glyph;
+
+	if(sizeof(GFXglyph) != FONT_FILE_GLYPH_SIZE) {
+		return 0;
+	}
+
+	memcpy(&Glyph, &Sample[0], sizeof(Glyph));
+
+	return Glyph.bitmapOffset == 0x1234 && Glyph.width == 1 && Glyph.height == 2 && Glyph.xAdvance == 3 &&
+			Glyph.xOffset == -4 && Glyph.yOffset == -5;
+}
+
+/**
+ * checks a whole font file and fills in a GFXfont that points into it
+ */
+static int32_t check(const uint8_t * data, uint32_t size, GFXfont * font) {
+	uint32_t HeaderSize;
+	uint32_t GlyphOffset;
+	uint32_t GlyphCount;
+	uint32_t BitmapOffset;
+	uint32_t BitmapSize;
+	const GFXglyph * Glyphs;
+	uint32_t Index;
+
+	if(!data || !font) {
+		return -EINVAL;
+	}
+
+	if(size < FONT_FILE_HEADER_SIZE || memcmp(data, FONT_FILE_MAGIC, 4) ||
+			getLittleEndian(&data[4], 2) != FONT_FILE_VERSION) {
+		return -EINVAL;
+	}
+
+	if(!glyphLayoutMatches()) {
+		return -ENOTSUP;
+	}
+
+	HeaderSize = getLittleEndian(&data[6], 2);
+	GlyphOffset = getLittleEndian(&data[16], 4);
+	GlyphCount = getLittleEndian(&data[20], 4);
+	BitmapOffset = getLittleEndian(&data[24], 4);
+	BitmapSize = getLittleEndian(&data[28], 4);
+
+	if(HeaderSize < FONT_FILE_HEADER_SIZE || getLittleEndian(&data[12], 2) != FONT_FILE_GLYPH_SIZE || data[8] > data[9] ||
+			GlyphCount != (uint32_t)(data[9] - data[8]) + 1 || GlyphOffset < HeaderSize || GlyphOffset > size ||
+			GlyphCount * FONT_FILE_GLYPH_SIZE > size - GlyphOffset || BitmapOffset > size || BitmapSize > size - BitmapOffset) {
+		return -EINVAL;
+	}
+
+	// the table is used in place, so it has to be aligned in memory and not just in the file
+	if((GlyphOffset % FONT_FILE_ALIGNMENT) || ((uintptr_t)&data[GlyphOffset] % FONT_FILE_ALIGNMENT)) {
+		return -EINVAL;
+	}
+
+	Glyphs = (const GFXglyph *)&data[GlyphOffset];
+
+	for(Index = 0; Index < GlyphCount; Index++) {
+		if(Glyphs[Index].bitmapOffset + (((uint32_t)Glyphs[Index].width * Glyphs[Index].height) + 7) / 8 > BitmapSize) {
+			return -EINVAL;
+		}
+	}
+
+	font->bitmap = (uint8_t *)&data[BitmapOffset];
+	font->glyph = (GFXglyph *)Glyphs;
+	font->first = data[8];
+	font->last = data[9];
+	font->yAdvance = data[10];
+	font->maxHeight = data[11];
+
+	return 0;
+}
+
+/**
+ * maps a whole file read only
+ */
+static int32_t mapFile(const char * path, const uint8_t ** data, uint32_t * size) {
+#if defined(FONT_FILE_MMAP)
+	struct stat Status;
+	void * Mapping;
+	int File;
+
+	if(!path) {
+		return -EINVAL;
+	}
+
+	File = open(path, O_RDONLY);
+	if(File < 0) {
+		return -errno;
+	}
+
+	if(fstat(File, &Status) || Status.st_size <= 0 || (uint64_t)Status.st_size > UINT32_MAX) {
+		close(File);
+		return -EINVAL;
+	}
+
+	Mapping = mmap(NULL, Status.st_size, PROT_READ, MAP_SHARED, File, 0);
+	close(File);
+
+	if(Mapping == MAP_FAILED) {
+		return -errno;
+	}
+
+	*data = (const uint8_t *)Mapping;
+	*size = (uint32_t)Status.st_size;
+
+	return 0;
+#else
+	(void)path;
+	(void)data;
+	(void)size;
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * unmaps a file we mapped
+ */
+static void unmapFile(const FontFileType * font) {
+#if defined(FONT_FILE_MMAP)
+	if(font->Mapped && font->Data) {
+		munmap((void *)font->Data, font->Size);
+	}
+#else
+	(void)font;
+#endif
+}
+
+static int32_t OpenMemory(FontFileType * font, const uint8_t * data, uint32_t size) {
+	int32_t Result;
+
+	if(!font) {
+		return -EINVAL;
+	}
+
+	memset(font, 0, sizeof(FontFileType));
+
+	Result = check(data, size, &font->Font);
+
+	if(Result) {
+		memset(&font->Font, 0, sizeof(font->Font));
+		return Result;
+	}
+
+	font->Data = data;
+	font->Size = size;
+
+	return 0;
+}
+
+static int32_t Open(FontFileType * font, const char * path) {
+	const uint8_t * Data = NULL;
+	uint32_t Size = 0;
+	int32_t Result;
+
+	if(!font) {
+		return -EINVAL;
+	}
+
+	memset(font, 0, sizeof(FontFileType));
+
+	Result = mapFile(path, &Data, &Size);
+	if(Result) {
+		return Result;
+	}
+
+	Result = check(Data, Size, &font->Font);
+
+	font->Data = Data;
+	font->Size = Size;
+	font->Mapped = 1;
+
+	if(Result) {
+		unmapFile(font);
+		memset(font, 0, sizeof(FontFileType));
+		return Result;
+	}
+
+	return 0;
+}
+
+static void Close(FontFileType * font) {
+	if(!font || !font->Data) {
+		return;
+	}
+
+	// the cache is keyed on glyph addresses, which a later mapping can reuse, and the digit sets
+	// point at glyphs in this one
+	GlyphCache.Clear();
+	GraphicsInstance.ForgetFont(&font->Font);
+
+	unmapFile(font);
+	memset(font, 0, sizeof(FontFileType));
+}
+
+static int32_t Reload(FontFileType * font, const char * path) {
+	FontFileType Loaded;
+	int32_t Result;
+
+	if(!font) {
+		return -EINVAL;
+	}
+
+	Result = Open(&Loaded, path);
+	if(Result) {
+		return Result;
+	}
+
+	Close(font);
+	*font = Loaded;
+
+	return 0;
+}
+
+/**
+ * This is our font file instance
+ */
+FontFileInterfaceType FontFile = {
+	Open: Open,
+	OpenMemory: OpenMemory,
+	Reload: Reload,
+	Close: Close
+};
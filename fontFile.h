@@ -0,0 +1,43 @@
+/*
+ * fontFile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __FONT_FILE_H__
+#define __FONT_FILE_H__
+
+	#include "Fonts/gfxfont.h"
+	#include "fontFileFormat.h"
+
+	/**
+	 * defines a font loaded from a font file
+	 */
+	typedef struct FontFileType {
+		GFXfont Font;				///< pass &Font to GraphicsInstance. It points into the file
+		const uint8_t * Data;		///< the file in memory, NULL when nothing is loaded
+		uint32_t Size;
+		uint8_t Mapped;				///< true when Data is our own mapping
+	} FontFileType;
+
+	/**
+	 * defines the font file interface
+	 *
+	 * A file is checked once when it is loaded, after that the glyph table and bitmaps are used
+	 * straight from the mapping. Processes that load the same file share its pages.
+	 */
+	typedef struct FontFileInterfaceType {
+		/** maps a font file read only and checks it. Returns 0 or a negative errno **/
+		int32_t (*Open)(FontFileType * font, const char * path);
+		/** uses a font file that is already in memory, e.g. in flash. Returns 0 or a negative errno **/
+		int32_t (*OpenMemory)(FontFileType * font, const uint8_t * data, uint32_t size);
+		/** swaps in another file. &font->Font stays the same, so anything drawing with it picks up the new font. On error the old font is kept **/
+		int32_t (*Reload)(FontFileType * font, const char * path);
+		/** unloads the font and clears the glyph cache and its digit set. Stop drawing with it first **/
+		void (*Close)(FontFileType * font);
+	} FontFileInterfaceType;
+
+	extern FontFileInterfaceType FontFile;
+
+#endif /* __FONT_FILE_H__ */
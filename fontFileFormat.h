@@ -0,0 +1,49 @@
+/*
+ * fontFileFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Describes the font file loaded by fontFile.c and written by Tools/fontFileBuilder.c. It holds
+ *  one GFXfont.
+ *
+ *  All values are little endian. The file starts with a header, followed by the glyph table and
+ *  the glyph bitmaps at the given offsets.
+ *
+ *  header: magic "GFNT" (4), version (2), header size (2), first (1), last (1), y advance (1),
+ *          max height (1), glyph size (2), reserved (2), glyph table offset (4), glyph count (4),
+ *          bitmap offset (4), bitmap size (4)
+ *  glyph: bitmap offset (2), width (1), height (1), x advance (1), x offset (1), y offset (1), reserved (1)
+ *
+ *  A glyph has the same layout as GFXglyph on little endian machines and the glyph table offset is
+ *  a multiple of FONT_FILE_ALIGNMENT, so a mapped table is used as it is. There is one glyph for
+ *  every character from first to last, and the bitmaps are packed as in the compiled in fonts.
+ */
+
+#ifndef __FONT_FILE_FORMAT_H__
+#define __FONT_FILE_FORMAT_H__
+
+	#include <stdint.h>
+
+	/**
+	 * file magic number
+	 */
+	#define FONT_FILE_MAGIC "GFNT"
+
+	/**
+	 * current file version
+	 */
+	#define FONT_FILE_VERSION 1
+
+	/**
+	 * sizes in bytes of the fixed parts of the file
+	 */
+	#define FONT_FILE_HEADER_SIZE 32
+	#define FONT_FILE_GLYPH_SIZE 8
+
+	/**
+	 * the glyph table offset is a multiple of this
+	 */
+	#define FONT_FILE_ALIGNMENT 4
+
+#endif /* __FONT_FILE_FORMAT_H__ */
@@ -0,0 +1,260 @@
+/*
+ * framePacer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Coalesces GraphicsInstance.Flush calls into at most one display transfer per frame period.
+ *
+ * Once started, GraphicsInstance.Flush only marks the frame as pending. The application then
+ * calls FramePacer.WaitForFrame from its loop (or when the timer descriptor becomes readable)
+ * and the pending frame is sent on the next deadline, provided something was actually drawn.
+ */
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include "framePacer.h"
+
+#if defined(__linux__)
+	#include <sys/timerfd.h>
+#endif
+
+/**
+ * the original flush function that does the transfer
+ */
+static void (*DirectFlush)(void);
+
+/**
+ * true when a flush was requested during the current frame
+ */
+static volatile uint_fast8_t FlushPending;
+
+/**
+ * the frame period in nanoseconds
+ */
+static uint64_t PeriodNanoseconds;
+
+/**
+ * the frame timer, -1 when not in use
+ */
+static int TimerDescriptor = -1;
+
+/**
+ * the next absolute deadline, used when there is no timerfd
+ */
+static struct timespec Deadline;
+
+/**
+ * the frame hooks
+ */
+static FramePacerHookType FrameBegin;
+static FramePacerHookType FrameEnd;
+
+/**
+ * the pacer counters
+ */
+static FramePacerStatisticsType Statistics;
+
+/**
+ * this replaces GraphicsInstance.Flush while the pacer is running
+ */
+static void RequestFlush(void) {
+	Statistics.Requests++;
+
+	if(FlushPending) {
+		Statistics.Coalesced++;
+	}
+
+	FlushPending = true;
+}
+
+/**
+ * adds the given nanoseconds to a time value
+ */
+static void AddNanoseconds(struct timespec * time, uint64_t nanoseconds) {
+	nanoseconds += (uint64_t)time->tv_nsec;
+
+	time->tv_sec += nanoseconds / 1000000000u;
+	time->tv_nsec = nanoseconds % 1000000000u;
+}
+
+/**
+ * Stops the pacer and restores the direct flush. A frame still waiting for its tick is sent now
+ */
+static void Stop(void) {
+	if(DirectFlush) {
+		GraphicsInstance.Flush = DirectFlush;
+
+		if(FlushPending) {
+			DirectFlush();
+			Statistics.Transfers++;
+		}
+
+		DirectFlush = NULL;
+	}
+
+	if(TimerDescriptor >= 0) {
+		close(TimerDescriptor);
+		TimerDescriptor = -1;
+	}
+
+	FlushPending = false;
+}
+
+/**
+ * Starts pacing the display at the given frame rate. GraphicsInstance must have been initialised.
+ *
+ * @param framesPerSecond target refresh rate
+ */
+static GraphicsReturnType Start(uint32_t framesPerSecond) {
+
+	if(!framesPerSecond || !GraphicsInstance.Flush) {
+		return BasicGReturned_Error;
+	}
+
+	Stop();
+
+	PeriodNanoseconds = 1000000000u / framesPerSecond;
+
+	clock_gettime(CLOCK_MONOTONIC, &Deadline);
+	AddNanoseconds(&Deadline, PeriodNanoseconds);
+
+#if defined(__linux__)
+	struct itimerspec Timer;
+
+	TimerDescriptor = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if(TimerDescriptor < 0) {
+		return BasicGReturned_Error;
+	}
+
+	Timer.it_interval.tv_sec = PeriodNanoseconds / 1000000000u;
+	Timer.it_interval.tv_nsec = PeriodNanoseconds % 1000000000u;
+	Timer.it_value = Deadline;
+
+	if(timerfd_settime(TimerDescriptor, TFD_TIMER_ABSTIME, &Timer, NULL) < 0) {
+		close(TimerDescriptor);
+		TimerDescriptor = -1;
+		return BasicGReturned_Error;
+	}
+#endif
+
+	memset(&Statistics, 0, sizeof(Statistics));
+
+	DirectFlush = GraphicsInstance.Flush;
+	GraphicsInstance.Flush = RequestFlush;
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * sets the functions called at the start and the end of every frame. Either can be NULL
+ */
+static void SetHooks(FramePacerHookType frameBegin, FramePacerHookType frameEnd) {
+	FrameBegin = frameBegin;
+	FrameEnd = frameEnd;
+}
+
+/**
+ * blocks until the next frame deadline
+ *
+ * @return the number of frame periods that elapsed, at least 1
+ */
+static uint64_t WaitForDeadline(void) {
+	uint64_t Expirations = 1;
+
+#if defined(__linux__)
+	if(TimerDescriptor >= 0) {
+		while(read(TimerDescriptor, &Expirations, sizeof(Expirations)) != sizeof(Expirations)) {
+			if(errno != EINTR && errno != EAGAIN) {
+				return 1;
+			}
+		}
+		return Expirations;
+	}
+#endif
+
+	struct timespec Now;
+
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL) == EINTR) {
+	}
+
+	// work out how many periods we missed and move the deadline on past now
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	AddNanoseconds(&Deadline, PeriodNanoseconds);
+
+	while((Now.tv_sec > Deadline.tv_sec) || (Now.tv_sec == Deadline.tv_sec && Now.tv_nsec >= Deadline.tv_nsec)) {
+		AddNanoseconds(&Deadline, PeriodNanoseconds);
+		Expirations++;
+	}
+
+	return Expirations;
+}
+
+/**
+ * Waits for the next frame deadline and sends the frame if a flush was requested and something was drawn.
+ *
+ * @return true if the frame was sent to the display
+ */
+static uint_fast8_t WaitForFrame(void) {
+	uint_fast8_t Transferred = false;
+	uint64_t Expirations;
+
+	if(!DirectFlush) {
+		return false;
+	}
+
+	Expirations = WaitForDeadline();
+
+	Statistics.MissedDeadlines += (uint32_t)(Expirations - 1);
+	Statistics.Frames += (uint32_t)Expirations;
+
+	if(FrameBegin) {
+		FrameBegin(Statistics.Frames);
+	}
+
+	if(FlushPending) {
+		FlushPending = false;
+
+		if(!GraphicsInstance.IsDirty || GraphicsInstance.IsDirty()) {
+			DirectFlush();
+			Statistics.Transfers++;
+			Transferred = true;
+		} else {
+			Statistics.Skipped++;
+		}
+	}
+
+	if(FrameEnd) {
+		FrameEnd(Statistics.Frames);
+	}
+
+	return Transferred;
+}
+
+/**
+ * @return the frame timer descriptor so the pacer can be used from a poll/epoll loop, or -1 if there isn't one
+ */
+static int GetTimerDescriptor(void) {
+	return TimerDescriptor;
+}
+
+/**
+ * returns a copy of the pacer counters
+ */
+static void GetStatistics(FramePacerStatisticsType * statistics) {
+	if(statistics) {
+		*statistics = Statistics;
+	}
+}
+
+/**
+ * This is our frame pacer instance
+ */
+FramePacerType FramePacer = {
+		Start: Start,
+		Stop: Stop,
+		SetHooks: SetHooks,
+		WaitForFrame: WaitForFrame,
+		GetTimerDescriptor: GetTimerDescriptor,
+		GetStatistics: GetStatistics
+};
@@ -0,0 +1,44 @@
+/*
+ * framePacer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __FRAME_PACER_H__
+#define __FRAME_PACER_H__
+
+	#include "basicGraphics.h"
+
+	/**
+	 * defines the frame hook type. It is given the frame number
+	 */
+	typedef void (*FramePacerHookType)(uint32_t frameNumber);
+
+	/**
+	 * defines the frame pacer counters
+	 */
+	typedef struct FramePacerStatisticsType {
+		uint32_t Frames;			///< number of frame periods that have elapsed
+		uint32_t Requests;			///< number of Flush calls
+		uint32_t Transfers;			///< number of frames sent to the display
+		uint32_t Coalesced;			///< Flush calls that were merged into another transfer
+		uint32_t Skipped;			///< frames with a pending Flush but nothing drawn
+		uint32_t MissedDeadlines;	///< frame periods that passed without being serviced
+	} FramePacerStatisticsType;
+
+	/**
+	 * defines the frame pacer interface
+	 */
+	typedef struct FramePacerType {
+		GraphicsReturnType (*Start)(uint32_t framesPerSecond);
+		void (*Stop)(void);
+		void (*SetHooks)(FramePacerHookType frameBegin, FramePacerHookType frameEnd);
+		uint_fast8_t (*WaitForFrame)(void);
+		int (*GetTimerDescriptor)(void);
+		void (*GetStatistics)(FramePacerStatisticsType * statistics);
+	} FramePacerType;
+
+	extern FramePacerType FramePacer;
+
+#endif /* __FRAME_PACER_H__ */
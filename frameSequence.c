@@ -0,0 +1,431 @@
+/*
+ * frameSequence.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Plays frame sequence files (see frameSequenceFormat.h) straight from a memory mapping.
+ *
+ * The whole file is checked once when it is opened so nothing is parsed while playing. Full
+ * frames go to the driver with directWriteToBuffer when the geometry matches, and delta frames
+ * only write and send the windows that changed, using BlitPage and SyncRegion. Frame data is
+ * never copied anywhere other than into the driver's buffer, so memory use doesn't depend on the
+ * length of the sequence.
+ */
+#include <time.h>
+#include <errno.h>
+#include "frameSequence.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#define FRAME_SEQUENCE_MMAP
+#endif
+
+/**
+ * the sequence in memory
+ */
+static const uint8_t * Data;
+static uint32_t DataSize;
+
+/**
+ * true when Data is our own mapping
+ */
+static uint_fast8_t Mapped;
+
+/**
+ * the sequence geometry
+ */
+static uint32_t Width;
+static uint32_t Height;
+static uint32_t Pages;
+static uint32_t Frames;
+static const uint8_t * FrameTable;
+
+/**
+ * true when some frames are delta encoded
+ */
+static uint_fast8_t HasDelta;
+
+/**
+ * the playback state
+ */
+static DisplayInterfaceType * Display;
+static uint32_t NextFrame;
+static uint32_t LoopsLeft;
+static uint_fast8_t Forever;
+static uint_fast8_t Playing;
+static struct timespec Deadline;
+
+/**
+ * reads a little endian value
+ */
+static uint32_t getLittleEndian(const uint8_t * source, uint_fast8_t size) {
+	uint32_t Value = 0;
+
+	while(size--) {
+		Value = (Value << 8) | source[size];
+	}
+
+	return Value;
+}
+
+/**
+ * @return microseconds from now until the given time, negative if it has passed
+ */
+static int64_t microsecondsUntil(const struct timespec * time) {
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((int64_t)(time->tv_sec - Now.tv_sec) * 1000000) + ((time->tv_nsec - Now.tv_nsec) / 1000);
+}
+
+/**
+ * checks that a delta frame's windows are inside the frame and fill its data exactly
+ */
+static uint_fast8_t checkDelta(const uint8_t * frame, uint32_t length) {
+	const uint8_t * End = frame + length;
+	uint32_t Windows;
+	uint32_t Column;
+	uint32_t Columns;
+	uint32_t Page;
+	uint32_t PageCount;
+
+	if(length < FRAME_SEQUENCE_DELTA_HEADER_SIZE) {
+		return 0;
+	}
+
+	Windows = getLittleEndian(frame, 2);
+	frame += FRAME_SEQUENCE_DELTA_HEADER_SIZE;
+
+	while(Windows--) {
+		if((uint32_t)(End - frame) < FRAME_SEQUENCE_WINDOW_HEADER_SIZE) {
+			return 0;
+		}
+
+		Column = getLittleEndian(&frame[0], 2);
+		Columns = getLittleEndian(&frame[2], 2);
+		Page = frame[4];
+		PageCount = frame[5];
+		frame += FRAME_SEQUENCE_WINDOW_HEADER_SIZE;
+
+		if(!Columns || !PageCount || Column + Columns > Width || Page + PageCount > Pages ||
+				(uint32_t)(End - frame) < Columns * PageCount) {
+			return 0;
+		}
+
+		frame += Columns * PageCount;
+	}
+
+	return frame == End;
+}
+
+/**
+ * unmaps the sequence if we mapped it
+ */
+static void Close(void) {
+#if defined(FRAME_SEQUENCE_MMAP)
+	if(Mapped && Data) {
+		munmap((void *)Data, DataSize);
+	}
+#endif
+
+	Data = NULL;
+	DataSize = 0;
+	Mapped = 0;
+	Playing = 0;
+}
+
+/**
+ * checks the whole sequence
+ */
+static int32_t OpenMemory(const uint8_t * data, uint32_t size) {
+	uint32_t HeaderSize;
+	uint32_t TableOffset;
+	uint32_t Index;
+	const uint8_t * Entry;
+	uint32_t Offset;
+	uint32_t Length;
+
+	if(!data) {
+		return -EINVAL;
+	}
+
+	Close();
+
+	if(size < FRAME_SEQUENCE_HEADER_SIZE || memcmp(data, FRAME_SEQUENCE_MAGIC, 4) ||
+			getLittleEndian(&data[4], 2) != FRAME_SEQUENCE_VERSION) {
+		return -EINVAL;
+	}
+
+	HeaderSize = getLittleEndian(&data[6], 2);
+	Width = getLittleEndian(&data[8], 2);
+	Height = getLittleEndian(&data[10], 2);
+	Pages = (Height + 7) / 8;
+	Frames = getLittleEndian(&data[16], 4);
+	TableOffset = getLittleEndian(&data[20], 4);
+
+	if(HeaderSize < FRAME_SEQUENCE_HEADER_SIZE || data[12] != FrameSequence_PageMonochrome || !Width || !Height || !Frames ||
+			TableOffset > size || (uint64_t)Frames * FRAME_SEQUENCE_ENTRY_SIZE > size - TableOffset) {
+		return -EINVAL;
+	}
+
+	FrameTable = &data[TableOffset];
+	HasDelta = 0;
+
+	for(Index = 0; Index < Frames; Index++) {
+		Entry = &FrameTable[Index * FRAME_SEQUENCE_ENTRY_SIZE];
+		Offset = getLittleEndian(&Entry[0], 4);
+		Length = getLittleEndian(&Entry[4], 4);
+
+		if(Offset > size || Length > size - Offset) {
+			return -EINVAL;
+		}
+
+		switch(Entry[10]) {
+			case FrameSequence_Full:
+				if(Length != Width * Pages) {
+					return -EINVAL;
+				}
+			break;
+
+			case FrameSequence_Delta:
+				// the first frame has to stand on its own so that the sequence can loop
+				if(!Index || !checkDelta(&data[Offset], Length)) {
+					return -EINVAL;
+				}
+				HasDelta = 1;
+			break;
+
+			default:
+				return -EINVAL;
+		}
+	}
+
+	Data = data;
+	DataSize = size;
+	Playing = 0;
+
+	return 0;
+}
+
+/**
+ * maps a frame sequence file read only
+ */
+static int32_t Open(const char * path) {
+#if defined(FRAME_SEQUENCE_MMAP)
+	struct stat Status;
+	void * Mapping;
+	int32_t Result;
+	int File;
+
+	Close();
+
+	File = open(path, O_RDONLY);
+	if(File < 0) {
+		return -errno;
+	}
+
+	if(fstat(File, &Status) || Status.st_size <= 0 || (uint64_t)Status.st_size > UINT32_MAX) {
+		close(File);
+		return -EINVAL;
+	}
+
+	Mapping = mmap(NULL, Status.st_size, PROT_READ, MAP_SHARED, File, 0);
+	close(File);
+
+	if(Mapping == MAP_FAILED) {
+		return -errno;
+	}
+
+	madvise(Mapping, Status.st_size, MADV_SEQUENTIAL);
+
+	Result = OpenMemory((const uint8_t *)Mapping, (uint32_t)Status.st_size);
+
+	if(Result) {
+		munmap(Mapping, Status.st_size);
+		return Result;
+	}
+
+	Mapped = 1;
+
+	return 0;
+#else
+	(void)path;
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * starts playing from the first frame
+ */
+static int32_t Start(DisplayInterfaceType * display, uint32_t loops) {
+	if(!Data || !display || !display->Sync) {
+		return -EINVAL;
+	}
+
+	// deltas and frames that don't match the panel need BlitPage
+	if(!display->BlitPage && (HasDelta || !display->directWriteToBuffer || display->Width != Width || display->Height != Height)) {
+		return -EINVAL;
+	}
+
+	Display = display;
+	NextFrame = 0;
+	LoopsLeft = loops;
+	Forever = !loops;
+	Playing = 1;
+
+	clock_gettime(CLOCK_MONOTONIC, &Deadline);
+
+	return 0;
+}
+
+/**
+ * writes a frame into the driver and sends it
+ */
+static void showFrame(const uint8_t * entry) {
+	const uint8_t * Frame = &Data[getLittleEndian(&entry[0], 4)];
+	uint32_t Windows;
+	uint32_t Column;
+	uint32_t Columns;
+	uint32_t Page;
+	uint32_t PageCount;
+	uint32_t Index;
+
+	if(entry[10] == FrameSequence_Full) {
+		if(Display->directWriteToBuffer && Display->Width == Width && Display->Height == Height) {
+			Display->directWriteToBuffer((uint8_t *)Frame);
+		} else {
+			for(Page = 0; Page < Pages; Page++) {
+				Display->BlitPage(0, Page, &Frame[Page * Width], Width, 0xFF, Raster_Copy);
+			}
+		}
+
+		Display->Sync();
+		return;
+	}
+
+	Windows = getLittleEndian(Frame, 2);
+	Frame += FRAME_SEQUENCE_DELTA_HEADER_SIZE;
+
+	for( ; Windows; Windows--) {
+		Column = getLittleEndian(&Frame[0], 2);
+		Columns = getLittleEndian(&Frame[2], 2);
+		Page = Frame[4];
+		PageCount = Frame[5];
+		Frame += FRAME_SEQUENCE_WINDOW_HEADER_SIZE;
+
+		for(Index = 0; Index < PageCount; Index++) {
+			Display->BlitPage(Column, Page + Index, Frame, Columns, 0xFF, Raster_Copy);
+			Frame += Columns;
+		}
+
+		if(Display->SyncRegion) {
+			Display->SyncRegion(Column, Page * 8, Columns, PageCount * 8);
+		}
+	}
+
+	if(!Display->SyncRegion) {
+		Display->Sync();
+	}
+}
+
+/**
+ * shows the next frame once it is due
+ */
+static int32_t Step(void) {
+	const uint8_t * Entry;
+	int64_t Wait;
+	uint32_t Duration;
+
+	if(!Data || !Playing) {
+		return -EINVAL;
+	}
+
+	Wait = microsecondsUntil(&Deadline);
+
+	if(Wait > 0) {
+		return Wait > INT32_MAX ? INT32_MAX : (int32_t)Wait;
+	}
+
+	Entry = &FrameTable[NextFrame * FRAME_SEQUENCE_ENTRY_SIZE];
+	showFrame(Entry);
+
+	// when we are more than a frame late start timing from now rather than rushing to catch up
+	Duration = getLittleEndian(&Entry[8], 2);
+	if(Wait < -((int64_t)Duration * 1000)) {
+		clock_gettime(CLOCK_MONOTONIC, &Deadline);
+	}
+
+	Deadline.tv_sec += Duration / 1000;
+	Deadline.tv_nsec += (Duration % 1000) * 1000000;
+	if(Deadline.tv_nsec >= 1000000000) {
+		Deadline.tv_sec++;
+		Deadline.tv_nsec -= 1000000000;
+	}
+
+	if(++NextFrame >= Frames) {
+		NextFrame = 0;
+
+		if(!Forever && !--LoopsLeft) {
+			Playing = 0;
+			return FRAME_PLAYER_END;
+		}
+	}
+
+	Wait = microsecondsUntil(&Deadline);
+
+	return Wait > 0 ? (int32_t)(Wait > INT32_MAX ? INT32_MAX : Wait) : 0;
+}
+
+/**
+ * plays to the end. The last frame stays up for its duration
+ */
+static int32_t Play(void) {
+	int32_t Wait;
+
+	for(;;) {
+		Wait = Step();
+
+		if(Wait == FRAME_PLAYER_END) {
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL);
+			return 0;
+		}
+
+		if(Wait < 0) {
+			return Wait;
+		}
+
+		if(Wait) {
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL);
+		}
+	}
+}
+
+static void GetInfo(uint32_t * width, uint32_t * height, uint32_t * frames) {
+	if(width) {
+		*width = Data ? Width : 0;
+	}
+	if(height) {
+		*height = Data ? Height : 0;
+	}
+	if(frames) {
+		*frames = Data ? Frames : 0;
+	}
+}
+
+/**
+ * This is our frame player instance
+ */
+FramePlayerType FramePlayer = {
+	Open: Open,
+	OpenMemory: OpenMemory,
+	Close: Close,
+	Start: Start,
+	Step: Step,
+	Play: Play,
+	GetInfo: GetInfo
+};
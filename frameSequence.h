@@ -0,0 +1,39 @@
+/*
+ * frameSequence.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __FRAME_SEQUENCE_H__
+#define __FRAME_SEQUENCE_H__
+
+	#include "basicGraphics.h"
+	#include "frameSequenceFormat.h"
+
+	/**
+	 * returned by Step once the last frame has been shown
+	 */
+	#define FRAME_PLAYER_END (-1)
+
+	/**
+	 * defines the frame player interface
+	 */
+	typedef struct FramePlayerType {
+		/** maps a frame sequence file and checks it. Returns 0 or a negative errno **/
+		int32_t (*Open)(const char * path);
+		/** uses a frame sequence that is already in memory, e.g. in flash. Returns 0 or a negative errno **/
+		int32_t (*OpenMemory)(const uint8_t * data, uint32_t size);
+		void (*Close)(void);
+		/** starts playing on a display. loops is the number of times to play, 0 for ever **/
+		int32_t (*Start)(DisplayInterfaceType * display, uint32_t loops);
+		/** shows the next frame if it is due. Returns the microseconds until the next frame, FRAME_PLAYER_END or -EINVAL if nothing is playing **/
+		int32_t (*Step)(void);
+		/** plays to the end, sleeping between frames **/
+		int32_t (*Play)(void);
+		void (*GetInfo)(uint32_t * width, uint32_t * height, uint32_t * frames);
+	} FramePlayerType;
+
+	extern FramePlayerType FramePlayer;
+
+#endif /* __FRAME_SEQUENCE_H__ */
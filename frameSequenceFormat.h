@@ -0,0 +1,63 @@
+/*
+ * frameSequenceFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ *  Describes the frame sequence file played by frameSequence.c and written by
+ *  Tools/frameSequenceBuilder.c.
+ *
+ *  All values are little endian. The file starts with a header, the frame table is at the
+ *  given offset and each table entry points at its frame data.
+ *
+ *  header: magic "FSEQ" (4), version (2), header size (2), width (2), height (2), format (1),
+ *          flags (1), reserved (2), frame count (4), frame table offset (4)
+ *  frame table entry: data offset (4), data length (4), duration in milliseconds (2), encoding (1), reserved (1)
+ *
+ *  A full frame is width * ((height + 7) / 8) bytes in the display's page layout.
+ *  A delta frame only holds the windows that changed since the previous frame:
+ *      window count (2), reserved (2), then for each window
+ *      first column (2), columns (2), first page (1), pages (1), reserved (2), columns * pages bytes page after page
+ *
+ *  The first frame is always a full frame so that the sequence can loop.
+ */
+
+#ifndef __FRAME_SEQUENCE_FORMAT_H__
+#define __FRAME_SEQUENCE_FORMAT_H__
+
+	#include <stdint.h>
+
+	/**
+	 * file magic number
+	 */
+	#define FRAME_SEQUENCE_MAGIC "FSEQ"
+
+	/**
+	 * current file version
+	 */
+	#define FRAME_SEQUENCE_VERSION 1
+
+	/**
+	 * sizes in bytes of the fixed parts of the file
+	 */
+	#define FRAME_SEQUENCE_HEADER_SIZE 24
+	#define FRAME_SEQUENCE_ENTRY_SIZE 12
+	#define FRAME_SEQUENCE_DELTA_HEADER_SIZE 4
+	#define FRAME_SEQUENCE_WINDOW_HEADER_SIZE 8
+
+	/**
+	 * defines the pixel formats
+	 */
+	typedef enum {
+		FrameSequence_PageMonochrome = 0	///< 1 bit per pixel, 8 vertical pixels per byte
+	} FrameSequenceFormatType;
+
+	/**
+	 * defines how a frame is stored
+	 */
+	typedef enum {
+		FrameSequence_Full = 0,
+		FrameSequence_Delta
+	} FrameSequenceEncodingType;
+
+#endif /* __FRAME_SEQUENCE_FORMAT_H__ */
@@ -0,0 +1,315 @@
+/*
+ * glyphCache.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Keeps recently drawn glyphs decoded and transposed into the panel's page layout, so drawing
+ * them again is a masked byte operation per column instead of a walk of the font bitstream.
+ *
+ * Entries are keyed by the glyph pointer, which identifies both the font and the code point, and
+ * by the glyph's vertical phase (its top row modulo 8). All memory comes from the budget given
+ * to Init and the least recently used entry is reused once it is full.
+ */
+#include <stddef.h>
+#include <string.h>
+#include "glyphCache.h"
+
+/**
+ * marks the end of a list
+ */
+#define GLYPH_CACHE_NONE 0xFFFF
+
+/**
+ * defines a cache slot
+ */
+typedef struct {
+	const GFXglyph * Glyph;			///< the key, NULL when the slot is free
+	uint8_t Phase;					///< the other half of the key
+	uint8_t Pages;					///< pages the glyph covers at this phase
+	uint16_t Previous;				///< more recently used entry
+	uint16_t Next;					///< less recently used entry
+	uint16_t HashNext;				///< next entry in the same bucket
+	uint8_t Data[GLYPH_CACHE_SLOT_SIZE];
+} glyphCacheEntryType;
+
+/**
+ * the slots and hash buckets, both carved out of the caller's memory
+ */
+static glyphCacheEntryType * Entries;
+static uint16_t * Buckets;
+static uint16_t BucketMask;
+
+/**
+ * the least recently used list
+ */
+static uint16_t Newest = GLYPH_CACHE_NONE;
+static uint16_t Oldest = GLYPH_CACHE_NONE;
+
+/**
+ * the cache counters
+ */
+static GlyphCacheStatisticsType Statistics;
+
+/**
+ * works out the bucket of a key
+ */
+static uint_fast16_t getBucket(const GFXglyph * glyph, uint_fast8_t phase) {
+	uintptr_t Key = ((uintptr_t)glyph / sizeof(GFXglyph)) * 8 + phase;
+
+	Key ^= Key >> 11;
+	Key *= 0x9E3B;
+
+	return (Key ^ (Key >> 7)) & BucketMask;
+}
+
+/**
+ * takes an entry out of the least recently used list
+ */
+static void unlinkEntry(uint_fast16_t index) {
+	glyphCacheEntryType * Entry = &Entries[index];
+
+	if(Entry->Previous != GLYPH_CACHE_NONE) {
+		Entries[Entry->Previous].Next = Entry->Next;
+	} else {
+		Newest = Entry->Next;
+	}
+
+	if(Entry->Next != GLYPH_CACHE_NONE) {
+		Entries[Entry->Next].Previous = Entry->Previous;
+	} else {
+		Oldest = Entry->Previous;
+	}
+}
+
+/**
+ * puts an entry at the most recently used end of the list
+ */
+static void pushEntry(uint_fast16_t index) {
+	glyphCacheEntryType * Entry = &Entries[index];
+
+	Entry->Previous = GLYPH_CACHE_NONE;
+	Entry->Next = Newest;
+
+	if(Newest != GLYPH_CACHE_NONE) {
+		Entries[Newest].Previous = index;
+	} else {
+		Oldest = index;
+	}
+
+	Newest = index;
+}
+
+/**
+ * takes an entry out of its hash bucket
+ */
+static void removeFromBucket(uint_fast16_t index) {
+	uint16_t * Link = &Buckets[getBucket(Entries[index].Glyph, Entries[index].Phase)];
+
+	while(*Link != GLYPH_CACHE_NONE) {
+		if(*Link == index) {
+			*Link = Entries[index].HashNext;
+			return;
+		}
+		Link = &Entries[*Link].HashNext;
+	}
+}
+
+/**
+ * drops all entries
+ */
+static void Clear(void) {
+	uint32_t Index;
+
+	Newest = GLYPH_CACHE_NONE;
+	Oldest = GLYPH_CACHE_NONE;
+	Statistics.Entries = 0;
+
+	if(!Entries) {
+		return;
+	}
+
+	for(Index = 0; Index <= BucketMask; Index++) {
+		Buckets[Index] = GLYPH_CACHE_NONE;
+	}
+
+	// free slots are kept at the old end of the list so they are used first
+	for(Index = 0; Index < Statistics.Capacity; Index++) {
+		Entries[Index].Glyph = NULL;
+		pushEntry(Index);
+	}
+}
+
+/**
+ * sets up the cache in the given memory
+ *
+ * @param memory the cache memory, NULL disables the cache
+ * @param size size of memory in bytes
+ * @return number of glyphs the cache can hold
+ */
+static uint32_t Init(void * memory, uint32_t size) {
+	uintptr_t Start = (uintptr_t)memory;
+	uintptr_t Aligned = (Start + sizeof(void *) - 1) & ~(uintptr_t)(sizeof(void *) - 1);
+	uint32_t Capacity = 0;
+	uint32_t BucketCount = 1;
+
+	Entries = NULL;
+	Buckets = NULL;
+	memset(&Statistics, 0, sizeof(Statistics));
+
+	if(memory && size > (Aligned - Start)) {
+		size -= (Aligned - Start);
+		Capacity = size / (sizeof(glyphCacheEntryType) + sizeof(uint16_t));
+	}
+
+	if(Capacity >= GLYPH_CACHE_NONE) {
+		Capacity = GLYPH_CACHE_NONE - 1;
+	}
+
+	if(!Capacity) {
+		Clear();
+		return 0;
+	}
+
+	// roughly one bucket per entry
+	while((BucketCount << 1) <= Capacity) {
+		BucketCount <<= 1;
+	}
+
+	Entries = (glyphCacheEntryType *)Aligned;
+	Buckets = (uint16_t *)&Entries[Capacity];
+	BucketMask = BucketCount - 1;
+	Statistics.Capacity = Capacity;
+
+	Clear();
+
+	return Capacity;
+}
+
+/**
+ * decodes the glyph bitstream into page layout. Row 0 of the glyph lands on bit phase of the first page
+ */
+static void decodeGlyph(const GFXglyph * glyph, const uint8_t * bitmap, uint_fast8_t phase, uint8_t * destination, uint_fast8_t pages) {
+	uint_fast8_t Width = glyph->width;
+	uint32_t SegmentIndex = glyph->bitmapOffset;
+	uint_fast8_t BitIndex = 0;
+	uint8_t Segment = 0;
+	uint_fast8_t YIndex;
+	uint_fast8_t XIndex;
+	uint8_t * Row;
+	uint8_t Bit;
+
+	memset(destination, 0, Width * pages);
+
+	for(YIndex = 0; YIndex < glyph->height; YIndex++) {
+		Row = &destination[((YIndex + phase) >> 3) * Width];
+		Bit = 1 << ((YIndex + phase) & 7);
+
+		for(XIndex = 0; XIndex < Width; XIndex++) {
+
+			if(!(BitIndex++ & 7)) {
+				Segment = bitmap[SegmentIndex++];
+			}
+
+			if(Segment & 0x80) {
+				Row[XIndex] |= Bit;
+			}
+
+			Segment <<= 1;
+		}
+	}
+}
+
+/**
+ * gets a glyph in page layout, decoding it if it is not cached yet
+ *
+ * @param glyph the glyph to get
+ * @param bitmap the font bitmap the glyph belongs to
+ * @param phase the glyph's top row modulo 8
+ * @param pages returns the number of pages covered
+ * @return the page rows, width bytes each, or NULL if the glyph can't be cached
+ */
+static const uint8_t * Get(const GFXglyph * glyph, const uint8_t * bitmap, uint_fast8_t phase, uint_fast8_t * pages) {
+	uint_fast8_t Pages;
+	uint_fast16_t Bucket;
+	uint_fast16_t Index;
+	glyphCacheEntryType * Entry;
+
+	if(!Entries || !glyph || !bitmap || !pages) {
+		return NULL;
+	}
+
+	phase &= 7;
+	Bucket = getBucket(glyph, phase);
+
+	for(Index = Buckets[Bucket]; Index != GLYPH_CACHE_NONE; Index = Entries[Index].HashNext) {
+		Entry = &Entries[Index];
+
+		if(Entry->Glyph == glyph && Entry->Phase == phase) {
+
+			if(Newest != Index) {
+				unlinkEntry(Index);
+				pushEntry(Index);
+			}
+
+			Statistics.Hits++;
+			*pages = Entry->Pages;
+			return &Entry->Data[0];
+		}
+	}
+
+	Pages = (phase + glyph->height + 7) >> 3;
+
+	if(!glyph->width || !glyph->height || (uint32_t)Pages * glyph->width > GLYPH_CACHE_SLOT_SIZE) {
+		Statistics.Bypassed++;
+		return NULL;
+	}
+
+	Statistics.Misses++;
+
+	// reuse the least recently used slot
+	Index = Oldest;
+	Entry = &Entries[Index];
+
+	if(Entry->Glyph) {
+		removeFromBucket(Index);
+		Statistics.Evictions++;
+	} else {
+		Statistics.Entries++;
+	}
+
+	Entry->Glyph = glyph;
+	Entry->Phase = phase;
+	Entry->Pages = Pages;
+	decodeGlyph(glyph, bitmap, phase, &Entry->Data[0], Pages);
+
+	Entry->HashNext = Buckets[Bucket];
+	Buckets[Bucket] = Index;
+
+	unlinkEntry(Index);
+	pushEntry(Index);
+
+	*pages = Pages;
+	return &Entry->Data[0];
+}
+
+/**
+ * gets a copy of the cache counters
+ */
+static void GetStatistics(GlyphCacheStatisticsType * statistics) {
+	if(!statistics) {
+		return;
+	}
+
+	*statistics = Statistics;
+}
+
+/**
+ * This is our glyph cache instance
+ */
+GlyphCacheType GlyphCache = {
+	Init: Init,
+	Clear: Clear,
+	Get: Get,
+	GetStatistics: GetStatistics
+};
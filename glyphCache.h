@@ -0,0 +1,48 @@
+/*
+ * glyphCache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __GLYPH_CACHE_H__
+#define __GLYPH_CACHE_H__
+
+	#include <stdint.h>
+	#include "Fonts/gfxfont.h"
+
+	/**
+	 * the largest decoded glyph we keep, in bytes. Glyphs that need more are drawn from the font bitstream
+	 */
+	#ifndef GLYPH_CACHE_SLOT_SIZE
+		#define GLYPH_CACHE_SLOT_SIZE 64
+	#endif
+
+	/**
+	 * defines the glyph cache counters
+	 */
+	typedef struct GlyphCacheStatisticsType {
+		uint32_t Hits;			///< glyphs found already decoded
+		uint32_t Misses;		///< glyphs that had to be decoded
+		uint32_t Evictions;		///< entries reused for another glyph
+		uint32_t Bypassed;		///< glyphs too large for a slot
+		uint32_t Entries;		///< slots in use
+		uint32_t Capacity;		///< slots that fit in the memory budget
+	} GlyphCacheStatisticsType;
+
+	/**
+	 * defines the glyph cache interface
+	 */
+	typedef struct GlyphCacheType {
+		/** memory is the cache's budget, it is not copied and must outlive the cache. NULL or 0 disables it **/
+		uint32_t (*Init)(void * memory, uint32_t size);
+		/** drops all entries. Call this when a font is unloaded **/
+		void (*Clear)(void);
+		/** returns the glyph in page layout, one row of glyph->width bytes per page, or NULL if not cached **/
+		const uint8_t * (*Get)(const GFXglyph * glyph, const uint8_t * bitmap, uint_fast8_t phase, uint_fast8_t * pages);
+		void (*GetStatistics)(GlyphCacheStatisticsType * statistics);
+	} GlyphCacheType;
+
+	extern GlyphCacheType GlyphCache;
+
+#endif /* __GLYPH_CACHE_H__ */
@@ -0,0 +1,452 @@
+/*
+ * imagePipeline.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Turns 8 bit grey images into 1 bit pixels in the display's page layout.
+ *
+ * Source rows are pushed one at a time. Each is scaled to the output width straight away, so only
+ * the last two scaled rows are kept. Output rows are blended from them (bilinear scaling), dithered
+ * and collected into a row of page bytes, which goes to the driver with BlitPage once 8 rows are in.
+ * All working memory is a few rows of the output width inside ImageConverterType.
+ *
+ * The vertical blend and the threshold/ordered dither are done 16 pixels at a time with SSE2 or
+ * NEON when the compiler targets them. Error diffusion carries from pixel to pixel so it stays
+ * scalar. Define IMAGE_PIPELINE_NO_SIMD to force the scalar code.
+ */
+#include "imagePipeline.h"
+
+#if !defined(IMAGE_PIPELINE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+	#include <emmintrin.h>
+	#define IMAGE_PIPELINE_SSE2
+#elif !defined(IMAGE_PIPELINE_NO_SIMD) && defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define IMAGE_PIPELINE_NEON
+#endif
+
+/**
+ * the 8x8 Bayer matrix scaled to thresholds between 2 and 254
+ */
+static const uint8_t BayerThreshold[8][8] = {
+	{  2, 130,  34, 162,  10, 138,  42, 170},
+	{194,  66, 226,  98, 202,  74, 234, 106},
+	{ 50, 178,  18, 146,  58, 186,  26, 154},
+	{242, 114, 210,  82, 250, 122, 218,  90},
+	{ 14, 142,  46, 174,   6, 134,  38, 166},
+	{206,  78, 238, 110, 198,  70, 230, 102},
+	{ 62, 190,  30, 158,  54, 182,  22, 150},
+	{254, 126, 222,  94, 246, 118, 214,  86}
+};
+
+/**
+ * works out the source position of an output pixel centre in 16.16
+ */
+static uint32_t sourcePosition(uint32_t index, uint32_t sourceSize, uint32_t outputSize) {
+	int64_t Position = ((((int64_t)(2 * index) + 1) * sourceSize) << 16) / (2 * (int64_t)outputSize) - 32768;
+
+	return Position < 0 ? 0 : (uint32_t)Position;
+}
+
+/**
+ * scales a source row to the output width
+ */
+static void scaleRow(ImageConverterType * converter, const uint8_t * source, uint8_t * destination) {
+	uint32_t Index;
+	uint32_t Column;
+	uint32_t Left;
+	uint32_t Right;
+
+	for(Index = 0; Index < converter->Width; Index++) {
+		Column = converter->XIndex[Index];
+		Left = source[Column];
+		Right = source[Column + (Column + 1 < converter->SourceWidth)];
+
+		destination[Index] = (uint8_t)(((Left * (256 - converter->XWeight[Index])) + (Right * converter->XWeight[Index]) + 128) >> 8);
+	}
+}
+
+/**
+ * blends two scaled rows. weight is 0 to 127 and is how much of the second row is used
+ */
+static void blendRows(const uint8_t * first, const uint8_t * second, uint8_t * destination, uint32_t length, int16_t weight) {
+	uint32_t Index = 0;
+
+	if(!weight) {
+		memcpy(destination, first, length);
+		return;
+	}
+
+#if defined(IMAGE_PIPELINE_SSE2)
+	{
+		__m128i Zero = _mm_setzero_si128();
+		__m128i Weight = _mm_set1_epi16(weight);
+		__m128i Round = _mm_set1_epi16(64);
+
+		for( ; Index + 16 <= length; Index += 16) {
+			__m128i A = _mm_loadu_si128((const __m128i *)&first[Index]);
+			__m128i B = _mm_loadu_si128((const __m128i *)&second[Index]);
+			__m128i ALow = _mm_unpacklo_epi8(A, Zero);
+			__m128i AHigh = _mm_unpackhi_epi8(A, Zero);
+			__m128i Low = _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(B, Zero), ALow), Weight), Round), 7);
+			__m128i High = _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(B, Zero), AHigh), Weight), Round), 7);
+
+			_mm_storeu_si128((__m128i *)&destination[Index], _mm_packus_epi16(_mm_add_epi16(ALow, Low), _mm_add_epi16(AHigh, High)));
+		}
+	}
+#elif defined(IMAGE_PIPELINE_NEON)
+	for( ; Index + 16 <= length; Index += 16) {
+		uint8x16_t A = vld1q_u8(&first[Index]);
+		uint8x16_t B = vld1q_u8(&second[Index]);
+		int16x8_t Low = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(B), vget_low_u8(A)));
+		int16x8_t High = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(B), vget_high_u8(A)));
+
+		Low = vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(A))), vrshrq_n_s16(vmulq_n_s16(Low, weight), 7));
+		High = vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(A))), vrshrq_n_s16(vmulq_n_s16(High, weight), 7));
+
+		vst1q_u8(&destination[Index], vcombine_u8(vqmovun_s16(Low), vqmovun_s16(High)));
+	}
+#endif
+
+	for( ; Index < length; Index++) {
+		destination[Index] = (uint8_t)(first[Index] + ((((int16_t)second[Index] - first[Index]) * weight + 64) >> 7));
+	}
+}
+
+/**
+ * sets bit in page for every pixel that is brighter than its threshold. The thresholds repeat every 8 pixels
+ */
+static void thresholdRow(const uint8_t * line, uint8_t * page, uint32_t length, const uint8_t * threshold, uint8_t bit) {
+	uint32_t Index = 0;
+
+#if defined(IMAGE_PIPELINE_SSE2)
+	{
+		__m128i Threshold = _mm_set_epi8(threshold[7], threshold[6], threshold[5], threshold[4], threshold[3], threshold[2], threshold[1], threshold[0],
+										threshold[7], threshold[6], threshold[5], threshold[4], threshold[3], threshold[2], threshold[1], threshold[0]);
+		__m128i Bit = _mm_set1_epi8(bit);
+
+		for( ; Index + 16 <= length; Index += 16) {
+			__m128i Value = _mm_loadu_si128((const __m128i *)&line[Index]);
+			// max(value, threshold) == threshold means the pixel stays off
+			__m128i Off = _mm_cmpeq_epi8(_mm_max_epu8(Value, Threshold), Threshold);
+			__m128i Page = _mm_loadu_si128((const __m128i *)&page[Index]);
+
+			_mm_storeu_si128((__m128i *)&page[Index], _mm_or_si128(Page, _mm_andnot_si128(Off, Bit)));
+		}
+	}
+#elif defined(IMAGE_PIPELINE_NEON)
+	{
+		uint8x8_t Half = vld1_u8(threshold);
+		uint8x16_t Threshold = vcombine_u8(Half, Half);
+		uint8x16_t Bit = vdupq_n_u8(bit);
+
+		for( ; Index + 16 <= length; Index += 16) {
+			uint8x16_t On = vandq_u8(vcgtq_u8(vld1q_u8(&line[Index]), Threshold), Bit);
+
+			vst1q_u8(&page[Index], vorrq_u8(vld1q_u8(&page[Index]), On));
+		}
+	}
+#endif
+
+	for( ; Index < length; Index++) {
+		if(line[Index] > threshold[Index & 7]) {
+			page[Index] |= bit;
+		}
+	}
+}
+
+/**
+ * error diffusion of one row
+ */
+static void diffuseRow(ImageConverterType * converter, uint8_t bit) {
+	int16_t * Current = &converter->Error[converter->ErrorRow][2];
+	int16_t * Next = &converter->Error[(converter->ErrorRow + 1) % 3][2];
+	int16_t * After = &converter->Error[(converter->ErrorRow + 2) % 3][2];
+	int32_t Index;
+	int32_t Value;
+	int32_t Error;
+
+	for(Index = 0; Index < (int32_t)converter->Width; Index++) {
+		Value = converter->Line[Index] + Current[Index];
+
+		if(Value > 127) {
+			converter->Page[Index] |= bit;
+			Error = Value - 255;
+		} else {
+			Error = Value;
+		}
+
+		if(converter->Dither == Dither_Atkinson) {
+			Error /= 8;
+			Current[Index + 1] += Error;
+			Current[Index + 2] += Error;
+			Next[Index - 1] += Error;
+			Next[Index] += Error;
+			Next[Index + 1] += Error;
+			After[Index] += Error;
+		} else {
+			Current[Index + 1] += (Error * 7) / 16;
+			Next[Index - 1] += (Error * 3) / 16;
+			Next[Index] += (Error * 5) / 16;
+			Next[Index + 1] += Error / 16;
+		}
+	}
+
+	// this row's error becomes the row after next
+	memset(&converter->Error[converter->ErrorRow][0], 0, sizeof(converter->Error[0]));
+	converter->ErrorRow = (converter->ErrorRow + 1) % 3;
+}
+
+/**
+ * writes the collected rows into the display
+ */
+static void flushPage(ImageConverterType * converter, int32_t row) {
+	int32_t Page = (row - (row & 7)) / 8;
+	uint32_t Index;
+	uint_fast8_t Bit;
+
+	if(converter->Display->BlitPage) {
+		converter->Display->BlitPage(converter->X, Page, &converter->Page[0], converter->Width, converter->PageMask, Raster_Copy);
+	} else {
+		for(Index = 0; Index < converter->Width; Index++) {
+			for(Bit = 0; Bit < 8; Bit++) {
+				if(converter->PageMask & (1 << Bit)) {
+					converter->Display->SetPixel(converter->X + Index, (Page * 8) + Bit, converter->Page[Index] & (1 << Bit));
+				}
+			}
+		}
+	}
+
+	memset(&converter->Page[0], 0, converter->Width);
+	converter->PageMask = 0;
+}
+
+/**
+ * produces one output row from the scaled rows
+ */
+static void emitRow(ImageConverterType * converter, uint32_t first, uint32_t second, uint8_t weight) {
+	int32_t Row = converter->Y + (int32_t)converter->OutputRow;
+	uint8_t Bit = 1 << (Row & 7);
+	uint8_t Threshold[8];
+
+	blendRows(&converter->Scaled[first & 1][0], &converter->Scaled[second & 1][0], &converter->Line[0], converter->Width, weight >> 1);
+
+	switch(converter->Dither) {
+		case Dither_Bayer:
+			thresholdRow(&converter->Line[0], &converter->Page[0], converter->Width, &BayerThreshold[Row & 7][0], Bit);
+		break;
+
+		case Dither_FloydSteinberg:
+		case Dither_Atkinson:
+			diffuseRow(converter, Bit);
+		break;
+
+		case Dither_Threshold:
+		default:
+			memset(&Threshold[0], converter->Threshold, sizeof(Threshold));
+			thresholdRow(&converter->Line[0], &converter->Page[0], converter->Width, &Threshold[0], Bit);
+		break;
+	}
+
+	converter->PageMask |= Bit;
+	converter->OutputRow++;
+
+	if((Row & 7) == 7 || converter->OutputRow == converter->Height) {
+		flushPage(converter, Row);
+	}
+}
+
+/**
+ * starts a conversion
+ *
+ * @param converter the conversion state
+ * @param display the driver to draw into
+ * @param sourceWidth source width in pixels
+ * @param sourceHeight source height in pixels
+ * @param x output rectangle
+ * @param y output rectangle
+ * @param width output width, at most IMAGE_PIPELINE_MAX_WIDTH
+ * @param height output height
+ * @param dither ImageDitherType
+ * @param threshold grey level above which Dither_Threshold turns pixels on
+ */
+static GraphicsReturnType Begin(ImageConverterType * converter, DisplayInterfaceType * display, uint32_t sourceWidth, uint32_t sourceHeight,
+								int32_t x, int32_t y, uint32_t width, uint32_t height, uint_fast8_t dither, uint8_t threshold) {
+	uint32_t Index;
+	uint32_t Position;
+
+	if(!converter || !display || (!display->BlitPage && !display->SetPixel)) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(!sourceWidth || !sourceHeight || !width || !height || width > IMAGE_PIPELINE_MAX_WIDTH || sourceWidth > 0xFFFF || dither > Dither_Atkinson) {
+		return BasicGReturned_Error;
+	}
+
+	converter->Display = display;
+	converter->SourceWidth = sourceWidth;
+	converter->SourceHeight = sourceHeight;
+	converter->X = x;
+	converter->Y = y;
+	converter->Width = width;
+	converter->Height = height;
+	converter->Dither = dither;
+	converter->Threshold = threshold;
+	converter->SourceRow = 0;
+	converter->OutputRow = 0;
+	converter->PageMask = 0;
+	converter->ErrorRow = 0;
+
+	for(Index = 0; Index < width; Index++) {
+		Position = sourcePosition(Index, sourceWidth, width);
+
+		if((Position >> 16) >= sourceWidth - 1) {
+			converter->XIndex[Index] = sourceWidth - 1;
+			converter->XWeight[Index] = 0;
+		} else {
+			converter->XIndex[Index] = Position >> 16;
+			converter->XWeight[Index] = (Position >> 8) & 0xFF;
+		}
+	}
+
+	memset(&converter->Error[0][0], 0, sizeof(converter->Error));
+	memset(&converter->Page[0], 0, sizeof(converter->Page));
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * takes the next source row and writes every output row that can now be made
+ */
+static GraphicsReturnType PushRow(ImageConverterType * converter, const uint8_t * row) {
+	uint32_t Position;
+	uint32_t First;
+	uint32_t Second;
+
+	if(!converter || !row) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(converter->SourceRow >= converter->SourceHeight) {
+		return BasicGReturned_Error;
+	}
+
+	scaleRow(converter, row, &converter->Scaled[converter->SourceRow & 1][0]);
+	converter->SourceRow++;
+
+	while(converter->OutputRow < converter->Height) {
+		Position = sourcePosition(converter->OutputRow, converter->SourceHeight, converter->Height);
+		First = Position >> 16;
+
+		if(First >= converter->SourceHeight - 1) {
+			First = converter->SourceHeight - 1;
+			Second = First;
+		} else {
+			Second = First + 1;
+		}
+
+		// wait for the rows this output row needs
+		if(Second >= converter->SourceRow) {
+			break;
+		}
+
+		emitRow(converter, First, Second, First == Second ? 0 : (Position >> 8) & 0xFF);
+	}
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * converts a whole image
+ */
+static GraphicsReturnType Convert(DisplayInterfaceType * display, const uint8_t * image, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t stride,
+									int32_t x, int32_t y, uint32_t width, uint32_t height, uint_fast8_t dither) {
+	static ImageConverterType Converter;
+	GraphicsReturnType Result;
+	uint32_t Row;
+
+	if(!image) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	Result = Begin(&Converter, display, sourceWidth, sourceHeight, x, y, width, height, dither, 127);
+
+	for(Row = 0; Row < sourceHeight && Result == BasicGReturned_OK; Row++) {
+		Result = PushRow(&Converter, &image[Row * stride]);
+	}
+
+	return Result;
+}
+
+/**
+ * reads a number from a PGM header, skipping white space and comments
+ */
+static const uint8_t * parseNumber(const uint8_t * position, const uint8_t * end, uint32_t * value) {
+	*value = 0;
+
+	while(position < end && (*position == ' ' || *position == '\t' || *position == '\r' || *position == '\n' || *position == '#')) {
+		if(*position == '#') {
+			while(position < end && *position != '\n') {
+				position++;
+			}
+		} else {
+			position++;
+		}
+	}
+
+	if(position >= end || *position < '0' || *position > '9') {
+		return NULL;
+	}
+
+	while(position < end && *position >= '0' && *position <= '9' && *value < 100000) {
+		*value = (*value * 10) + (*position++ - '0');
+	}
+
+	return position;
+}
+
+/**
+ * finds the pixels of a binary PGM
+ *
+ * @param file the whole file
+ * @param size file size in bytes
+ * @param width returns the image width
+ * @param height returns the image height
+ * @return the first pixel, or NULL if this isn't a P5 PGM with a maximum value of 255 or it is truncated
+ */
+static const uint8_t * ParsePGM(const uint8_t * file, uint32_t size, uint32_t * width, uint32_t * height) {
+	const uint8_t * End = file + size;
+	const uint8_t * Position;
+	uint32_t MaxValue;
+
+	if(!file || !width || !height || size < 2 || file[0] != 'P' || file[1] != '5') {
+		return NULL;
+	}
+
+	Position = parseNumber(&file[2], End, width);
+	Position = Position ? parseNumber(Position, End, height) : NULL;
+	Position = Position ? parseNumber(Position, End, &MaxValue) : NULL;
+
+	// a single white space character separates the header from the pixels
+	if(!Position || Position >= End || !*width || !*height || MaxValue != 255) {
+		return NULL;
+	}
+
+	Position++;
+
+	if((uint64_t)(End - Position) < (uint64_t)*width * *height) {
+		return NULL;
+	}
+
+	return Position;
+}
+
+/**
+ * This is our image pipeline instance
+ */
+ImagePipelineType ImagePipeline = {
+	Begin: Begin,
+	PushRow: PushRow,
+	Convert: Convert,
+	ParsePGM: ParsePGM
+};
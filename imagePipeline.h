@@ -0,0 +1,73 @@
+/*
+ * imagePipeline.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __IMAGE_PIPELINE_H__
+#define __IMAGE_PIPELINE_H__
+
+	#include "basicGraphics.h"
+
+	/**
+	 * defines the widest output rectangle
+	 */
+	#ifndef IMAGE_PIPELINE_MAX_WIDTH
+		#define IMAGE_PIPELINE_MAX_WIDTH 256
+	#endif
+
+	/**
+	 * defines the ways grey levels are turned into on and off pixels
+	 */
+	typedef enum {
+		Dither_Threshold = 0,		///< on when above the threshold
+		Dither_Bayer,				///< 8x8 ordered dither
+		Dither_FloydSteinberg,		///< error diffusion to 4 neighbours
+		Dither_Atkinson				///< error diffusion of 3/4 of the error to 6 neighbours, higher contrast
+	} ImageDitherType;
+
+	/**
+	 * defines the state of one conversion. It only holds a few rows of the output width
+	 */
+	typedef struct ImageConverterType {
+		DisplayInterfaceType * Display;
+		uint32_t SourceWidth;
+		uint32_t SourceHeight;
+		int32_t X;									///< output rectangle
+		int32_t Y;
+		uint32_t Width;
+		uint32_t Height;
+		uint8_t Dither;								///< ImageDitherType
+		uint8_t Threshold;							///< Dither_Threshold level
+		uint32_t SourceRow;							///< rows pushed so far
+		uint32_t OutputRow;							///< rows written so far
+		uint16_t XIndex[IMAGE_PIPELINE_MAX_WIDTH];	///< left source column of each output column
+		uint8_t XWeight[IMAGE_PIPELINE_MAX_WIDTH];	///< weight of the right source column
+		uint8_t Scaled[2][IMAGE_PIPELINE_MAX_WIDTH];	///< the last two source rows scaled to the output width
+		uint8_t Line[IMAGE_PIPELINE_MAX_WIDTH];		///< the output row in grey
+		int16_t Error[3][IMAGE_PIPELINE_MAX_WIDTH + 4];	///< diffused error for this row and the next two
+		uint8_t ErrorRow;							///< which Error row is the current one
+		uint8_t Page[IMAGE_PIPELINE_MAX_WIDTH];		///< output bits waiting to be written a page at a time
+		uint8_t PageMask;							///< rows held in Page
+	} ImageConverterType;
+
+	/**
+	 * defines the image pipeline interface
+	 */
+	typedef struct ImagePipelineType {
+		/** starts converting a sourceWidth x sourceHeight grey image into the rectangle of display. threshold is only used by Dither_Threshold **/
+		GraphicsReturnType (*Begin)(ImageConverterType * converter, DisplayInterfaceType * display, uint32_t sourceWidth, uint32_t sourceHeight,
+									int32_t x, int32_t y, uint32_t width, uint32_t height, uint_fast8_t dither, uint8_t threshold);
+		/** takes the next source row, 8 bits per pixel. Output rows are written as soon as they can be **/
+		GraphicsReturnType (*PushRow)(ImageConverterType * converter, const uint8_t * row);
+		/** converts a whole image. stride is the distance between rows in bytes **/
+		GraphicsReturnType (*Convert)(DisplayInterfaceType * display, const uint8_t * image, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t stride,
+									int32_t x, int32_t y, uint32_t width, uint32_t height, uint_fast8_t dither);
+		/** finds the pixels of a binary (P5) PGM with a maximum value of 255. Returns NULL if it isn't one **/
+		const uint8_t * (*ParsePGM)(const uint8_t * file, uint32_t size, uint32_t * width, uint32_t * height);
+	} ImagePipelineType;
+
+	extern ImagePipelineType ImagePipeline;
+
+#endif /* __IMAGE_PIPELINE_H__ */
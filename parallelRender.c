@@ -0,0 +1,862 @@
+/*
+ * parallelRender.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Renders a frame on several threads by splitting the canvas into horizontal bands.
+ *
+ * Draw calls are recorded into a command buffer together with the rows they can touch. Finish
+ * splits the canvas into bands of whole pages, so no two bands share a byte of the frame buffer,
+ * and hands each thread a run of bands. A thread that runs out of bands steals the last band of
+ * another thread's run. Every band replays the commands that overlap it with the band versions of
+ * the primitives below, which skip the rows outside the band instead of walking them. They draw
+ * exactly the pixels GraphicsInstance draws for the same calls, quirks included, so a frame looks
+ * the same whichever way it is rendered.
+ *
+ * The bands share nothing but the read only command buffer, so GraphicsInstance and the glyph
+ * cache, which aren't thread safe, are left alone.
+ */
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+#include "parallelRender.h"
+#include "workerPool.h"
+
+/**
+ * defines the recorded commands
+ */
+typedef enum {
+	Command_Fill = 0,
+	Command_FillRect,
+	Command_Line,
+	Command_Rectangle,
+	Command_Circle,
+	Command_Text,
+	Command_Icon
+} parallelCommandKindType;
+
+/**
+ * defines a recorded command
+ */
+typedef struct {
+	uint8_t Kind;				///< parallelCommandKindType
+	uint8_t Colour;
+	uint8_t Fill;
+	uint8_t ScaleX;
+	uint8_t ScaleY;
+	int32_t Values[4];			///< the coordinates, in the order the draw call takes them
+	int32_t Top;				///< the first row the command can touch
+	int32_t Bottom;				///< the row after the last row the command can touch
+	const void * Data;			///< the text or the icon
+	const GFXfont * Font;
+} parallelCommandType;
+
+/**
+ * defines a thread's run of bands. The first band is in the low half and the end in the high half
+ * so the owner and a thief can both move it with one compare and swap
+ */
+typedef struct {
+	_Alignas(64) atomic_uint_fast64_t Range;
+} parallelBandQueueType;
+
+/**
+ * defines the rows a thread is drawing
+ */
+typedef struct {
+	int32_t FirstRow;
+	int32_t EndRow;
+} parallelBandType;
+
+/**
+ * the band the current thread is drawing
+ */
+static _Thread_local parallelBandType * CurrentBand;
+
+/**
+ * the canvas of the frame being recorded
+ */
+static SurfaceType * Canvas;
+
+/**
+ * the command buffer. Commands grow up from the start of the memory and text grows down from the end
+ */
+static parallelCommandType * Commands;
+static uint32_t CommandCount;
+static uint8_t * Memory;
+static uint32_t MemorySize;
+static uint32_t TextStart;
+
+/**
+ * the worker threads. Thread 0 is the one that calls Finish
+ */
+static void RenderBands(uint32_t thread);
+static WorkerPoolType Pool = WORKER_POOL_INIT(RenderBands);
+static uint32_t Threads;
+
+/**
+ * the band queues and the band size of the pass being rendered
+ */
+static parallelBandQueueType Queues[PARALLEL_RENDER_MAX_THREADS];
+static uint32_t BandRows;
+static uint32_t BandCount;
+
+/**
+ * the counters. Steals and Bands are updated by the workers
+ */
+static ParallelRenderStatisticsType Statistics;
+static atomic_uint Steals;
+static atomic_uint BandsRendered;
+
+/**
+ * sets a pixel if it is inside the current band
+ */
+static void BandSetPixel(uint32_t x, uint32_t y, uint8_t value) {
+	uint8_t * Destination;
+
+	if(x >= Canvas->Width || (int32_t)y < CurrentBand->FirstRow || (int32_t)y >= CurrentBand->EndRow) {
+		return;
+	}
+
+	Destination = &Canvas->Buffer[((y / 8) * Canvas->Width) + x];
+
+	if(value) {
+		*Destination |= 1 << (y & 7);
+	} else {
+		*Destination &= ~(1 << (y & 7));
+	}
+}
+
+/**
+ * sets or clears the part of a rectangle that is inside the current band
+ */
+static void BandFillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+	uint32_t Page;
+	uint32_t LastPage;
+	uint8_t Mask;
+	uint8_t * Destination;
+	int32_t Column;
+
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < CurrentBand->FirstRow) {
+		y = CurrentBand->FirstRow;
+	}
+	if(XEnd > (int32_t)Canvas->Width) {
+		XEnd = Canvas->Width;
+	}
+	if(YEnd > CurrentBand->EndRow) {
+		YEnd = CurrentBand->EndRow;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	LastPage = (YEnd - 1) / 8;
+
+	for(Page = y / 8; Page <= LastPage; Page++) {
+		Mask = 0xFF;
+
+		if(Page == (uint32_t)(y / 8)) {
+			Mask &= 0xFF << (y & 7);
+		}
+		if(Page == LastPage) {
+			Mask &= 0xFF >> (7 - ((YEnd - 1) & 7));
+		}
+
+		Destination = &Canvas->Buffer[(Page * Canvas->Width) + x];
+
+		for(Column = x; Column < XEnd; Column++) {
+			*Destination = value ? (*Destination | Mask) : (*Destination & ~Mask);
+			Destination++;
+		}
+	}
+}
+
+/**
+ * clamps a point to the canvas, as GraphicsInstance does with lines, rectangles and circle centres
+ */
+static void ClampPoint(int32_t * x, int32_t * y) {
+	*x = *x < 0 ? 0 : (*x >= (int32_t)Canvas->Width ? (int32_t)Canvas->Width - 1 : *x);
+	*y = *y < 0 ? 0 : (*y >= (int32_t)Canvas->Height ? (int32_t)Canvas->Height - 1 : *y);
+}
+
+/**
+ * draws the part of a line that is inside the current band. The pixels are those of
+ * GraphicsInstance.drawLine, but the walk stops once it has left the band
+ */
+static void BandLine(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour) {
+	int32_t DeltaX;
+	int32_t DeltaY;
+	int32_t OffsetX;
+	int32_t OffsetY;
+	int32_t DeltaError;
+	int32_t Error;
+
+	ClampPoint(&xStart, &yStart);
+	ClampPoint(&xEnd, &yEnd);
+
+	// straight lines are runs of whole pixels
+	if(xStart == xEnd || yStart == yEnd) {
+		BandFillRect(xStart < xEnd ? xStart : xEnd, yStart < yEnd ? yStart : yEnd, abs(xEnd - xStart) + 1, abs(yEnd - yStart) + 1, colour);
+		return;
+	}
+
+	DeltaX = abs(xEnd - xStart);
+	DeltaY = abs(yEnd - yStart);
+	OffsetX = xStart < xEnd ? 1 : -1;
+	OffsetY = yStart < yEnd ? 1 : -1;
+	DeltaError = (DeltaX > DeltaY ? DeltaX : -DeltaY) / 2;
+
+	for(;;) {
+		if(yStart >= CurrentBand->FirstRow && yStart < CurrentBand->EndRow) {
+			BandSetPixel(xStart, yStart, colour);
+		} else if((OffsetY > 0) ? (yStart >= CurrentBand->EndRow) : (yStart < CurrentBand->FirstRow)) {
+			return;
+		}
+
+		if(xStart == xEnd && yStart == yEnd) {
+			return;
+		}
+
+		Error = DeltaError;
+
+		if(Error > -DeltaX) {
+			DeltaError -= DeltaY;
+			xStart += OffsetX;
+		}
+		if(Error < DeltaY) {
+			DeltaError += DeltaX;
+			yStart += OffsetY;
+		}
+	}
+}
+
+/**
+ * draws the part of a rectangle that is inside the current band, as GraphicsInstance.drawRectagle does
+ */
+static void BandRectangle(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour, uint_fast8_t fill) {
+
+	ClampPoint(&xStart, &yStart);
+	ClampPoint(&xEnd, &yEnd);
+
+	if(!fill) {
+		BandLine(xStart, yStart, xStart, yEnd, colour);
+		BandLine(xStart, yStart, xEnd, yStart, colour);
+		BandLine(xEnd, yEnd, xEnd, yStart, colour);
+		BandLine(xEnd, yEnd, xStart, yEnd, colour);
+		return;
+	}
+
+	// a filled rectangle covers the columns from xStart up to, but not including, xEnd
+	if(xStart < xEnd) {
+		BandFillRect(xStart, yStart < yEnd ? yStart : yEnd, xEnd - xStart, abs(yEnd - yStart) + 1, colour);
+	} else if(xStart > xEnd) {
+		BandFillRect(xEnd + 1, yStart < yEnd ? yStart : yEnd, xStart - xEnd, abs(yEnd - yStart) + 1, colour);
+	}
+}
+
+/**
+ * draws the part of a circle that is inside the current band, as GraphicsInstance.drawCircle does.
+ * Each filled span is a clamped line, which is a single clamped row
+ */
+static void BandCircle(int32_t x0, int32_t y0, int32_t radius, uint_fast8_t colour, uint_fast8_t fill) {
+	int32_t X = radius - 1;
+	int32_t Y = 0;
+	int32_t DeltaX = 1;
+	int32_t DeltaY = 1;
+	int32_t Error = DeltaX - (radius * 2);
+
+	ClampPoint(&x0, &y0);
+
+	while(X >= Y) {
+		if(fill) {
+			BandLine(x0 + X, y0 + Y, x0 - X, y0 + Y, colour);
+			BandLine(x0 + Y, y0 + X, x0 - Y, y0 + X, colour);
+			BandLine(x0 - X, y0 - Y, x0 + X, y0 - Y, colour);
+			BandLine(x0 - Y, y0 - X, x0 + Y, y0 - X, colour);
+		} else {
+			BandSetPixel(x0 + X, y0 + Y, colour);
+			BandSetPixel(x0 - X, y0 + Y, colour);
+			BandSetPixel(x0 + Y, y0 + X, colour);
+			BandSetPixel(x0 - Y, y0 + X, colour);
+			BandSetPixel(x0 - X, y0 - Y, colour);
+			BandSetPixel(x0 + X, y0 - Y, colour);
+			BandSetPixel(x0 - Y, y0 - X, colour);
+			BandSetPixel(x0 + Y, y0 - X, colour);
+		}
+
+		if(Error <= 0) {
+			Y++;
+			Error += DeltaY;
+			DeltaY += 2;
+		}
+		if(Error > 0) {
+			X--;
+			DeltaX += 2;
+			Error += DeltaX - (radius * 2);
+		}
+	}
+}
+
+/**
+ * draws the rows of a string that are inside the current band. Every set bit of a glyph is a
+ * scaleX by scaleY block, as GraphicsInstance.WriteStringScaled draws it
+ */
+static void BandText(const uint8_t * text, int32_t x, int32_t y, uint_fast8_t colour, const GFXfont * font, uint_fast8_t scaleX, uint_fast8_t scaleY) {
+	const GFXglyph * Glyph;
+	uint32_t Bit;
+	int32_t Top;
+	int32_t Row;
+	int32_t LastRow;
+	int32_t Column;
+
+	for( ; *text; text++) {
+		if(*text < font->first || *text > font->last) {
+			continue;
+		}
+
+		Glyph = &font->glyph[*text - font->first];
+		Top = y + (Glyph->yOffset * scaleY);
+
+		// only the glyph rows that land in the band
+		Row = (CurrentBand->FirstRow - Top) / scaleY;
+		Row = Row < 0 ? 0 : Row;
+		LastRow = (CurrentBand->EndRow - 1 - Top) / scaleY;
+		LastRow = LastRow >= Glyph->height ? Glyph->height - 1 : LastRow;
+
+		for( ; Row <= LastRow && Top + (Row * scaleY) < CurrentBand->EndRow; Row++) {
+			Bit = (Glyph->bitmapOffset * 8) + (Row * Glyph->width);
+
+			for(Column = 0; Column < Glyph->width; Column++, Bit++) {
+				if(font->bitmap[Bit / 8] & (0x80 >> (Bit & 7))) {
+					BandFillRect(x + ((Glyph->xOffset + Column) * scaleX), Top + (Row * scaleY), scaleX, scaleY, colour);
+				}
+			}
+		}
+
+		x += Glyph->xAdvance * scaleX;
+	}
+}
+
+/**
+ * draws the rows of an icon that are inside the current band. The bits run down each column and
+ * clear bits are drawn in colour 0, as GraphicsInstance.drawIcon draws them
+ */
+static void BandIcon(int32_t x, int32_t y, uint32_t height, uint32_t width, uint_fast8_t colour, const uint32_t * source) {
+	uint32_t Column;
+	uint32_t Row = 0;
+	uint32_t LastRow = height;
+	uint32_t Bit;
+
+	if(y < CurrentBand->FirstRow) {
+		Row = CurrentBand->FirstRow - y;
+	}
+	if(y + (int32_t)height > CurrentBand->EndRow) {
+		LastRow = CurrentBand->EndRow - y;
+	}
+
+	for(Column = 0; Column < width; Column++) {
+		for(Bit = (Column * height) + Row; Bit < (Column * height) + LastRow; Bit++) {
+			BandSetPixel(x + Column, y + (Bit - (Column * height)), ((source[Bit / 32] << (Bit & 31)) & 0x80000000) ? colour : 0);
+		}
+	}
+}
+
+/**
+ * replays the commands that overlap a band
+ */
+static void RenderBand(uint32_t band) {
+	parallelBandType Band;
+	parallelCommandType * Command;
+	uint32_t Index;
+
+	Band.FirstRow = band * BandRows;
+	Band.EndRow = Band.FirstRow + BandRows;
+	if(Band.EndRow > (int32_t)Canvas->Height) {
+		Band.EndRow = Canvas->Height;
+	}
+
+	CurrentBand = &Band;
+
+	for(Index = 0; Index < CommandCount; Index++) {
+		Command = &Commands[Index];
+
+		if(Command->Bottom <= Band.FirstRow || Command->Top >= Band.EndRow) {
+			continue;
+		}
+
+		switch(Command->Kind) {
+			case Command_Fill:
+				// whole pages, like a display's Fill, so the rows below the last one match too
+				memset(&Canvas->Buffer[(Band.FirstRow / 8) * Canvas->Width], Command->Colour ? 0xFF : 0x00,
+						(((Band.EndRow + 7) / 8) - (Band.FirstRow / 8)) * Canvas->Width);
+			break;
+
+			case Command_FillRect:
+				BandFillRect(Command->Values[0], Command->Values[1], Command->Values[2], Command->Values[3], Command->Colour);
+			break;
+
+			case Command_Line:
+				BandLine(Command->Values[0], Command->Values[1], Command->Values[2], Command->Values[3], Command->Colour);
+			break;
+
+			case Command_Rectangle:
+				BandRectangle(Command->Values[0], Command->Values[1], Command->Values[2], Command->Values[3], Command->Colour, Command->Fill);
+			break;
+
+			case Command_Circle:
+				BandCircle(Command->Values[0], Command->Values[1], Command->Values[2], Command->Colour, Command->Fill);
+			break;
+
+			case Command_Text:
+				BandText(Command->Data, Command->Values[0], Command->Values[1], Command->Colour, Command->Font, Command->ScaleX, Command->ScaleY);
+			break;
+
+			case Command_Icon:
+				BandIcon(Command->Values[0], Command->Values[1], Command->Values[3], Command->Values[2], Command->Colour, Command->Data);
+			break;
+		}
+	}
+
+	CurrentBand = NULL;
+	atomic_fetch_add_explicit(&BandsRendered, 1, memory_order_relaxed);
+}
+
+/**
+ * takes the next band from the front of a thread's own run
+ *
+ * @return the band or -1 when the run is empty
+ */
+static int32_t TakeBand(parallelBandQueueType * queue) {
+	uint_fast64_t Range = atomic_load_explicit(&queue->Range, memory_order_relaxed);
+	uint32_t First;
+	uint32_t End;
+
+	do {
+		First = (uint32_t)Range;
+		End = (uint32_t)(Range >> 32);
+
+		if(First >= End) {
+			return -1;
+		}
+	} while(!atomic_compare_exchange_weak_explicit(&queue->Range, &Range, ((uint_fast64_t)End << 32) | (First + 1), memory_order_relaxed, memory_order_relaxed));
+
+	return First;
+}
+
+/**
+ * takes the last band of another thread's run
+ *
+ * @return the band or -1 when the run is empty
+ */
+static int32_t StealBand(parallelBandQueueType * queue) {
+	uint_fast64_t Range = atomic_load_explicit(&queue->Range, memory_order_relaxed);
+	uint32_t First;
+	uint32_t End;
+
+	do {
+		First = (uint32_t)Range;
+		End = (uint32_t)(Range >> 32);
+
+		if(First >= End) {
+			return -1;
+		}
+	} while(!atomic_compare_exchange_weak_explicit(&queue->Range, &Range, ((uint_fast64_t)(End - 1) << 32) | First, memory_order_relaxed, memory_order_relaxed));
+
+	atomic_fetch_add_explicit(&Steals, 1, memory_order_relaxed);
+
+	return End - 1;
+}
+
+/**
+ * renders bands until every run is empty
+ */
+static void RenderBands(uint32_t thread) {
+	int32_t Band;
+	uint32_t Victim;
+
+	for(;;) {
+		Band = TakeBand(&Queues[thread]);
+
+		for(Victim = 1; Band < 0 && Victim < Threads; Victim++) {
+			Band = StealBand(&Queues[(thread + Victim) % Threads]);
+		}
+
+		if(Band < 0) {
+			return;
+		}
+
+		RenderBand(Band);
+	}
+}
+
+/**
+ * renders the recorded commands on every thread and empties the command buffer
+ */
+static void RenderPass(void) {
+	uint32_t Pages = Canvas->Pages;
+	uint32_t BandPages;
+	uint32_t Thread;
+
+	if(!CommandCount) {
+		return;
+	}
+
+	// a few bands per thread so that there is something left to steal
+	BandPages = Pages / (Threads * 2);
+	if(!BandPages) {
+		BandPages = 1;
+	}
+	if((Pages + BandPages - 1) / BandPages > PARALLEL_RENDER_MAX_BANDS) {
+		BandPages = (Pages + PARALLEL_RENDER_MAX_BANDS - 1) / PARALLEL_RENDER_MAX_BANDS;
+	}
+
+	BandRows = BandPages * 8;
+	BandCount = (Pages + BandPages - 1) / BandPages;
+
+	for(Thread = 0; Thread < Threads; Thread++) {
+		atomic_store_explicit(&Queues[Thread].Range,
+				((uint_fast64_t)(((Thread + 1) * BandCount) / Threads) << 32) | ((Thread * BandCount) / Threads),
+				memory_order_relaxed);
+	}
+
+	WorkerPoolWake(&Pool);
+	RenderBands(0);
+	WorkerPoolWait(&Pool);
+
+	Canvas->Dirty = 1;
+	CommandCount = 0;
+	TextStart = MemorySize;
+	Statistics.Passes++;
+}
+
+/**
+ * gets a free command, rendering what has been recorded so far if the buffer is full
+ *
+ * @param textLength bytes of text the command needs
+ * @return the command or NULL if nothing is being recorded or it can never fit
+ */
+static parallelCommandType * NewCommand(uint32_t textLength) {
+	parallelCommandType * Command;
+
+	if(!Canvas) {
+		return NULL;
+	}
+
+	if(textLength > TextStart || ((CommandCount + 1) * sizeof(parallelCommandType)) > (TextStart - textLength)) {
+		RenderPass();
+
+		if(textLength > TextStart || ((CommandCount + 1) * sizeof(parallelCommandType)) > (TextStart - textLength)) {
+			return NULL;
+		}
+	}
+
+	Command = &Commands[CommandCount];
+	memset(Command, 0, sizeof(*Command));
+
+	return Command;
+}
+
+/**
+ * keeps a command if any of the rows it can touch are on the canvas
+ */
+static void AddCommand(parallelCommandType * command, int32_t top, int32_t bottom) {
+	command->Top = top < 0 ? 0 : top;
+	command->Bottom = bottom > (int32_t)Canvas->Height ? (int32_t)Canvas->Height : bottom;
+
+	if(command->Top >= command->Bottom) {
+		return;
+	}
+
+	CommandCount++;
+	Statistics.Commands++;
+}
+
+/**
+ * clamps a row to the canvas, as lines and rectangles do
+ */
+static int32_t ClampRow(int32_t y) {
+	return y < 0 ? 0 : (y >= (int32_t)Canvas->Height ? (int32_t)Canvas->Height - 1 : y);
+}
+
+static void Fill(uint8_t value) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command) {
+		return;
+	}
+
+	Command->Kind = Command_Fill;
+	Command->Colour = value;
+
+	AddCommand(Command, 0, Canvas->Height);
+}
+
+static void FillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint_fast8_t colour) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command || width <= 0 || height <= 0) {
+		return;
+	}
+
+	Command->Kind = Command_FillRect;
+	Command->Colour = colour;
+	Command->Values[0] = x;
+	Command->Values[1] = y;
+	Command->Values[2] = width;
+	Command->Values[3] = height;
+
+	AddCommand(Command, y, y + height);
+}
+
+static void drawLine(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command) {
+		return;
+	}
+
+	Command->Kind = Command_Line;
+	Command->Colour = colour;
+	Command->Values[0] = xStart;
+	Command->Values[1] = yStart;
+	Command->Values[2] = xEnd;
+	Command->Values[3] = yEnd;
+
+	yStart = ClampRow(yStart);
+	yEnd = ClampRow(yEnd);
+
+	AddCommand(Command, yStart < yEnd ? yStart : yEnd, (yStart < yEnd ? yEnd : yStart) + 1);
+}
+
+static void drawRectagle(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour, uint_fast8_t fill) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command) {
+		return;
+	}
+
+	Command->Kind = Command_Rectangle;
+	Command->Colour = colour;
+	Command->Fill = fill;
+	Command->Values[0] = xStart;
+	Command->Values[1] = yStart;
+	Command->Values[2] = xEnd;
+	Command->Values[3] = yEnd;
+
+	yStart = ClampRow(yStart);
+	yEnd = ClampRow(yEnd);
+
+	AddCommand(Command, yStart < yEnd ? yStart : yEnd, (yStart < yEnd ? yEnd : yStart) + 1);
+}
+
+static void drawCircle(int32_t x0, int32_t y0, int32_t radius, uint_fast8_t colour, uint_fast8_t fill) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command || radius <= 0) {
+		return;
+	}
+
+	Command->Kind = Command_Circle;
+	Command->Colour = colour;
+	Command->Fill = fill;
+	Command->Values[0] = x0;
+	Command->Values[1] = y0;
+	Command->Values[2] = radius;
+
+	// the centre is clamped and the filled spans are clamped lines, so they stay on the canvas too
+	y0 = ClampRow(y0);
+
+	AddCommand(Command, y0 - radius, y0 + radius + 1);
+}
+
+static void WriteStringScaled(const uint8_t * text, int32_t xPos, int32_t yPos, uint_fast8_t colour, const GFXfont * font, uint_fast8_t scaleX, uint_fast8_t scaleY) {
+	parallelCommandType * Command;
+	const GFXglyph * Glyph;
+	const uint8_t * Character;
+	uint32_t Length;
+	int32_t Top = INT32_MAX;
+	int32_t Bottom = INT32_MIN;
+
+	if(!font) {
+		font = GraphicsInstance.GetFont();
+	}
+
+	if(!text || !font) {
+		return;
+	}
+
+	Length = strlen((const char *)text) + 1;
+	Command = NewCommand(Length);
+
+	if(!Command) {
+		return;
+	}
+
+	scaleX = !scaleX ? 1 : (scaleX > BASIC_GRAPHICS_MAX_FONT_SCALE ? BASIC_GRAPHICS_MAX_FONT_SCALE : scaleX);
+	scaleY = !scaleY ? 1 : (scaleY > BASIC_GRAPHICS_MAX_FONT_SCALE ? BASIC_GRAPHICS_MAX_FONT_SCALE : scaleY);
+
+	// the rows come from the glyphs that will actually be drawn
+	for(Character = text; *Character; Character++) {
+		if(*Character < font->first || *Character > font->last) {
+			continue;
+		}
+
+		Glyph = &font->glyph[*Character - font->first];
+
+		if(Glyph->width && Glyph->height) {
+			if(yPos + (Glyph->yOffset * scaleY) < Top) {
+				Top = yPos + (Glyph->yOffset * scaleY);
+			}
+			if(yPos + ((Glyph->yOffset + Glyph->height) * scaleY) > Bottom) {
+				Bottom = yPos + ((Glyph->yOffset + Glyph->height) * scaleY);
+			}
+		}
+	}
+
+	if(Top >= Bottom) {
+		return;
+	}
+
+	TextStart -= Length;
+	memcpy(&Memory[TextStart], text, Length);
+
+	Command->Kind = Command_Text;
+	Command->Colour = colour;
+	Command->ScaleX = scaleX;
+	Command->ScaleY = scaleY;
+	Command->Values[0] = xPos;
+	Command->Values[1] = yPos;
+	Command->Data = &Memory[TextStart];
+	Command->Font = font;
+
+	AddCommand(Command, Top, Bottom);
+}
+
+static void drawIcon(int32_t x, int32_t y, uint32_t height, uint32_t width, uint_fast8_t colour, const uint32_t * source) {
+	parallelCommandType * Command = NewCommand(0);
+
+	if(!Command || !source || !width || !height) {
+		return;
+	}
+
+	Command->Kind = Command_Icon;
+	Command->Colour = colour;
+	Command->Values[0] = x;
+	Command->Values[1] = y;
+	Command->Values[2] = width;
+	Command->Values[3] = height;
+	Command->Data = source;
+
+	AddCommand(Command, y, y + (int32_t)height);
+}
+
+static GraphicsReturnType Begin(SurfaceType * canvas) {
+
+	if(!canvas || !canvas->Buffer) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(!Threads) {
+		return BasicGReturned_Error;
+	}
+
+	Canvas = canvas;
+	CommandCount = 0;
+	TextStart = MemorySize;
+
+	return BasicGReturned_OK;
+}
+
+static GraphicsReturnType Finish(void) {
+	struct timespec Start;
+	struct timespec End;
+
+	if(!Canvas) {
+		return BasicGReturned_Error;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &Start);
+
+	RenderPass();
+
+	clock_gettime(CLOCK_MONOTONIC, &End);
+
+	Statistics.Frames++;
+	Statistics.LastFrameMicroseconds = ((End.tv_sec - Start.tv_sec) * 1000000) + ((End.tv_nsec - Start.tv_nsec) / 1000);
+	Canvas = NULL;
+
+	return BasicGReturned_OK;
+}
+
+static void Stop(void) {
+	WorkerPoolStop(&Pool);
+
+	Threads = 0;
+	Canvas = NULL;
+}
+
+static int32_t Start(uint32_t threads, void * memory, uint32_t size) {
+	uintptr_t Aligned;
+	int32_t Result;
+
+	if(!threads || threads > PARALLEL_RENDER_MAX_THREADS || !memory) {
+		return -EINVAL;
+	}
+
+	Stop();
+
+	// the commands need pointer alignment
+	Aligned = ((uintptr_t)memory + (sizeof(void *) - 1)) & ~(uintptr_t)(sizeof(void *) - 1);
+	if(size < (Aligned - (uintptr_t)memory) + sizeof(parallelCommandType)) {
+		return -EINVAL;
+	}
+
+	Memory = (uint8_t *)Aligned;
+	MemorySize = size - (Aligned - (uintptr_t)memory);
+	Commands = (parallelCommandType *)Memory;
+	TextStart = MemorySize;
+
+	Result = WorkerPoolStart(&Pool, threads - 1);
+	if(Result) {
+		Stop();
+		return Result;
+	}
+
+	Threads = threads;
+
+	return 0;
+}
+
+static void GetStatistics(ParallelRenderStatisticsType * statistics) {
+	if(!statistics) {
+		return;
+	}
+
+	*statistics = Statistics;
+	statistics->Steals = atomic_load(&Steals);
+	statistics->Bands = atomic_load(&BandsRendered);
+}
+
+/**
+ * This is our parallel renderer instance
+ */
+ParallelRenderType ParallelRender = {
+	Start: Start,
+	Stop: Stop,
+	Begin: Begin,
+	Fill: Fill,
+	FillRect: FillRect,
+	drawLine: drawLine,
+	drawRectagle: drawRectagle,
+	drawCircle: drawCircle,
+	WriteStringScaled: WriteStringScaled,
+	drawIcon: drawIcon,
+	Finish: Finish,
+	GetStatistics: GetStatistics
+};
@@ -0,0 +1,71 @@
+/*
+ * parallelRender.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __PARALLEL_RENDER_H__
+#define __PARALLEL_RENDER_H__
+
+	#include "basicGraphics.h"
+	#include "surface.h"
+
+	/**
+	 * the most threads that render a frame, the calling thread included
+	 */
+	#ifndef PARALLEL_RENDER_MAX_THREADS
+		#define PARALLEL_RENDER_MAX_THREADS 8
+	#endif
+
+	/**
+	 * the most bands a frame is split into
+	 */
+	#ifndef PARALLEL_RENDER_MAX_BANDS
+		#define PARALLEL_RENDER_MAX_BANDS 64
+	#endif
+
+	/**
+	 * defines the parallel renderer counters
+	 */
+	typedef struct ParallelRenderStatisticsType {
+		uint32_t Frames;				///< Finish calls
+		uint32_t Passes;				///< times the recorded commands were rendered, more than Frames when the buffer filled up
+		uint32_t Commands;				///< commands recorded
+		uint32_t Bands;					///< bands rendered
+		uint32_t Steals;				///< bands a thread took from another thread's queue
+		uint32_t LastFrameMicroseconds;	///< time taken by the last Finish
+	} ParallelRenderStatisticsType;
+
+	/**
+	 * defines the parallel renderer interface
+	 *
+	 * Draw calls between Begin and Finish are recorded with their bounding boxes. Finish splits the
+	 * canvas into bands of whole pages and the threads render the bands side by side, each clipped to
+	 * its own rows, so the frame buffer needs no locks. The result is pixel for pixel what the same
+	 * GraphicsInstance calls draw on the canvas.
+	 */
+	typedef struct ParallelRenderType {
+		/** starts threads - 1 workers. memory holds the recorded commands and text, it is not copied. Returns 0 or a negative errno **/
+		int32_t (*Start)(uint32_t threads, void * memory, uint32_t size);
+		/** stops the workers **/
+		void (*Stop)(void);
+		/** starts recording a frame for the canvas **/
+		GraphicsReturnType (*Begin)(SurfaceType * canvas);
+		void (*Fill)(uint8_t value);
+		void (*FillRect)(int32_t x, int32_t y, int32_t width, int32_t height, uint_fast8_t colour);
+		void (*drawLine)(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour);
+		void (*drawRectagle)(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd, uint_fast8_t colour, uint_fast8_t fill);
+		void (*drawCircle)(int32_t x0, int32_t y0, int32_t radius, uint_fast8_t colour, uint_fast8_t fill);
+		/** the text is copied. font NULL is the current font **/
+		void (*WriteStringScaled)(const uint8_t * text, int32_t xPos, int32_t yPos, uint_fast8_t colour, const GFXfont * font, uint_fast8_t scaleX, uint_fast8_t scaleY);
+		/** the icon is not copied and must stay valid until Finish **/
+		void (*drawIcon)(int32_t x, int32_t y, uint32_t height, uint32_t width, uint_fast8_t colour, const uint32_t * source);
+		/** renders everything recorded since Begin **/
+		GraphicsReturnType (*Finish)(void);
+		void (*GetStatistics)(ParallelRenderStatisticsType * statistics);
+	} ParallelRenderType;
+
+	extern ParallelRenderType ParallelRender;
+
+#endif /* __PARALLEL_RENDER_H__ */
@@ -0,0 +1,539 @@
+/*
+ * surface.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * Off screen surfaces that use the same page layout as the display buffer.
+ *
+ * Surface.Bind returns a display driver that draws into a surface, so every GraphicsInstance
+ * primitive can target it through GraphicsInstance.SetTarget. Finished surfaces are then combined
+ * into the display, or into other surfaces, with clipping and raster ops. When the source and
+ * destination rows line up on a page boundary the rows are handed over as they are, otherwise
+ * each destination byte is built from the two source bytes it straddles.
+ */
+#include "surface.h"
+#include "../common.h"
+
+/**
+ * the largest number of columns we shift in one go when the rows don't line up
+ */
+#define SURFACE_ROW_CHUNK 64
+
+/**
+ * the surface the surface display driver draws into
+ */
+static SurfaceType * Bound;
+
+/**
+ * defines the function compose uses to write a row of page bytes
+ */
+typedef void (*composeBlitType)(void * destination, int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation);
+
+/**
+ * sets up a surface on the given memory
+ *
+ * @param surface the surface to set up
+ * @param width width in pixels
+ * @param height height in pixels
+ * @param format SurfaceFormatType
+ * @param memory the surface buffer
+ * @param size size of memory in bytes
+ */
+static GraphicsReturnType Create(SurfaceType * surface, uint32_t width, uint32_t height, uint8_t format, uint8_t * memory, uint32_t size) {
+
+	if(!surface || !memory) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(format != Surface_PageMonochrome || !width || !height || size < SURFACE_BUFFER_SIZE(width, height)) {
+		return BasicGReturned_Error;
+	}
+
+	surface->Width = width;
+	surface->Height = height;
+	surface->Pages = (height + 7) / 8;
+	surface->Format = format;
+	surface->Buffer = memory;
+	surface->Dirty = 0;
+
+	memset(surface->Buffer, 0, SURFACE_BUFFER_SIZE(width, height));
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * sets up a surface with memory taken from an arena. Arena memory is only given back by resetting Used
+ */
+static GraphicsReturnType CreateFromArena(SurfaceType * surface, uint32_t width, uint32_t height, uint8_t format, SurfaceArenaType * arena) {
+	uint32_t Size = SURFACE_BUFFER_SIZE(width, height);
+	GraphicsReturnType Result;
+
+	if(!arena || !arena->Memory) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(arena->Used > arena->Size || Size > (arena->Size - arena->Used)) {
+		return BasicGReturned_Error;
+	}
+
+	Result = Create(surface, width, height, format, &arena->Memory[arena->Used], Size);
+
+	if(Result == BasicGReturned_OK) {
+		arena->Used += Size;
+	}
+
+	return Result;
+}
+
+/**
+ * combines a run of page bytes into a surface
+ */
+static void surfaceBlitPage(SurfaceType * surface, int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	int32_t XEnd = x + (int32_t)length;
+	uint8_t * Destination;
+
+	if(!surface || !surface->Buffer || !source || page < 0 || page >= (int32_t)surface->Pages) {
+		return;
+	}
+
+	// don't touch the padding bits under the last row
+	if((uint32_t)page == surface->Pages - 1 && (surface->Height & 7)) {
+		mask &= 0xFF >> (8 - (surface->Height & 7));
+	}
+
+	if(x < 0) {
+		source -= x;
+		x = 0;
+	}
+	if(XEnd > (int32_t)surface->Width) {
+		XEnd = surface->Width;
+	}
+	if(x >= XEnd) {
+		return;
+	}
+
+	Destination = &surface->Buffer[(page * surface->Width) + x];
+
+	switch(operation) {
+		case Raster_Or:
+			for( ; x < XEnd; x++) {
+				*Destination++ |= (*source++ & mask);
+			}
+		break;
+
+		case Raster_AndNot:
+			for( ; x < XEnd; x++) {
+				*Destination++ &= ~(*source++ & mask);
+			}
+		break;
+
+		case Raster_Xor:
+			for( ; x < XEnd; x++) {
+				*Destination++ ^= (*source++ & mask);
+			}
+		break;
+
+		case Raster_Copy:
+		default:
+			for( ; x < XEnd; x++) {
+				*Destination = (*Destination & ~mask) | (*source++ & mask);
+				Destination++;
+			}
+		break;
+	}
+
+	surface->Dirty = 1;
+}
+
+/**
+ * compose writer for surfaces
+ */
+static void composeToSurface(void * destination, int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	surfaceBlitPage((SurfaceType *)destination, x, page, source, length, mask, operation);
+}
+
+/**
+ * compose writer for displays
+ */
+static void composeToDisplay(void * destination, int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	DisplayInterfaceType * Display = (DisplayInterfaceType *)destination;
+	uint32_t Index;
+	uint_fast8_t Bit;
+	uint8_t Value;
+
+	if(Display->BlitPage) {
+		Display->BlitPage(x, page, source, length, mask, operation);
+		return;
+	}
+
+	// drivers without BlitPage get one SetPixel per changed pixel
+	for(Index = 0; Index < length; Index++) {
+		Value = source[Index];
+
+		for(Bit = 0; Bit < 8; Bit++) {
+			if(!(mask & (1 << Bit))) {
+				continue;
+			}
+
+			if(operation == Raster_Copy) {
+				Display->SetPixel(x + Index, (page * 8) + Bit, Value & (1 << Bit));
+			} else if(Value & (1 << Bit)) {
+				Display->SetPixel(x + Index, (page * 8) + Bit, operation == Raster_Or);
+			}
+		}
+	}
+}
+
+/**
+ * combines a rectangle of the source into a destination. Everything is clipped to both
+ */
+static GraphicsReturnType compose(composeBlitType blit, void * destination, uint32_t destinationWidth, uint32_t destinationHeight,
+									int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY,
+									int32_t width, int32_t height, uint_fast8_t operation) {
+	uint8_t Row[SURFACE_ROW_CHUNK];
+	const uint8_t * Low;
+	const uint8_t * High;
+	int32_t Page;
+	int32_t LastPage;
+	int32_t SourceRow;
+	int32_t SourcePage;
+	int32_t Shift;
+	int32_t Column;
+	int32_t Length;
+	int32_t Index;
+	uint_fast8_t Phase;
+	uint8_t Mask;
+
+	// clip to the source
+	if(sourceX < 0) {
+		x -= sourceX;
+		width += sourceX;
+		sourceX = 0;
+	}
+	if(sourceY < 0) {
+		y -= sourceY;
+		height += sourceY;
+		sourceY = 0;
+	}
+	if(sourceX + width > (int32_t)source->Width) {
+		width = source->Width - sourceX;
+	}
+	if(sourceY + height > (int32_t)source->Height) {
+		height = source->Height - sourceY;
+	}
+
+	// clip to the destination
+	if(x < 0) {
+		sourceX -= x;
+		width += x;
+		x = 0;
+	}
+	if(y < 0) {
+		sourceY -= y;
+		height += y;
+		y = 0;
+	}
+	if(x + width > (int32_t)destinationWidth) {
+		width = destinationWidth - x;
+	}
+	if(y + height > (int32_t)destinationHeight) {
+		height = destinationHeight - y;
+	}
+
+	if(width <= 0 || height <= 0) {
+		return BasicGReturned_OK;
+	}
+
+	Shift = y - sourceY;
+	LastPage = (y + height - 1) / 8;
+
+	for(Page = y / 8; Page <= LastPage; Page++) {
+
+		// only the rows inside the rectangle change
+		Mask = 0xFF;
+		if(y > Page * 8) {
+			Mask &= 0xFF << (y - (Page * 8));
+		}
+		if(y + height < (Page + 1) * 8) {
+			Mask &= 0xFF >> (((Page + 1) * 8) - (y + height));
+		}
+
+		// the source row that lands on bit 0 of this page
+		SourceRow = (Page * 8) - Shift;
+		Phase = SourceRow & 7;
+		SourcePage = (SourceRow - (int32_t)Phase) / 8;
+
+		Low = (SourcePage >= 0 && SourcePage < (int32_t)source->Pages) ? &source->Buffer[(SourcePage * source->Width) + sourceX] : NULL;
+		High = (SourcePage + 1 >= 0 && SourcePage + 1 < (int32_t)source->Pages) ? &source->Buffer[((SourcePage + 1) * source->Width) + sourceX] : NULL;
+
+		if(!Phase) {
+			// the rows line up, hand the source row over as it is
+			blit(destination, x, Page, Low, width, Mask, operation);
+			continue;
+		}
+
+		for(Column = 0; Column < width; Column += Length) {
+			Length = width - Column;
+			if(Length > SURFACE_ROW_CHUNK) {
+				Length = SURFACE_ROW_CHUNK;
+			}
+
+			for(Index = 0; Index < Length; Index++) {
+				Row[Index] = (Low ? (Low[Column + Index] >> Phase) : 0) | (High ? (High[Column + Index] << (8 - Phase)) : 0);
+			}
+
+			blit(destination, x + Column, Page, &Row[0], Length, Mask, operation);
+		}
+	}
+
+	return BasicGReturned_OK;
+}
+
+/**
+ * combines part of a surface into another surface
+ *
+ * @param destination the surface to draw into
+ * @param x destination x of the rectangle
+ * @param y destination y of the rectangle
+ * @param source the surface to take the rectangle from. It can't be the destination
+ * @param sourceX source x of the rectangle
+ * @param sourceY source y of the rectangle
+ * @param width rectangle width
+ * @param height rectangle height
+ * @param operation DisplayRasterOpType
+ */
+static GraphicsReturnType Compose(SurfaceType * destination, int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY, int32_t width, int32_t height, uint_fast8_t operation) {
+
+	if(!destination || !destination->Buffer || !source || !source->Buffer) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(destination == source) {
+		return BasicGReturned_Error;
+	}
+
+	return compose(composeToSurface, destination, destination->Width, destination->Height, x, y, source, sourceX, sourceY, width, height, operation);
+}
+
+/**
+ * combines part of a surface into a display's buffer. Drivers without BlitPage can't do Raster_Xor
+ *
+ * @note you will need to flush the display to push the changes to the screen
+ */
+static GraphicsReturnType ComposeToDisplay(DisplayInterfaceType * display, int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY, int32_t width, int32_t height, uint_fast8_t operation) {
+
+	if(!display || !source || !source->Buffer || (!display->BlitPage && !display->SetPixel)) {
+		return RBasicGReturned_InvalidPointer;
+	}
+
+	if(!display->BlitPage && operation == Raster_Xor) {
+		return BasicGReturned_Error;
+	}
+
+	return compose(composeToDisplay, display, display->Width, display->Height, x, y, source, sourceX, sourceY, width, height, operation);
+}
+
+/**
+ * surface display driver functions. They all work on the bound surface
+ */
+static void SurfaceSetPixel(uint32_t x, uint32_t y, uint8_t value) {
+	uint8_t Mask;
+
+	if(!Bound || x >= Bound->Width || y >= Bound->Height) {
+		return;
+	}
+
+	Mask = 0x01 << (y & 7);
+
+	if(value) {
+		Bound->Buffer[x + ((y / 8) * Bound->Width)] |= Mask;
+	} else {
+		Bound->Buffer[x + ((y / 8) * Bound->Width)] &= ~Mask;
+	}
+
+	Bound->Dirty = 1;
+}
+
+static void SurfaceFill(uint8_t value) {
+	if(!Bound) {
+		return;
+	}
+
+	memset(Bound->Buffer, value ? 0xFF : 0x00, Bound->Width * Bound->Pages);
+	Bound->Dirty = 1;
+}
+
+static void SurfaceClear(void) {
+	SurfaceFill(ColourOff);
+}
+
+static void SurfaceReset(uint_fast8_t resetBuffer) {
+	if(resetBuffer) {
+		SurfaceClear();
+	}
+}
+
+static void SurfaceClose(uint_fast8_t cleanScreenFlag) {
+	SurfaceReset(cleanScreenFlag);
+}
+
+static void SurfaceSync(void) {
+	if(!Bound) {
+		return;
+	}
+
+	Bound->Dirty = 0;
+}
+
+static uint_fast8_t SurfaceIsDirty(void) {
+	return Bound ? Bound->Dirty : 0;
+}
+
+static void SurfaceDirectWriteToBuffer(uint8_t * source) {
+	if(!Bound || !source) {
+		return;
+	}
+
+	memcpy(Bound->Buffer, source, Bound->Width * Bound->Pages);
+	Bound->Dirty = 1;
+}
+
+static uint32_t SurfaceGetDisplayBuffer(uint8_t * destinationPointer) {
+	if(!Bound || !destinationPointer) {
+		return 0;
+	}
+
+	memcpy(destinationPointer, Bound->Buffer, Bound->Width * Bound->Pages);
+
+	return Bound->Width * Bound->Pages;
+}
+
+static uint_fast8_t SurfaceGetPixel(uint32_t x, uint32_t y) {
+	if(!Bound || x >= Bound->Width || y >= Bound->Height) {
+		return 0;
+	}
+
+	return (Bound->Buffer[x + ((y / 8) * Bound->Width)] >> (y & 7)) & 0x01;
+}
+
+static uint32_t SurfaceReadPage(int32_t x, int32_t page, uint8_t * destination, uint32_t length) {
+	if(!Bound || !destination || x < 0 || page < 0 || x >= (int32_t)Bound->Width || page >= (int32_t)Bound->Pages) {
+		return 0;
+	}
+
+	if(length > (Bound->Width - x)) {
+		length = Bound->Width - x;
+	}
+
+	memcpy(destination, &Bound->Buffer[(page * Bound->Width) + x], length);
+
+	return length;
+}
+
+static void SurfaceBlitPage(int32_t x, int32_t page, const uint8_t * source, uint32_t length, uint8_t mask, uint_fast8_t operation) {
+	surfaceBlitPage(Bound, x, page, source, length, mask, operation);
+}
+
+static void SurfaceFillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t value) {
+	int32_t XEnd = x + width;
+	int32_t YEnd = y + height;
+	int32_t Page;
+	int32_t Column;
+	uint8_t Mask;
+	uint8_t * Destination;
+
+	if(!Bound) {
+		return;
+	}
+
+	if(x < 0) {
+		x = 0;
+	}
+	if(y < 0) {
+		y = 0;
+	}
+	if(XEnd > (int32_t)Bound->Width) {
+		XEnd = Bound->Width;
+	}
+	if(YEnd > (int32_t)Bound->Height) {
+		YEnd = Bound->Height;
+	}
+	if(x >= XEnd || y >= YEnd) {
+		return;
+	}
+
+	for(Page = y / 8; Page <= (YEnd - 1) / 8; Page++) {
+		Mask = 0xFF;
+		if(y > Page * 8) {
+			Mask &= 0xFF << (y - (Page * 8));
+		}
+		if(YEnd < (Page + 1) * 8) {
+			Mask &= 0xFF >> (((Page + 1) * 8) - YEnd);
+		}
+
+		Destination = &Bound->Buffer[(Page * Bound->Width) + x];
+
+		for(Column = x; Column < XEnd; Column++) {
+			if(value) {
+				*Destination++ |= Mask;
+			} else {
+				*Destination++ &= ~Mask;
+			}
+		}
+	}
+
+	Bound->Dirty = 1;
+}
+
+/**
+ * the display driver that draws into the bound surface
+ */
+static DisplayInterfaceType SurfaceDisplay = {
+	Width: 0,
+	Height: 0,
+	Open: NULL,
+	Reset: SurfaceReset,
+	Close: SurfaceClose,
+	Sync: SurfaceSync,
+	SetPixel: SurfaceSetPixel,
+	directWriteToBuffer: SurfaceDirectWriteToBuffer,
+	Clear: SurfaceClear,
+	Fill: SurfaceFill,
+	GetDisplayBuffer: SurfaceGetDisplayBuffer,
+	setBrightness: NULL,
+	IsDirty: SurfaceIsDirty,
+	FillRect: SurfaceFillRect,
+	BlitPage: SurfaceBlitPage,
+	GetPixel: SurfaceGetPixel,
+	ReadPage: SurfaceReadPage
+};
+
+/**
+ * makes the surface display driver draw into the given surface
+ *
+ * @return the surface display driver or NULL if the surface isn't set up
+ */
+static DisplayInterfaceType * Bind(SurfaceType * surface) {
+
+	if(!surface || !surface->Buffer) {
+		return NULL;
+	}
+
+	Bound = surface;
+	SurfaceDisplay.Width = surface->Width;
+	SurfaceDisplay.Height = surface->Height;
+
+	return &SurfaceDisplay;
+}
+
+/**
+ * This is our surface instance
+ */
+SurfaceInterfaceType Surface = {
+	Create: Create,
+	CreateFromArena: CreateFromArena,
+	Bind: Bind,
+	Compose: Compose,
+	ComposeToDisplay: ComposeToDisplay
+};
@@ -0,0 +1,64 @@
+/*
+ * surface.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __SURFACE_H__
+#define __SURFACE_H__
+
+	#include "basicGraphics.h"
+
+	/**
+	 * defines the pixel formats a surface can have
+	 */
+	typedef enum {
+		Surface_PageMonochrome = 0	///< 1 bit per pixel, 8 vertical pixels per byte like the SSD1306 GDDRAM
+	} SurfaceFormatType;
+
+	/**
+	 * defines an off screen drawing surface
+	 */
+	typedef struct SurfaceType {
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t Pages;				///< rows of bytes, Height rounded up to 8
+		uint8_t Format;				///< SurfaceFormatType
+		uint8_t Dirty;				///< set by drawing, cleared by Sync
+		uint8_t * Buffer;			///< Width * Pages bytes
+	} SurfaceType;
+
+	/**
+	 * defines a simple arena that surfaces can take their memory from
+	 */
+	typedef struct SurfaceArenaType {
+		uint8_t * Memory;
+		uint32_t Size;
+		uint32_t Used;
+	} SurfaceArenaType;
+
+	/**
+	 * works out the number of bytes a surface needs
+	 */
+	#define SURFACE_BUFFER_SIZE(width, height) ((width) * (((height) + 7) / 8))
+
+	/**
+	 * defines the surface interface
+	 */
+	typedef struct SurfaceInterfaceType {
+		/** sets up a surface on the given memory, which must be at least SURFACE_BUFFER_SIZE bytes **/
+		GraphicsReturnType (*Create)(SurfaceType * surface, uint32_t width, uint32_t height, uint8_t format, uint8_t * memory, uint32_t size);
+		/** sets up a surface with memory taken from an arena **/
+		GraphicsReturnType (*CreateFromArena)(SurfaceType * surface, uint32_t width, uint32_t height, uint8_t format, SurfaceArenaType * arena);
+		/** returns a display driver that draws into the surface, for GraphicsInstance.SetTarget. There is one such driver, so it draws into the surface bound last **/
+		DisplayInterfaceType * (*Bind)(SurfaceType * surface);
+		/** combines part of a surface into another surface **/
+		GraphicsReturnType (*Compose)(SurfaceType * destination, int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY, int32_t width, int32_t height, uint_fast8_t operation);
+		/** combines part of a surface into a display driver's buffer **/
+		GraphicsReturnType (*ComposeToDisplay)(DisplayInterfaceType * display, int32_t x, int32_t y, const SurfaceType * source, int32_t sourceX, int32_t sourceY, int32_t width, int32_t height, uint_fast8_t operation);
+	} SurfaceInterfaceType;
+
+	extern SurfaceInterfaceType Surface;
+
+#endif /* __SURFACE_H__ */
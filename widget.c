@@ -0,0 +1,941 @@
+/*
+ * widget.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * A small retained widget layer on top of GraphicsInstance.
+ *
+ * Widgets come from a fixed pool and remember their bounds and content. Changing a widget only
+ * marks it dirty, and Widgets.Step then clears and redraws the dirty widgets (and any widget they
+ * overlap) and sends just their rectangles with the driver's SyncRegion. Drivers without
+ * SyncRegion get a normal flush. Widgets are drawn in pool order, so later widgets are on top.
+ *
+ * Widget content isn't clipped, so it has to fit inside the widget's bounds.
+ *
+ * Strip charts are the exception to redrawing in full. New columns only move the plot along with
+ * the driver's ReadPage and BlitPage, one page row at a time, and draw the new columns as vertical
+ * spans, so a new sample costs the plot height rather than its area.
+ */
+#include "widget.h"
+
+/**
+ * the number of needle positions across the gauge's half circle
+ */
+#define WIDGET_GAUGE_STEPS 32
+
+/**
+ * defines a rectangle
+ */
+typedef struct {
+	int32_t X;
+	int32_t Y;
+	int32_t Width;
+	int32_t Height;
+} widgetRectType;
+
+/**
+ * defines a list of rectangles that merges them once it is full
+ */
+typedef struct {
+	widgetRectType Rect[WIDGET_MAX_DAMAGE];
+	uint_fast8_t Count;
+} widgetRectListType;
+
+/**
+ * sine of a quarter circle in WIDGET_GAUGE_STEPS / 2 steps, 1.0 = 16384
+ */
+static const int16_t GaugeSine[(WIDGET_GAUGE_STEPS / 2) + 1] = {
+	0, 1606, 3196, 4756, 6270, 7723, 9102, 10394, 11585,
+	12665, 13623, 14449, 15137, 15679, 16069, 16305, 16384
+};
+
+/**
+ * the widget pool
+ */
+static WidgetType Pool[WIDGET_POOL_SIZE];
+
+/**
+ * areas left behind by widgets that moved, were hidden or destroyed
+ */
+static widgetRectListType Erase;
+
+/**
+ * areas to send on the next step
+ */
+static widgetRectListType Damage;
+
+/**
+ * @return true if the rectangles overlap
+ */
+static uint_fast8_t rectIntersects(const widgetRectType * first, const widgetRectType * second) {
+	return first->X < second->X + second->Width && second->X < first->X + first->Width &&
+			first->Y < second->Y + second->Height && second->Y < first->Y + first->Height;
+}
+
+/**
+ * grows destination to also cover source
+ */
+static void rectUnion(widgetRectType * destination, const widgetRectType * source) {
+	int32_t XEnd = destination->X + destination->Width;
+	int32_t YEnd = destination->Y + destination->Height;
+
+	if(source->X + source->Width > XEnd) {
+		XEnd = source->X + source->Width;
+	}
+	if(source->Y + source->Height > YEnd) {
+		YEnd = source->Y + source->Height;
+	}
+	if(source->X < destination->X) {
+		destination->X = source->X;
+	}
+	if(source->Y < destination->Y) {
+		destination->Y = source->Y;
+	}
+
+	destination->Width = XEnd - destination->X;
+	destination->Height = YEnd - destination->Y;
+}
+
+/**
+ * adds a rectangle to a list. It is merged with a rectangle it overlaps, or with the one that grows
+ * the least when the list is full
+ */
+static void addRect(widgetRectListType * list, const widgetRectType * rect) {
+	widgetRectType Merged;
+	int64_t Growth;
+	int64_t BestGrowth = INT64_MAX;
+	uint_fast8_t Best = 0;
+	uint_fast8_t Index;
+
+	if(rect->Width <= 0 || rect->Height <= 0) {
+		return;
+	}
+
+	for(Index = 0; Index < list->Count; Index++) {
+		if(rectIntersects(&list->Rect[Index], rect)) {
+			rectUnion(&list->Rect[Index], rect);
+			return;
+		}
+	}
+
+	if(list->Count < WIDGET_MAX_DAMAGE) {
+		list->Rect[list->Count++] = *rect;
+		return;
+	}
+
+	for(Index = 0; Index < list->Count; Index++) {
+		Merged = list->Rect[Index];
+		rectUnion(&Merged, rect);
+		Growth = ((int64_t)Merged.Width * Merged.Height) - ((int64_t)list->Rect[Index].Width * list->Rect[Index].Height);
+
+		if(Growth < BestGrowth) {
+			BestGrowth = Growth;
+			Best = Index;
+		}
+	}
+
+	rectUnion(&list->Rect[Best], rect);
+}
+
+/**
+ * @return the widget's bounds
+ */
+static widgetRectType widgetRect(const WidgetType * widget) {
+	widgetRectType Rect = {X: widget->X, Y: widget->Y, Width: widget->Width, Height: widget->Height};
+
+	return Rect;
+}
+
+/**
+ * sets or clears a rectangle
+ */
+static void fillRect(DisplayInterfaceType * driver, int32_t x, int32_t y, int32_t width, int32_t height, uint_fast8_t colour) {
+	int32_t XIndex;
+	int32_t YIndex;
+
+	if(driver->FillRect) {
+		driver->FillRect(x, y, width, height, colour);
+		return;
+	}
+
+	for(YIndex = y; YIndex < y + height; YIndex++) {
+		for(XIndex = x; XIndex < x + width; XIndex++) {
+			driver->SetPixel(XIndex, YIndex, colour);
+		}
+	}
+}
+
+/**
+ * works out how far the font's glyphs reach above and below the baseline
+ */
+static void fontExtents(const GFXfont * font, int32_t * ascent, int32_t * descent) {
+	const GFXglyph * Glyph;
+	uint32_t Index;
+
+	*ascent = 0;
+	*descent = 0;
+
+	for(Index = 0; Index <= (uint32_t)(font->last - font->first); Index++) {
+		Glyph = &font->glyph[Index];
+
+		if(-Glyph->yOffset > *ascent) {
+			*ascent = -Glyph->yOffset;
+		}
+		if(Glyph->yOffset + Glyph->height > *descent) {
+			*descent = Glyph->yOffset + Glyph->height;
+		}
+	}
+}
+
+/**
+ * works out how far along the range a value is, scaled to 0 to full
+ */
+static int32_t scaleValue(const WidgetType * widget, int32_t value, int32_t full) {
+	int64_t Range = (int64_t)widget->Maximum - widget->Minimum;
+	int64_t Position = (int64_t)value - widget->Minimum;
+
+	if(Range <= 0 || Position <= 0) {
+		return 0;
+	}
+
+	if(Position >= Range) {
+		return full;
+	}
+
+	return (int32_t)((Position * full) / Range);
+}
+
+/**
+ * sine and cosine of the gauge angle, 0 = pointing left and WIDGET_GAUGE_STEPS * 256 = pointing right
+ */
+static void gaugeAngle(int32_t position, int32_t * sine, int32_t * cosine) {
+	int32_t Step = position >> 8;
+	int32_t Fraction = position & 0xFF;
+	int32_t Sine[2];
+	int32_t Cosine[2];
+	uint_fast8_t Index;
+
+	for(Index = 0; Index < 2; Index++, Step++) {
+		if(Step > WIDGET_GAUGE_STEPS) {
+			Step = WIDGET_GAUGE_STEPS;
+		}
+
+		if(Step <= WIDGET_GAUGE_STEPS / 2) {
+			Sine[Index] = GaugeSine[Step];
+			Cosine[Index] = GaugeSine[(WIDGET_GAUGE_STEPS / 2) - Step];
+		} else {
+			Sine[Index] = GaugeSine[WIDGET_GAUGE_STEPS - Step];
+			Cosine[Index] = -GaugeSine[Step - (WIDGET_GAUGE_STEPS / 2)];
+		}
+	}
+
+	*sine = Sine[0] + (((Sine[1] - Sine[0]) * Fraction) / 256);
+	*cosine = Cosine[0] + (((Cosine[1] - Cosine[0]) * Fraction) / 256);
+}
+
+/**
+ * draws a half circle gauge with its needle
+ */
+static void drawGauge(const WidgetType * widget) {
+	int32_t CenterX = widget->X + (widget->Width / 2);
+	int32_t CenterY = widget->Y + widget->Height - 1;
+	int32_t Radius = (widget->Width - 1) / 2;
+	int32_t Sine;
+	int32_t Cosine;
+	int32_t LastX;
+	int32_t LastY;
+	int32_t NextX;
+	int32_t NextY;
+	int32_t Step;
+
+	if(Radius > widget->Height - 1) {
+		Radius = widget->Height - 1;
+	}
+
+	if(Radius < 2) {
+		return;
+	}
+
+	LastX = CenterX - Radius;
+	LastY = CenterY;
+
+	for(Step = 1; Step <= WIDGET_GAUGE_STEPS; Step++) {
+		gaugeAngle(Step << 8, &Sine, &Cosine);
+		NextX = CenterX - ((Radius * Cosine) / 16384);
+		NextY = CenterY - ((Radius * Sine) / 16384);
+		GraphicsInstance.drawLine(LastX, LastY, NextX, NextY, 1);
+		LastX = NextX;
+		LastY = NextY;
+	}
+
+	gaugeAngle(scaleValue(widget, widget->Value, WIDGET_GAUGE_STEPS * 256), &Sine, &Cosine);
+	GraphicsInstance.drawLine(CenterX, CenterY, CenterX - (((Radius - 2) * Cosine) / 16384), CenterY - (((Radius - 2) * Sine) / 16384), 1);
+}
+
+/**
+ * draws a scrolling list with the selected item inverted
+ */
+static void drawList(DisplayInterfaceType * driver, WidgetType * widget, const GFXfont * font) {
+	const uint8_t * const * Items = (const uint8_t * const *)widget->Data;
+	int32_t RowHeight;
+	int32_t Rows;
+	int32_t Ascent;
+	int32_t Descent;
+	int32_t Row;
+	uint32_t Item;
+
+	fontExtents(font, &Ascent, &Descent);
+	RowHeight = Ascent + Descent;
+
+	if(!Items || !widget->Count || RowHeight <= 0) {
+		return;
+	}
+
+	Rows = widget->Height / RowHeight;
+	if(Rows < 1) {
+		Rows = 1;
+	}
+
+	// keep the selected item in view
+	if((uint32_t)widget->Value < widget->First) {
+		widget->First = widget->Value;
+	} else if((uint32_t)widget->Value >= widget->First + Rows) {
+		widget->First = widget->Value - Rows + 1;
+	}
+
+	for(Row = 0; Row < Rows; Row++) {
+		Item = widget->First + Row;
+
+		if(Item >= widget->Count) {
+			break;
+		}
+
+		if((int32_t)Item == widget->Value) {
+			fillRect(driver, widget->X, widget->Y + (Row * RowHeight), widget->Width, RowHeight, 1);
+		}
+
+		GraphicsInstance.WriteString((uint8_t *)Items[Item], widget->X + 1, widget->Y + (Row * RowHeight) + Ascent, (int32_t)Item != widget->Value, font);
+	}
+}
+
+/**
+ * @return the area of a strip chart that is plotted on
+ */
+static widgetRectType stripChartPlot(const WidgetType * widget) {
+	widgetRectType Rect = widgetRect(widget);
+
+	if(widget->Flags & Widget_Border) {
+		Rect.X++;
+		Rect.Y++;
+		Rect.Width -= 2;
+		Rect.Height -= 2;
+	}
+
+	return Rect;
+}
+
+/**
+ * draws one strip chart column as a vertical span. The span reaches to the column before it so
+ * that steep changes still make a joined up trace
+ *
+ * @param age 0 for the newest column
+ * @param x where to draw it
+ */
+static void drawStripColumn(DisplayInterfaceType * driver, const WidgetType * widget, const widgetRectType * plot, uint32_t age, int32_t x) {
+	const WidgetStripChartType * Chart = (const WidgetStripChartType *)widget->Data;
+	const WidgetStripColumnType * Column = &Chart->Columns[(Chart->Newest + Chart->Size - age) % Chart->Size];
+	const WidgetStripColumnType * Previous;
+	int32_t Bottom = plot->Y + plot->Height - 1;
+	int32_t Low = Column->Minimum;
+	int32_t High = Column->Maximum;
+
+	if((age + 1) < Chart->Filled && (age + 1) < Chart->Size) {
+		Previous = &Chart->Columns[(Chart->Newest + Chart->Size - age - 1) % Chart->Size];
+
+		if(Previous->Maximum < Low) {
+			Low = Previous->Maximum;
+		}
+		if(Previous->Minimum > High) {
+			High = Previous->Minimum;
+		}
+	}
+
+	Low = Bottom - scaleValue(widget, Low, plot->Height - 1);
+	High = Bottom - scaleValue(widget, High, plot->Height - 1);
+
+	fillRect(driver, x, High, 1, Low - High + 1, 1);
+}
+
+/**
+ * draws every column of a strip chart that fits
+ */
+static void drawStripChart(DisplayInterfaceType * driver, const WidgetType * widget) {
+	WidgetStripChartType * Chart = (WidgetStripChartType *)widget->Data;
+	widgetRectType Plot = stripChartPlot(widget);
+	uint32_t Age;
+
+	if(!Chart || Plot.Width <= 0 || Plot.Height <= 0) {
+		return;
+	}
+
+	for(Age = 0; Age < Chart->Filled && Age < Chart->Size && (int32_t)Age < Plot.Width; Age++) {
+		drawStripColumn(driver, widget, &Plot, Age, Plot.X + Plot.Width - 1 - Age);
+	}
+
+	Chart->Scroll = 0;
+}
+
+/**
+ * @return true if a strip chart's new columns can be added by moving the plot along
+ */
+static uint_fast8_t canScrollStripChart(DisplayInterfaceType * driver, const WidgetType * widget) {
+	const WidgetStripChartType * Chart = (const WidgetStripChartType *)widget->Data;
+	widgetRectType Plot = stripChartPlot(widget);
+
+	// the ring has to hold every column shown and the one before, which the oldest is joined to
+	return driver->ReadPage && driver->BlitPage && Chart && (int32_t)Chart->Scroll < Plot.Width && (int32_t)Chart->Size > Plot.Width &&
+			Plot.X >= 0 && Plot.Y >= 0 && Plot.Height > 0 &&
+			(Plot.X + Plot.Width) <= (int32_t)driver->Width && (Plot.Y + Plot.Height) <= (int32_t)driver->Height;
+}
+
+/**
+ * moves a strip chart's plot left by the new columns and draws just those
+ */
+static void scrollStripChart(DisplayInterfaceType * driver, WidgetType * widget) {
+	WidgetStripChartType * Chart = (WidgetStripChartType *)widget->Data;
+	widgetRectType Plot = stripChartPlot(widget);
+	int32_t Scroll = Chart->Scroll;
+	int32_t Keep = Plot.Width - Scroll;
+	int32_t LastPage = (Plot.Y + Plot.Height - 1) / 8;
+	int32_t Page;
+	int32_t Done;
+	uint32_t Length;
+	uint8_t Bytes[64];
+	uint8_t Mask;
+
+	for(Page = Plot.Y / 8; Page <= LastPage; Page++) {
+		Mask = 0xFF;
+
+		if(Page == Plot.Y / 8) {
+			Mask &= 0xFF << (Plot.Y & 7);
+		}
+		if(Page == LastPage) {
+			Mask &= 0xFF >> (7 - ((Plot.Y + Plot.Height - 1) & 7));
+		}
+
+		// the source is always right of what has been written, so going left to right is safe
+		for(Done = 0; Done < Keep; Done += Length) {
+			Length = Keep - Done;
+			if(Length > sizeof(Bytes)) {
+				Length = sizeof(Bytes);
+			}
+
+			Length = driver->ReadPage(Plot.X + Scroll + Done, Page, &Bytes[0], Length);
+			if(!Length) {
+				break;
+			}
+
+			driver->BlitPage(Plot.X + Done, Page, &Bytes[0], Length, Mask, Raster_Copy);
+		}
+	}
+
+	fillRect(driver, Plot.X + Keep, Plot.Y, Scroll, Plot.Height, 0);
+
+	for(Done = 0; Done < Scroll && Done < (int32_t)Chart->Filled; Done++) {
+		drawStripColumn(driver, widget, &Plot, Done, Plot.X + Plot.Width - 1 - Done);
+	}
+
+	Chart->Scroll = 0;
+}
+
+/**
+ * draws a widget. Its area has already been cleared
+ */
+static void drawWidget(DisplayInterfaceType * driver, WidgetType * widget) {
+	const GFXfont * Font = widget->Font ? widget->Font : GraphicsInstance.GetFont();
+	basicStringBoundType Bounds;
+	const int32_t * Series;
+	int32_t Baseline = widget->Y;
+	int32_t Ascent;
+	int32_t Descent;
+	int32_t Size;
+	uint32_t Index;
+
+	// text sits in the middle of the widget
+	if(Font) {
+		fontExtents(Font, &Ascent, &Descent);
+		Baseline += Ascent;
+
+		if(widget->Height > Ascent + Descent) {
+			Baseline += (widget->Height - (Ascent + Descent)) / 2;
+		}
+	}
+
+	switch(widget->Kind) {
+		case Widget_Label:
+			if(!Font || !widget->Data) {
+				break;
+			}
+
+			GraphicsInstance.GetStringBounds((uint8_t *)widget->Data, (GFXfont *)Font, &Bounds);
+			GraphicsInstance.getStringJustificationPos(&Bounds, widget->Format, widget->Width, 0);
+			GraphicsInstance.WriteString((uint8_t *)widget->Data, widget->X + Bounds.x, Baseline, 1, Font);
+		break;
+
+		case Widget_Value:
+			if(!Font) {
+				break;
+			}
+
+			GraphicsInstance.WriteFixed(widget->Value, widget->Decimals,
+					(widget->Format & Number_RightAlign) ? widget->X + widget->Width : widget->X,
+					Baseline, widget->Digits, widget->Format & ~Number_ClearField, 1, Font);
+		break;
+
+		case Widget_ProgressBar:
+			GraphicsInstance.drawRectagle(widget->X, widget->Y, widget->X + widget->Width - 1, widget->Y + widget->Height - 1, 1, 0);
+			fillRect(driver, widget->X + 2, widget->Y + 2, scaleValue(widget, widget->Value, widget->Width - 4), widget->Height - 4, 1);
+		break;
+
+		case Widget_BarGraph:
+			Series = (const int32_t *)widget->Data;
+
+			if(!Series || !widget->Count) {
+				break;
+			}
+
+			Size = widget->Width / widget->Count;
+			if(Size < 1) {
+				Size = 1;
+			}
+
+			for(Index = 0; Index < widget->Count && (int32_t)(Index * Size) < widget->Width; Index++) {
+				int32_t BarHeight = scaleValue(widget, Series[Index], widget->Height);
+
+				// leave a one pixel gap between bars that are wide enough
+				fillRect(driver, widget->X + (Index * Size), widget->Y + widget->Height - BarHeight, Size > 2 ? Size - 1 : Size, BarHeight, 1);
+			}
+		break;
+
+		case Widget_Gauge:
+			drawGauge(widget);
+		break;
+
+		case Widget_Icon:
+			if(widget->Data) {
+				GraphicsInstance.drawIcon(widget->X, widget->Y, widget->DataHeight, widget->Count, 1, (uint32_t *)widget->Data);
+			}
+		break;
+
+		case Widget_List:
+			if(Font) {
+				drawList(driver, widget, Font);
+			}
+		break;
+
+		case Widget_StripChart:
+			drawStripChart(driver, widget);
+		break;
+
+		default:
+		break;
+	}
+
+	if((widget->Flags & Widget_Border) && widget->Kind != Widget_ProgressBar) {
+		GraphicsInstance.drawRectagle(widget->X, widget->Y, widget->X + widget->Width - 1, widget->Y + widget->Height - 1, 1, 0);
+	}
+}
+
+/**
+ * marks a widget for redraw
+ */
+static void Invalidate(WidgetType * widget) {
+	if(!widget || widget->Kind == Widget_Free) {
+		return;
+	}
+
+	widget->Flags |= Widget_Dirty;
+}
+
+/**
+ * remembers the area a visible widget covers so it gets cleared on the next step
+ */
+static void eraseWidget(WidgetType * widget) {
+	widgetRectType Rect = widgetRect(widget);
+
+	if(widget->Flags & Widget_Visible) {
+		addRect(&Erase, &Rect);
+	}
+}
+
+static WidgetType * Create(uint8_t kind, int32_t x, int32_t y, int32_t width, int32_t height) {
+	uint32_t Index;
+	WidgetType * Widget;
+
+	if(kind == Widget_Free || kind > Widget_StripChart) {
+		return NULL;
+	}
+
+	for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+		Widget = &Pool[Index];
+
+		if(Widget->Kind == Widget_Free) {
+			memset(Widget, 0, sizeof(WidgetType));
+			Widget->Kind = kind;
+			Widget->Flags = Widget_Visible | Widget_Dirty;
+			Widget->X = x;
+			Widget->Y = y;
+			Widget->Width = width;
+			Widget->Height = height;
+			Widget->Maximum = 100;
+
+			return Widget;
+		}
+	}
+
+	return NULL;
+}
+
+static void Destroy(WidgetType * widget) {
+	if(!widget || widget->Kind == Widget_Free) {
+		return;
+	}
+
+	eraseWidget(widget);
+	widget->Kind = Widget_Free;
+	widget->Flags = 0;
+}
+
+static void DestroyAll(void) {
+	uint32_t Index;
+
+	for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+		Destroy(&Pool[Index]);
+	}
+}
+
+static void SetBounds(WidgetType * widget, int32_t x, int32_t y, int32_t width, int32_t height) {
+	if(!widget || widget->Kind == Widget_Free) {
+		return;
+	}
+
+	if(widget->X == x && widget->Y == y && widget->Width == width && widget->Height == height) {
+		return;
+	}
+
+	eraseWidget(widget);
+
+	widget->X = x;
+	widget->Y = y;
+	widget->Width = width;
+	widget->Height = height;
+	widget->Flags |= Widget_Dirty;
+}
+
+static void SetVisible(WidgetType * widget, uint_fast8_t visible) {
+	if(!widget || widget->Kind == Widget_Free || !visible == !(widget->Flags & Widget_Visible)) {
+		return;
+	}
+
+	if(visible) {
+		widget->Flags |= Widget_Visible | Widget_Dirty;
+	} else {
+		eraseWidget(widget);
+		widget->Flags &= ~(Widget_Visible | Widget_Dirty);
+	}
+}
+
+static void SetFont(WidgetType * widget, const GFXfont * font) {
+	if(!widget || widget->Font == font) {
+		return;
+	}
+
+	widget->Font = font;
+	Invalidate(widget);
+}
+
+static void SetText(WidgetType * widget, const uint8_t * text, uint_fast8_t justification) {
+	if(!widget || (widget->Data == text && widget->Format == justification)) {
+		return;
+	}
+
+	widget->Data = text;
+	widget->Format = justification;
+	Invalidate(widget);
+}
+
+static void SetValue(WidgetType * widget, int32_t value) {
+	if(!widget) {
+		return;
+	}
+
+	if(widget->Kind == Widget_List) {
+		if(value >= (int32_t)widget->Count) {
+			value = widget->Count - 1;
+		}
+		if(value < 0) {
+			value = 0;
+		}
+	}
+
+	if(widget->Value == value) {
+		return;
+	}
+
+	widget->Value = value;
+	Invalidate(widget);
+}
+
+static void SetRange(WidgetType * widget, int32_t minimum, int32_t maximum) {
+	if(!widget || (widget->Minimum == minimum && widget->Maximum == maximum)) {
+		return;
+	}
+
+	widget->Minimum = minimum;
+	widget->Maximum = maximum;
+	Invalidate(widget);
+}
+
+static void SetFormat(WidgetType * widget, uint_fast8_t digits, uint_fast8_t decimals, uint_fast8_t flags) {
+	if(!widget || (widget->Digits == digits && widget->Decimals == decimals && widget->Format == flags)) {
+		return;
+	}
+
+	widget->Digits = digits;
+	widget->Decimals = decimals;
+	widget->Format = flags;
+	Invalidate(widget);
+}
+
+static void SetSeries(WidgetType * widget, const int32_t * values, uint32_t count) {
+	if(!widget) {
+		return;
+	}
+
+	widget->Data = values;
+	widget->Count = count;
+	Invalidate(widget);
+}
+
+static void SetIcon(WidgetType * widget, const uint32_t * bitmap, uint32_t width, uint32_t height) {
+	if(!widget || (widget->Data == bitmap && widget->Count == width && widget->DataHeight == height)) {
+		return;
+	}
+
+	widget->Data = bitmap;
+	widget->Count = width;
+	widget->DataHeight = height;
+	Invalidate(widget);
+}
+
+static void SetItems(WidgetType * widget, const uint8_t * const * items, uint32_t count) {
+	if(!widget) {
+		return;
+	}
+
+	widget->Data = items;
+	widget->Count = count;
+	widget->First = 0;
+
+	if(widget->Value >= (int32_t)count) {
+		widget->Value = count ? count - 1 : 0;
+	}
+
+	Invalidate(widget);
+}
+
+static void SetStripChart(WidgetType * widget, WidgetStripChartType * chart, WidgetStripColumnType * columns, uint32_t size, uint32_t decimation) {
+	if(!widget || widget->Kind != Widget_StripChart || !chart || !columns || !size) {
+		return;
+	}
+
+	memset(chart, 0, sizeof(WidgetStripChartType));
+	chart->Columns = columns;
+	chart->Size = size;
+	chart->Decimation = decimation ? decimation : 1;
+
+	widget->Data = chart;
+	Invalidate(widget);
+}
+
+/**
+ * adds a sample to the column being built. Once it has Decimation samples the column joins the
+ * plot with the lowest and highest of them
+ */
+static void AddSample(WidgetType * widget, int32_t value) {
+	WidgetStripChartType * Chart;
+
+	if(!widget || widget->Kind != Widget_StripChart || !widget->Data) {
+		return;
+	}
+
+	Chart = (WidgetStripChartType *)widget->Data;
+
+	if(!Chart->Samples || value < Chart->Low) {
+		Chart->Low = value;
+	}
+	if(!Chart->Samples || value > Chart->High) {
+		Chart->High = value;
+	}
+
+	if(++Chart->Samples < Chart->Decimation) {
+		return;
+	}
+
+	Chart->Newest = (Chart->Newest + 1) % Chart->Size;
+	Chart->Columns[Chart->Newest].Minimum = Chart->Low;
+	Chart->Columns[Chart->Newest].Maximum = Chart->High;
+	Chart->Samples = 0;
+
+	if(Chart->Filled < Chart->Size) {
+		Chart->Filled++;
+	}
+
+	Chart->Scroll++;
+}
+
+/**
+ * redraws the invalidated widgets and sends their rectangles to the display
+ *
+ * @return the number of widgets that were redrawn
+ */
+static uint32_t Step(void) {
+	DisplayInterfaceType * Driver = GraphicsInstance.SetTarget(NULL);
+	widgetRectType Rect;
+	uint_fast8_t Changed;
+	uint32_t Redrawn = 0;
+	uint32_t Index;
+	uint32_t Other;
+
+	if(!Driver || !Driver->SetPixel) {
+		return 0;
+	}
+
+	// strip charts that can't be moved along are drawn again
+	for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+		if(Pool[Index].Kind == Widget_StripChart && Pool[Index].Data && ((const WidgetStripChartType *)Pool[Index].Data)->Scroll &&
+				!canScrollStripChart(Driver, &Pool[Index])) {
+			Pool[Index].Flags |= Widget_Dirty;
+		}
+	}
+
+	// anything that sat under an erased area has to be drawn again
+	for(Other = 0; Other < Erase.Count; Other++) {
+		for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+			Rect = widgetRect(&Pool[Index]);
+
+			if((Pool[Index].Flags & Widget_Visible) && rectIntersects(&Rect, &Erase.Rect[Other])) {
+				Pool[Index].Flags |= Widget_Dirty;
+			}
+		}
+	}
+
+	// and so does anything that overlaps a widget that is redrawn
+	do {
+		Changed = 0;
+
+		for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+			if((Pool[Index].Flags & (Widget_Visible | Widget_Dirty)) != (Widget_Visible | Widget_Dirty)) {
+				continue;
+			}
+
+			Rect = widgetRect(&Pool[Index]);
+
+			for(Other = 0; Other < WIDGET_POOL_SIZE; Other++) {
+				widgetRectType OtherRect = widgetRect(&Pool[Other]);
+
+				if((Pool[Other].Flags & (Widget_Visible | Widget_Dirty)) == Widget_Visible && rectIntersects(&Rect, &OtherRect)) {
+					Pool[Other].Flags |= Widget_Dirty;
+					Changed = 1;
+				}
+			}
+		}
+	} while(Changed);
+
+	// clear everything first so that overlapping widgets don't wipe each other out
+	for(Index = 0; Index < Erase.Count; Index++) {
+		fillRect(Driver, Erase.Rect[Index].X, Erase.Rect[Index].Y, Erase.Rect[Index].Width, Erase.Rect[Index].Height, 0);
+		addRect(&Damage, &Erase.Rect[Index]);
+	}
+
+	Erase.Count = 0;
+
+	for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+		if((Pool[Index].Flags & (Widget_Visible | Widget_Dirty)) == (Widget_Visible | Widget_Dirty)) {
+			Rect = widgetRect(&Pool[Index]);
+			fillRect(Driver, Rect.X, Rect.Y, Rect.Width, Rect.Height, 0);
+			addRect(&Damage, &Rect);
+		}
+	}
+
+	for(Index = 0; Index < WIDGET_POOL_SIZE; Index++) {
+		if(!(Pool[Index].Flags & Widget_Dirty)) {
+			// strip charts with new columns only need them added
+			if(Pool[Index].Kind == Widget_StripChart && (Pool[Index].Flags & Widget_Visible) &&
+					Pool[Index].Data && ((const WidgetStripChartType *)Pool[Index].Data)->Scroll) {
+				Rect = stripChartPlot(&Pool[Index]);
+				scrollStripChart(Driver, &Pool[Index]);
+				addRect(&Damage, &Rect);
+				Redrawn++;
+			}
+			continue;
+		}
+
+		Pool[Index].Flags &= ~Widget_Dirty;
+
+		if(Pool[Index].Flags & Widget_Visible) {
+			drawWidget(Driver, &Pool[Index]);
+			Redrawn++;
+		}
+	}
+
+	if(!Damage.Count) {
+		return Redrawn;
+	}
+
+	if(!Driver->SyncRegion) {
+		GraphicsInstance.Flush();
+	} else {
+		for(Index = 0; Index < Damage.Count; Index++) {
+			Driver->SyncRegion(Damage.Rect[Index].X, Damage.Rect[Index].Y, Damage.Rect[Index].Width, Damage.Rect[Index].Height);
+		}
+	}
+
+	Damage.Count = 0;
+
+	return Redrawn;
+}
+
+/**
+ * adds an area the application drew itself to the next step's flush
+ */
+static void AddDamage(int32_t x, int32_t y, int32_t width, int32_t height) {
+	widgetRectType Rect = {X: x, Y: y, Width: width, Height: height};
+
+	addRect(&Damage, &Rect);
+}
+
+/**
+ * This is our widget instance
+ */
+WidgetInterfaceType Widgets = {
+	Create: Create,
+	Destroy: Destroy,
+	DestroyAll: DestroyAll,
+	SetBounds: SetBounds,
+	SetVisible: SetVisible,
+	SetFont: SetFont,
+	SetText: SetText,
+	SetValue: SetValue,
+	SetRange: SetRange,
+	SetFormat: SetFormat,
+	SetSeries: SetSeries,
+	SetIcon: SetIcon,
+	SetItems: SetItems,
+	SetStripChart: SetStripChart,
+	AddSample: AddSample,
+	Invalidate: Invalidate,
+	AddDamage: AddDamage,
+	Step: Step
+};
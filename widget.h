@@ -0,0 +1,133 @@
+/*
+ * widget.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ */
+
+#ifndef __WIDGET_H__
+#define __WIDGET_H__
+
+	#include "basicGraphics.h"
+
+	/**
+	 * defines how many widgets can exist at the same time
+	 */
+	#ifndef WIDGET_POOL_SIZE
+		#define WIDGET_POOL_SIZE 32
+	#endif
+
+	/**
+	 * defines how many separate rectangles a frame can flush before they are merged into one
+	 */
+	#ifndef WIDGET_MAX_DAMAGE
+		#define WIDGET_MAX_DAMAGE 8
+	#endif
+
+	/**
+	 * defines the widget kinds
+	 */
+	typedef enum {
+		Widget_Free = 0,
+		Widget_Label,			///< a line of text
+		Widget_Value,			///< a number, see WriteFixed
+		Widget_ProgressBar,		///< a horizontal bar filled from Minimum to Value
+		Widget_BarGraph,		///< one vertical bar per value of a series
+		Widget_Gauge,			///< a half circle dial with a needle
+		Widget_Icon,			///< a drawIcon bitmap
+		Widget_List,			///< a scrolling list of text items with one selected
+		Widget_StripChart		///< a rolling trend plot, the newest sample on the right
+	} WidgetKindType;
+
+	/**
+	 * defines the widget flags
+	 */
+	typedef enum {
+		Widget_Visible = 0x01,
+		Widget_Dirty = 0x02,
+		Widget_Border = 0x04		///< draw a frame around the widget
+	} WidgetFlagType;
+
+	/**
+	 * defines a widget. Use the Widgets functions to change it so that it gets redrawn
+	 */
+	typedef struct WidgetType {
+		uint8_t Kind;				///< WidgetKindType
+		uint8_t Flags;				///< WidgetFlagType
+		int32_t X;
+		int32_t Y;
+		int32_t Width;
+		int32_t Height;
+		const GFXfont * Font;		///< NULL for the current font
+		int32_t Value;				///< the value, or the selected item of a list
+		int32_t Minimum;
+		int32_t Maximum;
+		uint8_t Decimals;			///< value widgets only
+		uint8_t Digits;				///< value widgets only, the field width
+		uint8_t Format;				///< value widgets: GraphicsNumberFlagType, labels: GraphicsTextPostEnumType
+		uint32_t First;				///< lists only, the first item shown
+		const void * Data;			///< label text, series, icon bitmap, list items or WidgetStripChartType
+		uint32_t Count;				///< series values, list items or icon width
+		uint32_t DataHeight;		///< icon height
+	} WidgetType;
+
+	/**
+	 * defines one strip chart column, the range of the samples that went into it
+	 */
+	typedef struct WidgetStripColumnType {
+		int32_t Minimum;
+		int32_t Maximum;
+	} WidgetStripColumnType;
+
+	/**
+	 * defines the state of a strip chart. The application provides the memory, see SetStripChart
+	 */
+	typedef struct WidgetStripChartType {
+		WidgetStripColumnType * Columns;	///< ring of the newest columns
+		uint32_t Size;						///< columns in the ring, at least the plot width + 1 to scroll
+		uint32_t Newest;					///< ring index of the newest column
+		uint32_t Filled;					///< columns that hold samples
+		uint32_t Scroll;					///< columns added since the plot was last drawn
+		uint16_t Decimation;				///< samples per column
+		uint16_t Samples;					///< samples in the column being built
+		int32_t Low;						///< range of the column being built
+		int32_t High;
+	} WidgetStripChartType;
+
+	/**
+	 * defines the widget interface
+	 */
+	typedef struct WidgetInterfaceType {
+		/** takes a widget from the pool. It is visible and will be drawn on the next Step **/
+		WidgetType * (*Create)(uint8_t kind, int32_t x, int32_t y, int32_t width, int32_t height);
+		/** gives the widget back to the pool and erases it on the next Step **/
+		void (*Destroy)(WidgetType * widget);
+		/** destroys every widget **/
+		void (*DestroyAll)(void);
+		void (*SetBounds)(WidgetType * widget, int32_t x, int32_t y, int32_t width, int32_t height);
+		void (*SetVisible)(WidgetType * widget, uint_fast8_t visible);
+		void (*SetFont)(WidgetType * widget, const GFXfont * font);
+		/** label text. The text isn't copied, call Invalidate after changing it in place **/
+		void (*SetText)(WidgetType * widget, const uint8_t * text, uint_fast8_t justification);
+		/** value, progress bar and gauge value or list selection. Nothing is redrawn if it didn't change **/
+		void (*SetValue)(WidgetType * widget, int32_t value);
+		void (*SetRange)(WidgetType * widget, int32_t minimum, int32_t maximum);
+		void (*SetFormat)(WidgetType * widget, uint_fast8_t digits, uint_fast8_t decimals, uint_fast8_t flags);
+		/** bar graph values. They aren't copied, call Invalidate after changing them **/
+		void (*SetSeries)(WidgetType * widget, const int32_t * values, uint32_t count);
+		void (*SetIcon)(WidgetType * widget, const uint32_t * bitmap, uint32_t width, uint32_t height);
+		void (*SetItems)(WidgetType * widget, const uint8_t * const * items, uint32_t count);
+		/** gives a strip chart its column ring and how many samples make a column. Samples are scaled with SetRange **/
+		void (*SetStripChart)(WidgetType * widget, WidgetStripChartType * chart, WidgetStripColumnType * columns, uint32_t size, uint32_t decimation);
+		/** adds a sample to a strip chart. Step moves the plot along and only draws the new columns **/
+		void (*AddSample)(WidgetType * widget, int32_t value);
+		void (*Invalidate)(WidgetType * widget);
+		/** adds an area the application drew itself to the next Step's flush **/
+		void (*AddDamage)(int32_t x, int32_t y, int32_t width, int32_t height);
+		/** redraws the invalidated widgets and sends only their rectangles and the added damage. Returns how many were redrawn **/
+		uint32_t (*Step)(void);
+	} WidgetInterfaceType;
+
+	extern WidgetInterfaceType Widgets;
+
+#endif /* __WIDGET_H__ */
@@ -0,0 +1,109 @@
+/*
+ * workerPool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * The workers sleep on Wake until Generation moves on, do their part and count themselves out of
+ * Running. The last one out signals Done.
+ */
+#include <errno.h>
+#include "workerPool.h"
+
+/**
+ * waits for a job and does this worker's part of it
+ */
+static void * WorkerThread(void * argument) {
+	WorkerPoolWorkerType * Worker = argument;
+	WorkerPoolType * Pool = Worker->Pool;
+	uint32_t Seen = 0;
+
+	pthread_mutex_lock(&Pool->Lock);
+
+	for(;;) {
+		while(Pool->Generation == Seen && !Pool->Stopping) {
+			pthread_cond_wait(&Pool->Wake, &Pool->Lock);
+		}
+
+		if(Pool->Stopping) {
+			break;
+		}
+
+		Seen = Pool->Generation;
+		pthread_mutex_unlock(&Pool->Lock);
+
+		Pool->Work(Worker->Number);
+
+		pthread_mutex_lock(&Pool->Lock);
+		if(!--Pool->Running) {
+			pthread_cond_signal(&Pool->Done);
+		}
+	}
+
+	pthread_mutex_unlock(&Pool->Lock);
+
+	return NULL;
+}
+
+int32_t WorkerPoolStart(WorkerPoolType * pool, uint32_t workers) {
+	WorkerPoolWorkerType * Worker;
+	int Result;
+
+	if(!pool || !pool->Work || workers > WORKER_POOL_MAX_WORKERS) {
+		return -EINVAL;
+	}
+
+	pool->Generation = 0;
+	pool->Count = 0;
+
+	while(pool->Count < workers) {
+		Worker = &pool->Workers[pool->Count];
+		Worker->Pool = pool;
+		Worker->Number = pool->Count + 1;
+
+		Result = pthread_create(&Worker->Thread, NULL, WorkerThread, Worker);
+		if(Result) {
+			return -Result;
+		}
+
+		pool->Count++;
+	}
+
+	return 0;
+}
+
+void WorkerPoolStop(WorkerPoolType * pool) {
+	uint32_t Index;
+
+	if(!pool) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->Lock);
+	pool->Stopping = 1;
+	pthread_cond_broadcast(&pool->Wake);
+	pthread_mutex_unlock(&pool->Lock);
+
+	for(Index = 0; Index < pool->Count; Index++) {
+		pthread_join(pool->Workers[Index].Thread, NULL);
+	}
+
+	pool->Stopping = 0;
+	pool->Count = 0;
+}
+
+void WorkerPoolWake(WorkerPoolType * pool) {
+	pthread_mutex_lock(&pool->Lock);
+	pool->Generation++;
+	pool->Running = pool->Count;
+	pthread_cond_broadcast(&pool->Wake);
+	pthread_mutex_unlock(&pool->Lock);
+}
+
+void WorkerPoolWait(WorkerPoolType * pool) {
+	pthread_mutex_lock(&pool->Lock);
+	while(pool->Running) {
+		pthread_cond_wait(&pool->Done, &pool->Lock);
+	}
+	pthread_mutex_unlock(&pool->Lock);
+}
@@ -0,0 +1,80 @@
+/*
+ * workerPool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Ronald Sousa https://hashdefineelectronics.com
+ *
+ * A set of threads that wait to be woken, each do their part of a job and then wait again, so a
+ * job doesn't pay for creating threads. The thread that wakes them does its own part, numbered 0,
+ * and then waits for the workers to finish.
+ */
+
+#ifndef __WORKER_POOL_H__
+#define __WORKER_POOL_H__
+
+	#include <pthread.h>
+	#include <stdint.h>
+
+	/**
+	 * the most workers a pool can have, not counting the thread that wakes them
+	 */
+	#ifndef WORKER_POOL_MAX_WORKERS
+		#define WORKER_POOL_MAX_WORKERS 15
+	#endif
+
+	struct WorkerPoolType;
+
+	/**
+	 * defines a worker thread
+	 */
+	typedef struct {
+		pthread_t Thread;
+		struct WorkerPoolType * Pool;
+		uint32_t Number;				///< 1 for the first worker
+	} WorkerPoolWorkerType;
+
+	/**
+	 * defines a pool. Set it up with WORKER_POOL_INIT
+	 */
+	typedef struct WorkerPoolType {
+		/** does a worker's part of the job **/
+		void (*Work)(uint32_t worker);
+		WorkerPoolWorkerType Workers[WORKER_POOL_MAX_WORKERS];
+		uint32_t Count;					///< workers started
+		pthread_mutex_t Lock;
+		pthread_cond_t Wake;
+		pthread_cond_t Done;
+		uint32_t Generation;			///< counts the jobs, a worker runs when it changes
+		uint32_t Running;				///< workers still working on the current job
+		uint_fast8_t Stopping;
+	} WorkerPoolType;
+
+	/**
+	 * initialises a pool whose workers call work
+	 */
+	#define WORKER_POOL_INIT(work) {Work: (work), Count: 0, Lock: PTHREAD_MUTEX_INITIALIZER, Wake: PTHREAD_COND_INITIALIZER, Done: PTHREAD_COND_INITIALIZER}
+
+	/**
+	 * Starts workers numbered 1 to workers. The pool must be stopped. If a thread can't be
+	 * started, the ones before it keep running and Count says how many there are.
+	 *
+	 * @return 0 or a negative errno
+	 */
+	int32_t WorkerPoolStart(WorkerPoolType * pool, uint32_t workers);
+
+	/**
+	 * stops and joins the workers. Does nothing if none are running
+	 */
+	void WorkerPoolStop(WorkerPoolType * pool);
+
+	/**
+	 * starts a job on every worker. Call WorkerPoolWait before the next one
+	 */
+	void WorkerPoolWake(WorkerPoolType * pool);
+
+	/**
+	 * waits for every worker to finish the job
+	 */
+	void WorkerPoolWait(WorkerPoolType * pool);
+
+#endif /* __WORKER_POOL_H__ */